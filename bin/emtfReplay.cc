@@ -0,0 +1,168 @@
+// Replay the EMTF track-finding core on dumped sector tensors.
+//
+// This driver only depends on EMTFModel and the emtf_hlslib headers, so it can be built
+// without a CMSSW release (see standalone/Makefile).
+//
+// The input file is a sector tensor file (see interface/SectorTensorFile.h), e.g. written by
+// the producer with tensorFileName set. It is memory-mapped and the in0 tensors are fitted in
+// place. The output file has the same format, with the out tensors from this fit.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFModel.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SectorTensorFile.h"
+
+using namespace emtf::phase2;
+
+namespace {
+
+  void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] <in0_file> [<out_file>]" << std::endl
+              << "Options:" << std::endl
+              << "  -v <version>  model version, must match the file (default: from the file)" << std::endl
+              << "  -u            use the unconstrained fit" << std::endl
+              << "  -r <repeat>   num of times each sector is fitted (default: 1)" << std::endl
+              << "  -n <max>      max num of events to process (default: all)" << std::endl;
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long version_arg = -1;
+  bool unconstrained = false;
+  long repeat = 1;
+  long max_events = -1;
+  std::string in0_fname;
+  std::string out_fname;
+
+  // Parse the command line
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const bool has_value = ((i + 1) < argc);
+
+    if ((std::strcmp(arg, "-v") == 0) and has_value) {
+      version_arg = std::strtol(argv[++i], nullptr, 10);
+    } else if (std::strcmp(arg, "-u") == 0) {
+      unconstrained = true;
+    } else if ((std::strcmp(arg, "-r") == 0) and has_value) {
+      repeat = std::strtol(argv[++i], nullptr, 10);
+    } else if ((std::strcmp(arg, "-n") == 0) and has_value) {
+      max_events = std::strtol(argv[++i], nullptr, 10);
+    } else if (arg[0] == '-') {
+      print_usage(argv[0]);
+      return 1;
+    } else if (in0_fname.empty()) {
+      in0_fname = arg;
+    } else if (out_fname.empty()) {
+      out_fname = arg;
+    } else {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (in0_fname.empty() or (repeat < 1)) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  // Map the input file
+  const SectorTensorReader reader(in0_fname);
+  if (not reader.is_valid()) {
+    std::cerr << "Failed to read " << in0_fname << std::endl;
+    return 1;
+  }
+
+  // The tensors are only meaningful for the model that produced them
+  const unsigned version = reader.header().model_version;
+  if ((version_arg >= 0) and (static_cast<unsigned long>(version_arg) != version)) {
+    std::cerr << "Model version " << version_arg << " does not match the version in " << in0_fname << " ("
+              << version << ")" << std::endl;
+    return 1;
+  }
+
+  const EMTFModel model(version, unconstrained);
+  const NdArrayDesc& input_shape = model.get_input_shape();
+  const NdArrayDesc& output_shape = model.get_output_shape();
+
+  if (not(input_shape.is_valid() and output_shape.is_valid())) {
+    std::cerr << "Unsupported model version: " << version << std::endl;
+    return 1;
+  }
+
+  const size_t in0_size = input_shape.num_elements();
+  const size_t out_size = output_shape.num_elements();
+
+  if (reader.header().in0_size != in0_size) {
+    std::cerr << "Size of the in0 tensor in " << in0_fname << " (" << reader.header().in0_size
+              << ") does not match the model (" << in0_size << ")" << std::endl;
+    return 1;
+  }
+
+  size_t num_events = reader.num_events();
+  if ((max_events >= 0) and (static_cast<size_t>(max_events) < num_events)) {
+    num_events = max_events;
+  }
+
+  std::unique_ptr<SectorTensorWriter> writer;
+  if (not out_fname.empty()) {
+    writer = std::make_unique<SectorTensorWriter>(out_fname, model.version(), in0_size, out_size);
+    if (not writer->is_open()) {
+      std::cerr << "Failed to open " << out_fname << std::endl;
+      return 1;
+    }
+  }
+
+  // Model output, reused for every sector
+  std::vector<int> out(out_size, 0);
+  SectorTensorBuffer out_tensors;
+
+  size_t num_sectors = 0;
+  double elapsed = 0.;
+
+  // Loop over events
+  for (size_t ievt = 0; ievt < num_events; ++ievt) {
+    const SectorTensorIndexEntry& entry = reader.get_event(ievt);
+    out_tensors.clear();
+
+    // Loop over sectors
+    for (size_t irec = entry.first_record; irec < (entry.first_record + entry.num_records); ++irec) {
+      const SectorTensorReader::Record& rec = reader.get_record(irec);
+
+      const auto t_start = std::chrono::steady_clock::now();
+      for (long irepeat = 0; irepeat < repeat; ++irepeat) {
+        model.fit(rec.in0, out.data());
+      }
+      const auto t_stop = std::chrono::steady_clock::now();
+      elapsed += std::chrono::duration<double>(t_stop - t_start).count();
+      ++num_sectors;
+
+      if (writer != nullptr) {
+        out_tensors.add(rec.header->endcap, rec.header->sector, rec.header->bx, rec.in0, in0_size, out.data(), out_size);
+      }
+    }  // end loop over sectors
+
+    if ((writer != nullptr) and not writer->write_event(entry.run, entry.lumi, entry.event, out_tensors)) {
+      std::cerr << "Failed to write " << out_fname << std::endl;
+      return 1;
+    }
+  }  // end loop over events
+
+  const double num_fits = static_cast<double>(num_sectors) * repeat;
+
+  std::cerr << "Processed " << num_events << " events, " << num_sectors << " sectors x " << repeat << " in "
+            << elapsed << " s (" << ((elapsed > 0.) ? (num_fits / elapsed) : 0.) << " sectors/s)" << std::endl;
+
+  if ((writer != nullptr) and not writer->close()) {
+    std::cerr << "Failed to write " << out_fname << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,97 @@
+#ifndef L1Trigger_Phase2L1EMTF_ChamberIndex_h
+#define L1Trigger_Phase2L1EMTF_ChamberIndex_h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemTags.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemCollection.h"
+
+namespace emtf {
+
+  namespace phase2 {
+
+    // Non-owning view of a contiguous range of elements
+    template <typename T>
+    class ConstSpan {
+    public:
+      typedef T value_type;
+      typedef const T* const_iterator;
+
+      ConstSpan() : begin_(nullptr), end_(nullptr) {}
+      ConstSpan(const T* begin, const T* end) : begin_(begin), end_(end) {}
+
+      const_iterator begin() const { return begin_; }
+      const_iterator end() const { return end_; }
+
+      std::size_t size() const { return end_ - begin_; }
+      bool empty() const { return begin_ == end_; }
+
+      const T& operator[](std::size_t i) const { return begin_[i]; }
+
+    private:
+      const T* begin_;
+      const T* end_;
+    };
+
+    // Chamber-level information that is needed to format the segments, built once per event from
+    // all the primitives and shared by all the sectors.
+    // - For CSC, the list of wire ambiguity. Key: (detid, bx), value: (wire,).
+    // - For GEM, the list of coincidence pads. Key: (detid without layer and roll, bx),
+    //   value: (roll, pad_lo, pad_hi).
+    // The values are stored in flat vectors sorted by key. Within a key, the values are kept in
+    // the order of the primitives in the collection.
+    class ChamberIndex {
+    public:
+      typedef uint16_t wire_t;
+      typedef std::array<uint16_t, 3> copad_t;
+
+      ChamberIndex();
+      ~ChamberIndex();
+
+      void build(const SubsystemCollection& muon_primitives);
+
+      // Returns an empty span if the key is not found
+      ConstSpan<wire_t> get_wire_ambi(const csc_subsystem_tag::detid_type& detid,
+                                      const csc_subsystem_tag::digi_type& digi) const;
+
+      // Returns an empty span if the key is not found
+      ConstSpan<copad_t> get_copad_vec(const gem_subsystem_tag::detid_type& detid,
+                                       const gem_subsystem_tag::digi_type& digi) const;
+
+    private:
+      typedef uint64_t key_t;
+
+      // Range of values of one key
+      struct Range {
+        key_t key;
+        uint32_t begin;
+        uint32_t end;
+      };
+
+      static key_t make_key(uint32_t rawId, int bx);
+
+      static const Range* find_range(const std::vector<Range>& ranges, key_t key);
+
+      void build_csc(const SubsystemCollection& muon_primitives);
+
+      void build_gem(const SubsystemCollection& muon_primitives);
+
+      std::vector<Range> csc_ranges_;
+      std::vector<wire_t> csc_wires_;
+      std::vector<Range> gem_ranges_;
+      std::vector<copad_t> gem_copads_;
+
+      // (key, primitive index), sorted to group the primitives by key
+      std::vector<std::pair<key_t, uint32_t> > sort_buffer_;
+    };
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_ChamberIndex_h not defined
@@ -5,6 +5,7 @@
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Utilities/interface/Transition.h"
 
 #include "CondFormats/L1TObjects/interface/L1TMuonEndCapParams.h"
 #include "CondFormats/L1TObjects/interface/L1TMuonEndCapForest.h"
@@ -19,6 +20,9 @@ namespace emtf {
     public:
       explicit ConditionHelper(edm::ConsumesCollector&& iConsumes);
       explicit ConditionHelper(edm::ConsumesCollector& iConsumes);
+      explicit ConditionHelper(edm::ConsumesCollector& iConsumes, edm::Transition iTransition);
+      // Copy the ESGetTokens only. The products are retrieved again by check().
+      ConditionHelper(const ConditionHelper& other);
       ~ConditionHelper();
 
       bool check(const edm::EventSetup& iSetup);
@@ -27,6 +31,14 @@ namespace emtf {
       constexpr const L1TMuonEndCapForest& getForest() const { return *forest_; }
 
     private:
+      template <typename T, typename R>
+      static edm::ESGetToken<T, R> es_consumes(edm::ConsumesCollector& iConsumes, edm::Transition iTransition) {
+        if (iTransition == edm::Transition::BeginRun) {
+          return iConsumes.esConsumes<T, R, edm::Transition::BeginRun>();
+        }
+        return iConsumes.esConsumes<T, R>();
+      }
+
       // ESWatcher functions
       void watch_params(const L1TMuonEndCapParamsRcd& record) { params_ = &(record.get(paramsToken_)); }
       void watch_forest(const L1TMuonEndCapForestRcd& record) { forest_ = &(record.get(forestToken_)); }
@@ -0,0 +1,122 @@
+#ifndef L1Trigger_Phase2L1EMTF_CoordinateLUT_h
+#define L1Trigger_Phase2L1EMTF_CoordinateLUT_h
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemTags.h"
+
+class RPCRoll;
+
+namespace emtf {
+
+  namespace phase2 {
+
+    class GeometryHelper;
+
+    // Precomputed global coordinates of the trigger primitives, built from the muon geometry.
+    // The tables reproduce SegmentFormatter::get_global_point() exactly, but without going through
+    // the geometry for every primitive. They must be rebuilt when the MuonGeometryRecord changes.
+    class CoordinateLUT {
+    public:
+      explicit CoordinateLUT(const GeometryHelper& geom_helper);
+      ~CoordinateLUT();
+
+      // Overloaded for CSC/RPC/GEM/ME0. Returns false if the primitive is not covered by the table.
+      bool get_global_point(const csc_subsystem_tag::detid_type& detid,
+                            const csc_subsystem_tag::digi_type& digi,
+                            GlobalPoint& gp) const;
+
+      bool get_global_point(const rpc_subsystem_tag::detid_type& detid,
+                            const rpc_subsystem_tag::digi_type& digi,
+                            GlobalPoint& gp) const;
+
+      bool get_global_point(const gem_subsystem_tag::detid_type& detid,
+                            const gem_subsystem_tag::digi_type& digi,
+                            GlobalPoint& gp) const;
+
+      bool get_global_point(const me0_subsystem_tag::detid_type& detid,
+                            const me0_subsystem_tag::digi_type& digi,
+                            GlobalPoint& gp) const;
+
+    private:
+      struct PolarPoint {
+        float theta;
+        float phi;
+        float mag;
+      };
+
+      struct CartesianPoint {
+        float x;
+        float y;
+        float z;
+      };
+
+      // CSC chamber (ME1/1a is ring 4). The points are the intersections of a strip and a
+      // wiregroup at the ALCT key layer, before the half-strip correction.
+      struct CSCChamberEntry {
+        unsigned offset = 0;     // index of the first point
+        int num_fullstrips = 0;  // num of points along strip
+        int num_wires = 0;       // num of points along wire
+        bool ccw = false;        // handedness of the chamber
+        float hs_offset = 0.;    // phi offset of the half-strip wrt the strip center
+        bool valid = false;
+      };
+
+      // RPC roll. The points are the centers of the clusters, indexed by (strip_lo + strip_hi).
+      // For iRPC, theta is taken from the rechit local position, so the roll is kept.
+      struct RPCRollEntry {
+        unsigned offset = 0;
+        int num_points = 0;
+        const RPCRoll* roll = nullptr;
+        bool is_irpc = false;
+      };
+
+      // GEM eta partition. The points are the centers of the pad clusters, indexed by (pad_lo + pad_hi).
+      struct GEMRollEntry {
+        unsigned offset = 0;
+        int num_points = 0;
+      };
+
+      // ME0 chamber. The points are indexed by (roll, phiposition) at the ALCT key layer. The rows
+      // of the rolls missing from the geometry are left empty, and the rolls can have different
+      // num of strips, so the valid phipositions are kept per roll.
+      struct ME0ChamberEntry {
+        unsigned offset = 0;
+        int num_rolls = 0;                       // highest roll number
+        int num_phipositions = 0;                // row stride
+        std::vector<int> roll_num_phipositions;  // valid phipositions of each roll, 0 if missing
+      };
+
+      void build_csc(const CSCGeometry& detgeom);
+
+      void build_rpc(const RPCGeometry& detgeom);
+
+      void build_gem(const GEMGeometry& detgeom);
+
+      void build_me0(const ME0Geometry& detgeom);
+
+      static unsigned get_csc_chamber_index(int endcap, int station, int ring, int chamber);
+
+      std::vector<CSCChamberEntry> csc_chambers_;
+      std::vector<PolarPoint> csc_points_;
+
+      std::unordered_map<uint32_t, RPCRollEntry> rpc_rolls_;  // key: raw detid of the roll
+      std::vector<PolarPoint> rpc_points_;
+
+      std::unordered_map<uint32_t, GEMRollEntry> gem_rolls_;  // key: raw detid of the eta partition
+      std::vector<CartesianPoint> gem_points_;
+
+      std::unordered_map<uint32_t, ME0ChamberEntry> me0_chambers_;  // key: raw detid of the chamber
+      std::vector<CartesianPoint> me0_points_;
+    };
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_CoordinateLUT_h not defined
@@ -1,6 +1,8 @@
 #ifndef L1Trigger_Phase2L1EMTF_EMTFContext_h
 #define L1Trigger_Phase2L1EMTF_EMTFContext_h
 
+#include <mutex>
+
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 
 #include "L1Trigger/Phase2L1EMTF/interface/Common.h"
@@ -10,7 +12,12 @@ namespace emtf {
   namespace phase2 {
 
     class EMTFWorker;
+    class EMTFModel;
     class VersionControl;
+    class GeometryHelper;
+    class CoordinateLUT;
+    class SectorTensorWriter;
+    class EMTFProfiler;
 
     class EMTFContext {
     public:
@@ -19,11 +26,26 @@ namespace emtf {
       explicit EMTFContext(const edm::ParameterSet& iConfig);
       ~EMTFContext();
 
+      // Get the coordinate LUT for the muon geometry held by geom_helper. The LUT is shared by
+      // all the workers, and is only rebuilt when the MuonGeometryRecord changes.
+      std::shared_ptr<const CoordinateLUT> get_coordinate_lut(const GeometryHelper& geom_helper) const;
+
+      // Get the profiler, or null if instrumentation is not enabled
+      EMTFProfiler* get_profiler() const { return profiler_.get(); }
+
     private:
       const edm::ParameterSet& pset_;
 
       // Helper objects
       std::unique_ptr<VersionControl> version_control_;
+      std::unique_ptr<EMTFModel> model_;  // shared by all the workers
+      std::unique_ptr<SectorTensorWriter> tensor_writer_;  // only if tensorFileName is set
+      std::unique_ptr<EMTFProfiler> profiler_;             // only if instrumentation is set
+
+      // IOV-dependent caches
+      mutable std::mutex coord_lut_mutex_;
+      mutable std::shared_ptr<const CoordinateLUT> coord_lut_;
+      mutable unsigned long long coord_lut_cache_id_;
     };
 
   }  // namespace phase2
@@ -13,6 +13,11 @@ namespace emtf {
     public:
       typedef std::vector<int> Vector;  // 1-D vector containing tensor data
 
+      // Upper bounds over all the model versions, used to size fixed buffers
+      static constexpr int max_num_chambers = 115;        // per sector
+      static constexpr int max_input_size = 115 * 2 * 13;  // num of values in the model input
+      static constexpr int max_output_size = 4 * 54;      // num of values in the model output
+
       explicit EMTFModel(unsigned version = 3, bool unconstrained = false);
       ~EMTFModel();
 
@@ -30,6 +35,9 @@ namespace emtf {
       // Get model output shape
       NdArrayDesc get_output_shape() const;
 
+      // Get num of chambers
+      int get_num_chambers() const;
+
       // Get max num of segments
       int get_num_segments() const;
 
@@ -43,13 +51,19 @@ namespace emtf {
         assert(in0.size() == input_shape.num_elements());
         assert(out.size() == output_shape.num_elements());
 
+        fit(in0.data(), out.data());
+      }
+
+      // Fit using raw pointers, e.g. into a memory-mapped file. in0 and out must hold at least
+      // get_input_shape().num_elements() and get_output_shape().num_elements() values.
+      void fit(const int* in0, int* out) const {
         if (version_ == 3) {
           fit_impl_v3(in0, out);
         }
       }
 
     private:
-      void fit_impl_v3(const Vector& in0, Vector& out) const;
+      void fit_impl_v3(const int* in0, int* out) const;
 
       static constexpr int num_emtf_chambers_v3 = 115;      // per sector
       static constexpr int num_emtf_segments_v3 = 2;        // per chamber
@@ -0,0 +1,141 @@
+#ifndef L1Trigger_Phase2L1EMTF_EMTFPackedHit_h
+#define L1Trigger_Phase2L1EMTF_EMTFPackedHit_h
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+
+namespace emtf {
+
+  namespace phase2 {
+
+    // Compact record of a converted segment, close to the firmware word layout. It is stored as
+    // two 64-bit words: the segment word holds the variables used by the pattern recognition and
+    // the NN, and the location word holds enough of the detector info to rebuild a debugging hit.
+    // The hits in a packed collection are in the same order as in the EMTFHitCollection. The tracks
+    // do not store collection indices: their segment refs are the model segment ids of the sector,
+    // i.e. (emtf_chamber * num_emtf_segments) + emtf_segment, to be matched with emtfChamber() and
+    // emtfSegment() of the packed hits with the same endcap and sector.
+    //
+    // Segment word:
+    //   [ 0, 13) emtf_phi      [13, 20) emtf_bend (signed)   [20, 28) emtf_theta1   [28, 36) emtf_theta2
+    //   [36, 40) emtf_qual1    [40, 44) emtf_qual2           [44, 48) emtf_time (signed)
+    //   [48, 51) zones         [51, 54) timezones            [54] valid   [55] neighbor   [56] cscfr
+    //   [57, 60) gemdl
+    // Location word:
+    //   [ 0,  7) emtf_chamber  [ 7, 11) emtf_segment         [11, 15) emtf_site     [15, 20) emtf_host
+    //   [20] endcap is +1      [21, 24) sector               [24, 28) bx (signed)   [28, 31) subsystem
+    //   [31, 34) station       [34, 37) ring                 [37, 43) chamber       [43, 45) subsector
+    //   [45, 49) cscid
+    //
+    // The values that do not fit in their field are saturated. This never happens for the
+    // segments that are sent to the firmware.
+    class EMTFPackedHit {
+    public:
+      typedef uint64_t word_t;
+
+      EMTFPackedHit() : words_{} {}
+
+      // Pack a full hit
+      explicit EMTFPackedHit(const EMTFHit& hit);
+
+      // Unpack into a full hit. The variables that are not stored (e.g. strip, wire, global
+      // coordinates) are left at their default values.
+      EMTFHit to_hit() const;
+
+      // Segment word
+      int emtfPhi() const { return get(kEmtfPhi); }
+      int emtfBend() const { return get(kEmtfBend); }
+      int emtfTheta1() const { return get(kEmtfTheta1); }
+      int emtfTheta2() const { return get(kEmtfTheta2); }
+      int emtfQual1() const { return get(kEmtfQual1); }
+      int emtfQual2() const { return get(kEmtfQual2); }
+      int emtfTime() const { return get(kEmtfTime); }
+      int zones() const { return get(kZones); }
+      int timezones() const { return get(kTimezones); }
+      bool valid() const { return get(kValid); }
+      bool neighbor() const { return get(kNeighbor); }
+      int cscfr() const { return get(kCscfr); }
+      int gemdl() const { return get(kGemdl); }
+
+      // Location word
+      int emtfChamber() const { return get(kEmtfChamber); }
+      int emtfSegment() const { return get(kEmtfSegment); }
+      int emtfSite() const { return get(kEmtfSite); }
+      int emtfHost() const { return get(kEmtfHost); }
+      int endcap() const { return get(kEndcap) ? 1 : -1; }
+      int sector() const { return get(kSector); }
+      int bx() const { return get(kBx); }
+      int subsystem() const { return get(kSubsystem); }
+      int station() const { return get(kStation); }
+      int ring() const { return get(kRing); }
+      int chamber() const { return get(kChamber); }
+      int subsector() const { return get(kSubsector); }
+      int cscid() const { return get(kCscid); }
+
+      // Raw words
+      word_t segment_word() const { return words_[0]; }
+      word_t location_word() const { return words_[1]; }
+
+    private:
+      struct Field {
+        unsigned word;
+        unsigned shift;
+        unsigned width;
+        bool is_signed;
+      };
+
+      // Segment word
+      static constexpr Field kEmtfPhi{0, 0, 13, false};
+      static constexpr Field kEmtfBend{0, 13, 7, true};
+      static constexpr Field kEmtfTheta1{0, 20, 8, false};
+      static constexpr Field kEmtfTheta2{0, 28, 8, false};
+      static constexpr Field kEmtfQual1{0, 36, 4, false};
+      static constexpr Field kEmtfQual2{0, 40, 4, false};
+      static constexpr Field kEmtfTime{0, 44, 4, true};
+      static constexpr Field kZones{0, 48, 3, false};
+      static constexpr Field kTimezones{0, 51, 3, false};
+      static constexpr Field kValid{0, 54, 1, false};
+      static constexpr Field kNeighbor{0, 55, 1, false};
+      static constexpr Field kCscfr{0, 56, 1, false};
+      static constexpr Field kGemdl{0, 57, 3, false};
+
+      // Location word
+      static constexpr Field kEmtfChamber{1, 0, 7, false};
+      static constexpr Field kEmtfSegment{1, 7, 4, false};
+      static constexpr Field kEmtfSite{1, 11, 4, false};
+      static constexpr Field kEmtfHost{1, 15, 5, false};
+      static constexpr Field kEndcap{1, 20, 1, false};
+      static constexpr Field kSector{1, 21, 3, false};
+      static constexpr Field kBx{1, 24, 4, true};
+      static constexpr Field kSubsystem{1, 28, 3, false};
+      static constexpr Field kStation{1, 31, 3, false};
+      static constexpr Field kRing{1, 34, 3, false};
+      static constexpr Field kChamber{1, 37, 6, false};
+      static constexpr Field kSubsector{1, 43, 2, false};
+      static constexpr Field kCscid{1, 45, 4, false};
+
+      int get(const Field& f) const {
+        const word_t mask = (word_t(1) << f.width) - 1;
+        const int value = static_cast<int>((words_[f.word] >> f.shift) & mask);
+        // Sign extension
+        return (f.is_signed and (value >> (f.width - 1))) ? (value - (1 << f.width)) : value;
+      }
+
+      void set(const Field& f, int value);
+
+      std::array<word_t, 2> words_;
+    };
+
+    typedef std::vector<EMTFPackedHit> EMTFPackedHitCollection;
+
+    // Pack all the hits, keeping the same order
+    void pack_hits(const EMTFHitCollection& hits, EMTFPackedHitCollection& packed_hits);
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_EMTFPackedHit_h not defined
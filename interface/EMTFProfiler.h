@@ -0,0 +1,97 @@
+#ifndef L1Trigger_Phase2L1EMTF_EMTFProfiler_h
+#define L1Trigger_Phase2L1EMTF_EMTFProfiler_h
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace emtf {
+
+  namespace phase2 {
+
+    // Opt-in timers and counters. Each stream accumulates into its own Stats object without any
+    // synchronization, and merges it into the EMTFProfiler held by EMTFContext at the end of the
+    // stream. The merge only uses atomic additions.
+    class EMTFProfiler {
+    public:
+      enum Timer { kCollection = 0, kRouting, kStep1, kStep2, kNumTimers };
+
+      enum Counter {
+        kEvents = 0,
+        kCSCPrimitives,
+        kRPCPrimitives,
+        kGEMPrimitives,
+        kME0Primitives,
+        kSectors,          // num of (endcap, sector, bx) processed
+        kHits,             // num of hits over all the sectors
+        kDroppedSegments,  // num of segments beyond num_segments in a chamber
+        kFits,             // num of sectors with at least one hit
+        kTracks,           // num of tracks produced
+        kNumCounters
+      };
+
+      struct Stats {
+        std::array<uint64_t, kNumTimers> time_ns{};
+        std::array<uint64_t, kNumTimers> calls{};
+        std::array<uint64_t, kNumCounters> counts{};
+        uint64_t max_hits_per_sector = 0;
+
+        void add(const Stats& other);
+
+        void count(Counter c, uint64_t n = 1) { counts[c] += n; }
+
+        void count_hits(uint64_t n) {
+          counts[kHits] += n;
+          max_hits_per_sector = (n > max_hits_per_sector) ? n : max_hits_per_sector;
+        }
+      };
+
+      // Adds the elapsed time to stats on destruction. Does nothing if stats is null.
+      class ScopedTimer {
+      public:
+        explicit ScopedTimer(Stats* stats, Timer timer)
+            : stats_(stats), timer_(timer), start_((stats != nullptr) ? clock_type::now() : clock_type::time_point{}) {}
+
+        ~ScopedTimer() {
+          if (stats_ != nullptr) {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - start_);
+            stats_->time_ns[timer_] += elapsed.count();
+            stats_->calls[timer_] += 1;
+          }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+      private:
+        typedef std::chrono::steady_clock clock_type;
+
+        Stats* const stats_;
+        const Timer timer_;
+        const clock_type::time_point start_;
+      };
+
+      EMTFProfiler();
+      ~EMTFProfiler();
+
+      // Thread-safe, lock-free
+      void merge(const Stats& stats);
+
+      Stats get_summary() const;
+
+      void print_summary(std::ostream& os) const;
+
+    private:
+      std::array<std::atomic<uint64_t>, kNumTimers> time_ns_;
+      std::array<std::atomic<uint64_t>, kNumTimers> calls_;
+      std::array<std::atomic<uint64_t>, kNumCounters> counts_;
+      std::atomic<uint64_t> max_hits_per_sector_;
+    };
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_EMTFProfiler_h not defined
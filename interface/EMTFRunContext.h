@@ -0,0 +1,40 @@
+#ifndef L1Trigger_Phase2L1EMTF_EMTFRunContext_h
+#define L1Trigger_Phase2L1EMTF_EMTFRunContext_h
+
+#include "FWCore/Framework/interface/EventSetup.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+
+namespace emtf {
+
+  namespace phase2 {
+
+    class EMTFContext;
+    class EMTFWorker;
+    class GeometryHelper;
+    class ConditionHelper;
+
+    // EventSetup-dependent helper objects that are updated once per run. When the global
+    // module is used, a single instance is shared by all the streams.
+    class EMTFRunContext {
+    public:
+      friend class EMTFWorker;  // allow access to helper objects
+
+      explicit EMTFRunContext(const EMTFWorker& iWorker);
+      ~EMTFRunContext();
+
+      void before_run(const EMTFContext& iContext, const edm::EventSetup& iSetup);
+
+    private:
+      const bool useCoordinateLUT_;
+
+      // Helper objects
+      std::unique_ptr<GeometryHelper> geom_helper_;
+      std::unique_ptr<ConditionHelper> cond_helper_;
+    };
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_EMTFRunContext_h not defined
@@ -0,0 +1,69 @@
+#ifndef L1Trigger_Phase2L1EMTF_EMTFScratch_h
+#define L1Trigger_Phase2L1EMTF_EMTFScratch_h
+
+#include <array>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/interface/ChamberIndex.h"
+#include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFModel.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFProfiler.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SectorTensorFile.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SegmentFormatter.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemCollection.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemRouter.h"
+
+namespace emtf {
+
+  namespace phase2 {
+
+    // Work buffers that are reused from one event to the next. Each stream has its own instance,
+    // so no synchronization is needed. The buffers are cleared but never shrunk, so after the
+    // first few events they have enough capacity and no more heap allocation is done.
+    struct EMTFScratch {
+      // Buffers used by the sector processor of one (endcap, sector)
+      struct Sector {
+        EMTFHitCollection sector_hits;
+        EMTFTrackCollection sector_tracks;
+
+        // Segments accepted by the formatter, before the conversion to EMTF coordinates
+        EMTFHitCollection formatted_hits;
+        std::vector<int> formatted_strategies;          // strategy that accepted each segment
+        SegmentFormatter::CoordinateBatch coordinates;  // global coordinates of each segment
+
+        // Model input, filled directly by the segment conversion. It is all zeros between uses:
+        // only the rows that were filled are cleared after the fit.
+        alignas(64) std::array<int, EMTFModel::max_input_size> in0{};
+        alignas(64) std::array<int, EMTFModel::max_output_size> out{};  // model output
+        std::array<int, EMTFModel::max_num_chambers> segment_counts{};  // num of segments in each emtf_chamber
+        std::vector<int> trk_data;                                      // model output of one track
+
+        // Output of the sector when the sectors run in parallel
+        EMTFHitCollection out_hits;
+        EMTFTrackCollection out_tracks;
+        SectorTensorBuffer out_tensors;
+        EMTFProfiler::Stats stats;
+
+        // Clear the output
+        void reset();
+      };
+
+      explicit EMTFScratch(int min_bx, int max_bx);
+      ~EMTFScratch();
+
+      // Clear the event-level buffers
+      void reset();
+
+      SubsystemCollection muon_primitives;
+      SubsystemRouter router;
+      ChamberIndex chamber_index;
+      SectorTensorBuffer out_tensors;
+
+      std::array<Sector, NUM_TRIGSECTORS> sectors;  // indexed by (endcap, sector)
+    };
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_EMTFScratch_h not defined
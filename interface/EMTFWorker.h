@@ -5,37 +5,80 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Transition.h"
 
 #include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFProfiler.h"
 
 namespace emtf {
 
   namespace phase2 {
 
     class EMTFContext;
+    class EMTFRunContext;
+    struct EMTFScratch;
     class EMTFModel;
     class GeometryHelper;
     class ConditionHelper;
     class SectorProcessor;
+    class SectorTensorBuffer;
+    class SectorTensorWriter;
 
     class EMTFWorker {
     public:
       friend class SectorProcessor;  // allow access to helper objects
-
-      explicit EMTFWorker(const edm::ParameterSet& iConfig, edm::ConsumesCollector&& iConsumes);
+      friend class EMTFRunContext;   // allow access to helper objects
+
+      // The ESGetTokens are registered for the given transition. Use edm::Transition::BeginRun
+      // if the EventSetup data are accessed through an EMTFRunContext.
+      explicit EMTFWorker(const EMTFContext& iContext,
+                          const edm::ParameterSet& iConfig,
+                          edm::ConsumesCollector&& iConsumes,
+                          edm::Transition iTransition = edm::Transition::Event);
       ~EMTFWorker();
 
+      static void fill_description(edm::ParameterSetDescription& desc);
+
+      // Make the scratch buffers for one stream
+      std::unique_ptr<EMTFScratch> make_scratch() const;
+
+      // Used by the stream module, which owns one worker per stream
       void before_process(const EMTFContext& iContext, const edm::EventSetup& iSetup);
 
-      void process(const edm::Event& iEvent, EMTFHitCollection& out_hits, EMTFTrackCollection& out_tracks) const;
+      // If stats is not null, the timers and counters are accumulated into it
+      void process(const edm::Event& iEvent,
+                   EMTFHitCollection& out_hits,
+                   EMTFTrackCollection& out_tracks,
+                   EMTFProfiler::Stats* stats = nullptr) const;
+
+      // Used by the global module, which shares one worker and one EMTFRunContext among all the streams.
+      // Each stream passes its own scratch buffers.
+      void process(const edm::Event& iEvent,
+                   const EMTFRunContext& iRunContext,
+                   EMTFScratch& scratch,
+                   EMTFHitCollection& out_hits,
+                   EMTFTrackCollection& out_tracks,
+                   EMTFProfiler::Stats* stats = nullptr) const;
 
     private:
+      void process_impl(const edm::Event& iEvent,
+                        const GeometryHelper& geom_helper,
+                        EMTFScratch& scratch,
+                        EMTFHitCollection& out_hits,
+                        EMTFTrackCollection& out_tracks,
+                        EMTFProfiler::Stats* stats) const;
+
+      void write_tensors(const edm::EventID& evt_id, const SectorTensorBuffer* out_tensors) const;
+
       const edm::ParameterSet& pset_;
 
       // Helper objects
-      std::unique_ptr<EMTFModel> model_;
+      const EMTFModel* model_;                   // owned by EMTFContext
+      SectorTensorWriter* const tensor_writer_;  // owned by EMTFContext, can be null
       std::unique_ptr<GeometryHelper> geom_helper_;
       std::unique_ptr<ConditionHelper> cond_helper_;
+      std::unique_ptr<EMTFScratch> scratch_;  // only used by the stream module
 
       // Subsystem tokens
       const edm::EDGetToken cscToken_;
@@ -50,10 +93,20 @@ namespace emtf {
       const bool me0Enable_;
 
       // BX window
-      const int minBX_;
-      const int maxBX_;
+      const int minBX_;       // hits are converted and stored
+      const int maxBX_;       // hits are converted and stored
+      const int minTrackBX_;  // tracks are built
+      const int maxTrackBX_;  // tracks are built
+      const int minConvBX_;   // union of the two ranges above
+      const int maxConvBX_;   // union of the two ranges above
       const int bxWindow_;
 
+      // Sector dispatch. The parallel dispatch requires EMTFModel::fit() to be reentrant.
+      const bool parallelSectors_;
+
+      // Coordinate conversion using precomputed tables
+      const bool useCoordinateLUT_;
+
       // Verbosity level
       int verbose_;
     };
@@ -1,12 +1,15 @@
 #ifndef L1Trigger_Phase2L1EMTF_GeometryHelper_h
 #define L1Trigger_Phase2L1EMTF_GeometryHelper_h
 
+#include <memory>
 #include <type_traits>
+#include <utility>  // provides std::move
 
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Utilities/interface/Transition.h"
 
 #include "MagneticField/Engine/interface/MagneticField.h"
 #include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
@@ -21,10 +24,15 @@ namespace emtf {
 
   namespace phase2 {
 
+    class CoordinateLUT;
+
     class GeometryHelper {
     public:
       explicit GeometryHelper(edm::ConsumesCollector&& iConsumes);
       explicit GeometryHelper(edm::ConsumesCollector& iConsumes);
+      explicit GeometryHelper(edm::ConsumesCollector& iConsumes, edm::Transition iTransition);
+      // Copy the ESGetTokens only. The products are retrieved again by check().
+      GeometryHelper(const GeometryHelper& other);
       ~GeometryHelper();
 
       bool check(const edm::EventSetup& iSetup);
@@ -36,6 +44,14 @@ namespace emtf {
       constexpr const GEMGeometry& getGEMGeometry() const { return *gemGeom_; }
       constexpr const ME0Geometry& getME0Geometry() const { return *me0Geom_; }
 
+      // Cache identifier of the MuonGeometryRecord, changes with the IOV
+      unsigned long long getMuonGeometryCacheId() const { return muonGeomCacheId_; }
+
+      // Precomputed coordinates built from the current muon geometry (can be null)
+      const CoordinateLUT* getCoordinateLUT() const { return coordLUT_.get(); }
+
+      void setCoordinateLUT(std::shared_ptr<const CoordinateLUT> coordLUT) { coordLUT_ = std::move(coordLUT); }
+
       // Type-dependent get()
       template <typename T>
       using add_const_reference_t = typename std::add_lvalue_reference<typename std::add_const<T>::type>::type;
@@ -69,10 +85,21 @@ namespace emtf {
       }
 
     private:
+      template <typename T, typename R>
+      static edm::ESGetToken<T, R> es_consumes(edm::ConsumesCollector& iConsumes, edm::Transition iTransition) {
+        if (iTransition == edm::Transition::BeginRun) {
+          return iConsumes.esConsumes<T, R, edm::Transition::BeginRun>();
+        }
+        return iConsumes.esConsumes<T, R>();
+      }
+
       // ESWatcher functions
       void watch_mag_field(const IdealMagneticFieldRecord& record) { magField_ = &(record.get(magFieldToken_)); }
       void watch_dt_geom(const MuonGeometryRecord& record) { dtGeom_ = &(record.get(dtGeomToken_)); }
-      void watch_csc_geom(const MuonGeometryRecord& record) { cscGeom_ = &(record.get(cscGeomToken_)); }
+      void watch_csc_geom(const MuonGeometryRecord& record) {
+        cscGeom_ = &(record.get(cscGeomToken_));
+        muonGeomCacheId_ = record.cacheIdentifier();
+      }
       void watch_rpc_geom(const MuonGeometryRecord& record) { rpcGeom_ = &(record.get(rpcGeomToken_)); }
       void watch_gem_geom(const MuonGeometryRecord& record) { gemGeom_ = &(record.get(gemGeomToken_)); }
       void watch_me0_geom(const MuonGeometryRecord& record) { me0Geom_ = &(record.get(me0GeomToken_)); }
@@ -101,6 +128,11 @@ namespace emtf {
       const RPCGeometry* rpcGeom_;
       const GEMGeometry* gemGeom_;
       const ME0Geometry* me0Geom_;
+
+      unsigned long long muonGeomCacheId_;
+
+      // Derived from the ESHandle products, shared among the helper objects
+      std::shared_ptr<const CoordinateLUT> coordLUT_;
     };
 
   }  // namespace phase2
@@ -5,43 +5,70 @@
 
 #include "DataFormats/Provenance/interface/EventID.h"
 
+#include "L1Trigger/Phase2L1EMTF/interface/ChamberIndex.h"
 #include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFProfiler.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFScratch.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SubsystemTags.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SubsystemCollection.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemRouter.h"
 
 namespace emtf {
 
   namespace phase2 {
 
     class EMTFWorker;
+    class GeometryHelper;
+    class SectorTensorBuffer;
 
     class SectorProcessor {
     public:
       void process(const EMTFWorker& iWorker,
+                   const GeometryHelper& geom_helper,
                    int endcap,
                    int sector,
                    const edm::EventID& evt_id,
                    const SubsystemCollection& muon_primitives,
+                   const SubsystemRouter& router,
+                   const ChamberIndex& chamber_index,
+                   EMTFScratch::Sector& scratch,
                    EMTFHitCollection& out_hits,
-                   EMTFTrackCollection& out_tracks) const;
+                   EMTFTrackCollection& out_tracks,
+                   SectorTensorBuffer* out_tensors = nullptr,
+                   EMTFProfiler::Stats* stats = nullptr) const;
 
     private:
       template <typename>
       struct dependent_false;
 
-      void process_step_1(const EMTFWorker& iWorker,
-                          int endcap,
-                          int sector,
-                          int bx,
-                          const SubsystemCollection& muon_primitives,
-                          EMTFHitCollection& sector_hits) const;
+      // Convert the segments. If fill_input is set, the segments are written into the model input.
+      // If keep_hits is set, the hits are added to sector_hits. Returns the num of valid segments.
+      int process_step_1(const EMTFWorker& iWorker,
+                         const GeometryHelper& geom_helper,
+                         int endcap,
+                         int sector,
+                         int bx,
+                         const SubsystemCollection& muon_primitives,
+                         const SubsystemRouter::bucket_t& bucket,
+                         const ChamberIndex& chamber_index,
+                         bool fill_input,
+                         bool keep_hits,
+                         EMTFScratch::Sector& scratch,
+                         EMTFHitCollection& sector_hits,
+                         EMTFProfiler::Stats* stats) const;
 
       void process_step_2(const EMTFWorker& iWorker,
                           int endcap,
                           int sector,
                           int bx,
-                          const EMTFHitCollection& sector_hits,
-                          EMTFTrackCollection& sector_tracks) const;
+                          int num_hits,
+                          EMTFScratch::Sector& scratch,
+                          EMTFTrackCollection& sector_tracks,
+                          SectorTensorBuffer* out_tensors,
+                          EMTFProfiler::Stats* stats) const;
+
+      // Write the variables of one segment into the model input
+      void fill_model_input(const EMTFHit& hit, int* in0_iter) const;
 
       void dump_input_output(const edm::EventID& evt_id,
                              const SubsystemCollection& muon_primitives,
@@ -0,0 +1,159 @@
+#ifndef L1Trigger_Phase2L1EMTF_SectorTensorFile_h
+#define L1Trigger_Phase2L1EMTF_SectorTensorFile_h
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace emtf {
+
+  namespace phase2 {
+
+    // Binary file of the per-sector model input/output tensors, used to rerun the model on the
+    // same events without the digi collection and the coordinate conversion.
+    //
+    // Layout (native byte order, all offsets in bytes):
+    //
+    // +------------------------+
+    // | SectorTensorFileHeader |  header_size
+    // +------------------------+
+    // | record 0               |  record_size = SectorTensorRecordHeader + in0 + out (int32), 8-byte aligned
+    // | record 1               |
+    // | ...                    |
+    // +------------------------+
+    // | event index            |  num_events x SectorTensorIndexEntry, starting at index_offset
+    // +------------------------+
+    //
+    // The records of an event are contiguous, in the order they were produced. The records have a
+    // fixed size, so the reader can map the file and access any record without copying it.
+
+    struct SectorTensorFileHeader {
+      char magic[8];            // "EMTFTNSR"
+      uint32_t format_version;  // version of this layout
+      uint32_t byte_order;      // 0x01020304 as written by the producer
+      uint32_t header_size;     // offset of the first record
+      uint32_t record_size;     // size of each record
+      uint32_t model_version;   // EMTFModel::version()
+      uint32_t in0_size;        // num of int32 in the model input
+      uint32_t out_size;        // num of int32 in the model output
+      uint32_t reserved;
+      uint64_t num_records;
+      uint64_t num_events;
+      uint64_t index_offset;  // offset of the event index
+    };
+
+    struct SectorTensorRecordHeader {
+      uint32_t run;
+      uint32_t lumi;
+      uint64_t event;
+      int32_t endcap;
+      int32_t sector;
+      int32_t bx;
+      uint32_t reserved;
+    };
+
+    struct SectorTensorIndexEntry {
+      uint32_t run;
+      uint32_t lumi;
+      uint64_t event;
+      uint64_t first_record;
+      uint64_t num_records;
+    };
+
+    // Records of one event, accumulated before being written in one go
+    class SectorTensorBuffer {
+    public:
+      void clear() {
+        headers_.clear();
+        data_.clear();
+      }
+
+      bool empty() const { return headers_.empty(); }
+
+      size_t size() const { return headers_.size(); }
+
+      // Append one sector. in0 and out must have the sizes declared to the writer.
+      void add(int endcap, int sector, int bx, const std::vector<int>& in0, const std::vector<int>& out);
+
+      void add(int endcap, int sector, int bx, const int* in0, size_t in0_size, const int* out, size_t out_size);
+
+      // Append all the sectors from another buffer
+      void append(const SectorTensorBuffer& other);
+
+    private:
+      friend class SectorTensorWriter;
+
+      std::vector<SectorTensorRecordHeader> headers_;
+      std::vector<int32_t> data_;  // in0 and out of every record, concatenated
+    };
+
+    // The writer is shared by all the streams. Each call to write_event() is atomic, so that the
+    // records of one event are never interleaved with those of another event.
+    class SectorTensorWriter {
+    public:
+      explicit SectorTensorWriter(const std::string& fname, unsigned model_version, size_t in0_size, size_t out_size);
+      ~SectorTensorWriter();
+
+      bool is_open() const { return fp_ != nullptr; }
+
+      bool write_event(uint32_t run, uint32_t lumi, uint64_t event, const SectorTensorBuffer& buffer);
+
+      // Write the event index and the final header. Called by the destructor if not called before.
+      bool close();
+
+    private:
+      bool write_header();
+
+      std::mutex mutex_;
+      std::FILE* fp_;
+      SectorTensorFileHeader header_;
+      std::vector<SectorTensorIndexEntry> index_;
+      std::vector<char> record_buffer_;  // scratch for one record
+    };
+
+    // Read-only view of a sector tensor file. The file is memory-mapped, and the records point
+    // directly into the mapping.
+    class SectorTensorReader {
+    public:
+      struct Record {
+        const SectorTensorRecordHeader* header;
+        const int32_t* in0;
+        const int32_t* out;
+      };
+
+      explicit SectorTensorReader(const std::string& fname);
+      ~SectorTensorReader();
+
+      SectorTensorReader(const SectorTensorReader&) = delete;
+      SectorTensorReader& operator=(const SectorTensorReader&) = delete;
+
+      bool is_valid() const { return header_ != nullptr; }
+
+      const SectorTensorFileHeader& header() const { return *header_; }
+
+      size_t num_records() const { return header_->num_records; }
+
+      size_t num_events() const { return header_->num_events; }
+
+      Record get_record(size_t i) const;
+
+      const SectorTensorIndexEntry& get_event(size_t i) const { return index_[i]; }
+
+    private:
+      bool validate() const;
+
+      void* addr_;
+      size_t length_;
+      const SectorTensorFileHeader* header_;
+      const char* records_;
+      const SectorTensorIndexEntry* index_;
+    };
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_SectorTensorFile_h not defined
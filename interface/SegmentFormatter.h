@@ -2,10 +2,12 @@
 #define L1Trigger_Phase2L1EMTF_SegmentFormatter_h
 
 #include <array>
+#include <cstddef>
 #include <vector>
 
 #include "DataFormats/GeometryVector/interface/GlobalPoint.h"
 
+#include "L1Trigger/Phase2L1EMTF/interface/ChamberIndex.h"
 #include "L1Trigger/Phase2L1EMTF/interface/Common.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SubsystemTags.h"
 
@@ -13,29 +15,69 @@ namespace emtf {
 
   namespace phase2 {
 
+    class CoordinateLUT;
+
     class SegmentFormatter {
     public:
+      // Views into the ChamberIndex of the event
       struct ChamberInfo {
-        typedef std::vector<uint16_t> wire_ambi_t;
-        typedef std::vector<std::array<uint16_t, 3> > copad_vec_t;
+        typedef ConstSpan<ChamberIndex::wire_t> wire_ambi_t;
+        typedef ConstSpan<ChamberIndex::copad_t> copad_vec_t;
 
         wire_ambi_t wire_ambi;  // CSC wire ambiguity
         copad_vec_t copad_vec;  // GEM coincidence pads
       };
 
+      // Global coordinates of the formatted hits, in the same order as the hits. They are converted
+      // to EMTF coordinates for all the hits of a sector at once, in finalize().
+      class CoordinateBatch {
+      public:
+        void clear();
+
+        std::size_t size() const { return phi_.size(); }
+
+      private:
+        friend class SegmentFormatter;
+
+        void push_back(int subsystem, int emtf_host, float phi, float theta1, float theta2, bool has_theta2);
+
+        std::vector<int> subsystem_;
+        std::vector<int> emtf_host_;
+        std::vector<float> phi_;        // in rad, then in deg
+        std::vector<float> theta1_;     // in rad, then in deg
+        std::vector<float> theta2_;     // in rad, then in deg. Only for the CSC wire ambiguity.
+        std::vector<char> has_theta2_;  // theta2 is used
+        std::vector<int> ph_;
+        std::vector<int> th1_;
+        std::vector<int> th2_;
+      };
+
+      // If coord_lut is given, the global coordinates are taken from the precomputed tables when
+      // possible, instead of from the geometry.
+      explicit SegmentFormatter(const CoordinateLUT* coord_lut = nullptr) : coord_lut_(coord_lut) {}
+
+      // Convert one primitive for the given (endcap, sector, bx). The hit is left invalid if the
+      // primitive is rejected. Otherwise, returns the strategy that accepts it: 0 (default) or 1
+      // (substitute, with a lower priority). The acceptance of both strategies is evaluated in the
+      // same pass, so the conversion is done only once. The global coordinates of an accepted hit
+      // are appended to batch, and its EMTF coordinates are only set by finalize().
       template <typename T1, typename T2, typename T3>
-      void format(int endcap,
-                  int sector,
-                  int bx,
-                  int strategy,
-                  const T1& detgeom,
-                  const T2& detid,
-                  const T3& digi,
-                  const ChamberInfo& chminfo,
-                  EMTFHit& hit) const {
-        format_impl(endcap, sector, bx, strategy, detgeom, detid, digi, chminfo, hit);
+      int format(int endcap,
+                 int sector,
+                 int bx,
+                 const T1& detgeom,
+                 const T2& detid,
+                 const T3& digi,
+                 const ChamberInfo& chminfo,
+                 CoordinateBatch& batch,
+                 EMTFHit& hit) const {
+        return format_impl(endcap, sector, bx, detgeom, detid, digi, chminfo, batch, hit);
       }
 
+      // Convert the global coordinates of all the accepted hits to EMTF coordinates, and set the
+      // EMTF phi, theta and zones of the hits. hits must be in the same order as batch.
+      void finalize(int endcap, int sector, CoordinateBatch& batch, EMTFHitCollection& hits) const;
+
     private:
       static const int kInvalid = -99;
 
@@ -57,50 +99,53 @@ namespace emtf {
       struct find_seg_timezones;
 
       // Overloaded for CSC
-      void format_impl(int endcap,
-                       int sector,
-                       int bx,
-                       int strategy,
-                       const CSCGeometry& detgeom,
-                       const csc_subsystem_tag::detid_type& detid,
-                       const csc_subsystem_tag::digi_type& digi,
-                       const ChamberInfo& chminfo,
-                       EMTFHit& hit) const;
+      int format_impl(int endcap,
+                      int sector,
+                      int bx,
+                      const CSCGeometry& detgeom,
+                      const csc_subsystem_tag::detid_type& detid,
+                      const csc_subsystem_tag::digi_type& digi,
+                      const ChamberInfo& chminfo,
+                      CoordinateBatch& batch,
+                      EMTFHit& hit) const;
 
       // Overloaded for RPC
-      void format_impl(int endcap,
-                       int sector,
-                       int bx,
-                       int strategy,
-                       const RPCGeometry& detgeom,
-                       const rpc_subsystem_tag::detid_type& detid,
-                       const rpc_subsystem_tag::digi_type& digi,
-                       const ChamberInfo& chminfo,
-                       EMTFHit& hit) const;
+      int format_impl(int endcap,
+                      int sector,
+                      int bx,
+                      const RPCGeometry& detgeom,
+                      const rpc_subsystem_tag::detid_type& detid,
+                      const rpc_subsystem_tag::digi_type& digi,
+                      const ChamberInfo& chminfo,
+                      CoordinateBatch& batch,
+                      EMTFHit& hit) const;
 
       // Overloaded for GEM
-      void format_impl(int endcap,
-                       int sector,
-                       int bx,
-                       int strategy,
-                       const GEMGeometry& detgeom,
-                       const gem_subsystem_tag::detid_type& detid,
-                       const gem_subsystem_tag::digi_type& digi,
-                       const ChamberInfo& chminfo,
-                       EMTFHit& hit) const;
+      int format_impl(int endcap,
+                      int sector,
+                      int bx,
+                      const GEMGeometry& detgeom,
+                      const gem_subsystem_tag::detid_type& detid,
+                      const gem_subsystem_tag::digi_type& digi,
+                      const ChamberInfo& chminfo,
+                      CoordinateBatch& batch,
+                      EMTFHit& hit) const;
 
       // Overloaded for ME0
-      void format_impl(int endcap,
-                       int sector,
-                       int bx,
-                       int strategy,
-                       const ME0Geometry& detgeom,
-                       const me0_subsystem_tag::detid_type& detid,
-                       const me0_subsystem_tag::digi_type& digi,
-                       const ChamberInfo& chminfo,
-                       EMTFHit& hit) const;
-
-      // Convert to global coordinates
+      int format_impl(int endcap,
+                      int sector,
+                      int bx,
+                      const ME0Geometry& detgeom,
+                      const me0_subsystem_tag::detid_type& detid,
+                      const me0_subsystem_tag::digi_type& digi,
+                      const ChamberInfo& chminfo,
+                      CoordinateBatch& batch,
+                      EMTFHit& hit) const;
+
+      // Convert to global coordinates, using the CoordinateLUT if available
+      template <typename G, typename D, typename T>
+      GlobalPoint find_global_point(const G& detgeom, const D& detid, const T& digi) const;
+
       GlobalPoint get_global_point(const CSCGeometry& detgeom,
                                    const csc_subsystem_tag::detid_type& detid,
                                    const csc_subsystem_tag::digi_type& digi) const;
@@ -116,6 +161,8 @@ namespace emtf {
       GlobalPoint get_global_point(const ME0Geometry& detgeom,
                                    const me0_subsystem_tag::detid_type& detid,
                                    const me0_subsystem_tag::digi_type& digi) const;
+
+      const CoordinateLUT* coord_lut_;
     };
 
   }  // namespace phase2
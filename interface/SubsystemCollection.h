@@ -1,8 +1,8 @@
 #ifndef L1Trigger_Phase2L1EMTF_SubsystemCollection_h
 #define L1Trigger_Phase2L1EMTF_SubsystemCollection_h
 
+#include <cstddef>
 #include <tuple>
-#include <variant>
 #include <vector>
 
 #include "L1Trigger/Phase2L1EMTF/interface/Common.h"
@@ -12,81 +12,80 @@ namespace emtf {
 
   namespace phase2 {
 
+    // Trigger primitive of one subsystem. The digi is not copied, it points into the digi
+    // collection held by the event.
+    template <typename T>
+    struct SubsystemPrimitive {
+      typename T::detid_type detid;
+      const typename T::digi_type* digi_ptr;
+
+      const typename T::digi_type& digi() const { return *digi_ptr; }
+    };
+
+    // Structure-of-arrays collection of trigger primitives, with one contiguous vector per
+    // subsystem. Within a subsystem, the primitives are kept in the order they were collected.
+    // A primitive is identified by its subsystem and its index in the vector of that subsystem.
+    //
+    // The collection does not own the digis. It must be cleared before the event that holds the
+    // digis goes away, which is the case when it is filled and used within one produce() call.
     class SubsystemCollection {
     public:
-      using poly_subsystem_type =
-          std::variant<csc_subsystem_tag, rpc_subsystem_tag, gem_subsystem_tag, me0_subsystem_tag>;
-      using poly_detid_type = std::variant<csc_subsystem_tag::detid_type,
-                                           rpc_subsystem_tag::detid_type,
-                                           gem_subsystem_tag::detid_type,
-                                           me0_subsystem_tag::detid_type>;
-      using poly_digi_type = std::variant<csc_subsystem_tag::digi_type,
-                                          rpc_subsystem_tag::digi_type,
-                                          gem_subsystem_tag::digi_type,
-                                          me0_subsystem_tag::digi_type>;
-
-      using first_container_type = std::vector<poly_subsystem_type>;
-      using second_container_type = std::vector<poly_detid_type>;
-      using third_container_type = std::vector<poly_digi_type>;
-
-      template <typename T1, typename T2, typename T3>
-      void push_back(T1 subsystem, const T2& detid, const T3& digi) {
-        storage_subsystem_.push_back(subsystem);
-        storage_detid_.push_back(detid);
-        storage_digi_.push_back(digi);
-        assert((storage_subsystem_.size() == storage_detid_.size()) and
-               (storage_subsystem_.size() == storage_digi_.size()));
-      }
-
-      struct reference {
-        using first_ref_type = first_container_type::const_iterator::reference;
-        using second_ref_type = second_container_type::const_iterator::reference;
-        using third_ref_type = third_container_type::const_iterator::reference;
+      template <typename T>
+      using container_type = std::vector<SubsystemPrimitive<T> >;
 
-        first_ref_type first_ref;
-        second_ref_type second_ref;
-        third_ref_type third_ref;
-      };
+      template <typename T>
+      void push_back(T subsystem, const typename T::detid_type& detid, const typename T::digi_type& digi) {
+        get_mutable<T>().push_back(SubsystemPrimitive<T>{detid, &digi});
+      }
 
-      struct iterator {
-        using first_iter_type = first_container_type::const_iterator;
-        using second_iter_type = second_container_type::const_iterator;
-        using third_iter_type = third_container_type::const_iterator;
+      template <typename T>
+      const container_type<T>& get() const {
+        return std::get<container_type<T> >(storage_);
+      }
 
-        reference operator*() const { return reference{*first_iter, *second_iter, *third_iter}; }
+      // Call fn(subsystem, detid, digi) on every primitive, one subsystem after another
+      template <typename F>
+      void for_each(F&& fn) const {
+        for_each_impl<csc_subsystem_tag>(fn);
+        for_each_impl<rpc_subsystem_tag>(fn);
+        for_each_impl<gem_subsystem_tag>(fn);
+        for_each_impl<me0_subsystem_tag>(fn);
+      }
 
-        iterator& operator++() {
-          ++first_iter;
-          ++second_iter;
-          ++third_iter;
-          return *this;
-        }
+      using size_type = std::size_t;
 
-        friend bool operator==(const iterator& lhs, const iterator& rhs) {
-          return std::tie(lhs.first_iter, lhs.second_iter, lhs.third_iter) ==
-                 std::tie(rhs.first_iter, rhs.second_iter, rhs.third_iter);
-        }
+      size_type size() const {
+        return get<csc_subsystem_tag>().size() + get<rpc_subsystem_tag>().size() + get<gem_subsystem_tag>().size() +
+               get<me0_subsystem_tag>().size();
+      }
 
-        friend bool operator!=(const iterator& lhs, const iterator& rhs) {
-          return std::tie(lhs.first_iter, lhs.second_iter, lhs.third_iter) !=
-                 std::tie(rhs.first_iter, rhs.second_iter, rhs.third_iter);
-        }
+      bool empty() const { return size() == 0; }
 
-        first_iter_type first_iter;
-        second_iter_type second_iter;
-        third_iter_type third_iter;
-      };
+      void clear() {
+        get_mutable<csc_subsystem_tag>().clear();
+        get_mutable<rpc_subsystem_tag>().clear();
+        get_mutable<gem_subsystem_tag>().clear();
+        get_mutable<me0_subsystem_tag>().clear();
+      }
 
-      iterator begin() const {
-        return iterator{storage_subsystem_.begin(), storage_detid_.begin(), storage_digi_.begin()};
+    private:
+      template <typename T>
+      container_type<T>& get_mutable() {
+        return std::get<container_type<T> >(storage_);
       }
 
-      iterator end() const { return iterator{storage_subsystem_.end(), storage_detid_.end(), storage_digi_.end()}; }
+      template <typename T, typename F>
+      void for_each_impl(F& fn) const {
+        for (const auto& prim : get<T>()) {
+          fn(T{}, prim.detid, prim.digi());
+        }
+      }
 
-    private:
-      first_container_type storage_subsystem_;
-      second_container_type storage_detid_;
-      third_container_type storage_digi_;
+      std::tuple<container_type<csc_subsystem_tag>,
+                 container_type<rpc_subsystem_tag>,
+                 container_type<gem_subsystem_tag>,
+                 container_type<me0_subsystem_tag> >
+          storage_;
     };
 
   }  // namespace phase2
@@ -18,6 +18,8 @@ namespace emtf {
     public:
       // Case 1: assume MuonDigiCollection type, e.g. CSC, GEM, ME0.
       // Case 2: assume edm::RangeMap type, e.g. RPC.
+      // The digis are not copied. The collection refers to the digis held by the event, so it
+      // must not be used after the event is done.
       template <typename T>
       void collect(const edm::Event& iEvent, const edm::EDGetToken& token, SubsystemCollection& muon_primitives) const {
         typedef typename T::collection_type collection_type;
@@ -0,0 +1,99 @@
+#ifndef L1Trigger_Phase2L1EMTF_SubsystemRouter_h
+#define L1Trigger_Phase2L1EMTF_SubsystemRouter_h
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/interface/Common.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemTags.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemCollection.h"
+
+namespace emtf {
+
+  namespace phase2 {
+
+    // Route every primitive once to the (endcap, sector, bx) buckets where it can be formatted,
+    // so that each sector processor only loops over its own primitives.
+    class SubsystemRouter {
+    public:
+      // Entry of a bucket
+      struct Route {
+        unsigned iprim;   // index into the per-subsystem vector of the SubsystemCollection
+        bool is_delayed;  // primitive is taken one BX after its own BX
+      };
+
+      // Routes of the primitives of each subsystem, kept in the original order
+      class Bucket {
+      public:
+        template <typename T>
+        const std::vector<Route>& get() const {
+          return routes_[T::index];
+        }
+
+        std::size_t size() const;
+
+      private:
+        friend class SubsystemRouter;
+
+        std::array<std::vector<Route>, NUM_SUBSYSTEMS> routes_;
+      };
+
+      typedef Bucket bucket_t;
+
+      explicit SubsystemRouter(int min_bx, int max_bx);
+      ~SubsystemRouter();
+
+      void route(const SubsystemCollection& muon_primitives);
+
+      const bucket_t& get_bucket(int endcap, int sector, int bx) const;
+
+    private:
+      template <typename T>
+      void route_impl(const SubsystemCollection& muon_primitives);
+
+      struct Destination {
+        int endcap;
+        int sector;
+        int bx;
+        bool is_shared;   // chamber is also sent to the next sector as a neighbor
+        bool is_delayed;  // primitive can also be taken one BX later
+      };
+
+      // Overloaded for CSC
+      bool find_destination(const csc_subsystem_tag::detid_type& detid,
+                            const csc_subsystem_tag::digi_type& digi,
+                            Destination& dest) const;
+
+      // Overloaded for RPC
+      bool find_destination(const rpc_subsystem_tag::detid_type& detid,
+                            const rpc_subsystem_tag::digi_type& digi,
+                            Destination& dest) const;
+
+      // Overloaded for GEM
+      bool find_destination(const gem_subsystem_tag::detid_type& detid,
+                            const gem_subsystem_tag::digi_type& digi,
+                            Destination& dest) const;
+
+      // Overloaded for ME0
+      bool find_destination(const me0_subsystem_tag::detid_type& detid,
+                            const me0_subsystem_tag::digi_type& digi,
+                            Destination& dest) const;
+
+      bool is_shared_chamber(int tp_subsector, int tp_station, int tp_cscid) const;
+
+      void fill(int subsystem, unsigned iprim, const Destination& dest);
+
+      unsigned get_index(int endcap, int sector, int bx) const;
+
+      const int min_bx_;
+      const int max_bx_;
+
+      std::vector<bucket_t> buckets_;
+    };
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_SubsystemRouter_h not defined
@@ -25,11 +25,16 @@ namespace emtf {
 
   namespace phase2 {
 
+    // The index of each subsystem gives its position in the per-subsystem containers. The
+    // subsystems are always visited in this order: CSC, RPC, GEM, ME0.
+    constexpr int NUM_SUBSYSTEMS = 4;
+
     struct csc_subsystem_tag {
       typedef CSCDetId detid_type;
       typedef CSCCorrelatedLCTDigi digi_type;
       typedef CSCCorrelatedLCTDigiCollection collection_type;
       typedef CSCGeometry detgeom_type;
+      static constexpr int index = 0;
     };
 
     struct rpc_subsystem_tag {
@@ -37,6 +42,7 @@ namespace emtf {
       typedef RPCRecHit digi_type;
       typedef RPCRecHitCollection collection_type;
       typedef RPCGeometry detgeom_type;
+      static constexpr int index = 1;
     };
 
     struct gem_subsystem_tag {
@@ -44,6 +50,7 @@ namespace emtf {
       typedef GEMPadDigiCluster digi_type;
       typedef GEMPadDigiClusterCollection collection_type;
       typedef GEMGeometry detgeom_type;
+      static constexpr int index = 2;
     };
 
     struct me0_subsystem_tag {
@@ -51,6 +58,7 @@ namespace emtf {
       typedef ME0TriggerDigi digi_type;
       typedef ME0TriggerDigiCollection collection_type;
       typedef ME0Geometry detgeom_type;
+      static constexpr int index = 3;
     };
 
   }  // namespace phase2
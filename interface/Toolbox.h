@@ -2,6 +2,7 @@
 #define L1Trigger_Phase2L1EMTF_Toolbox_h
 
 #include <cmath>
+#include <cstddef>
 #include <utility>  // provides std::pair
 
 namespace emtf {
@@ -156,6 +157,15 @@ namespace emtf {
         return phi_int;
       }
 
+      // _______________________________________________________________________
+      // Batch versions of rad_to_deg(), calc_theta_int() and calc_phi_int(), bit-exact with the
+      // scalar versions. Use SSE4.1 or AVX2 if enabled at compile time.
+      void rad_to_deg(const float* rad, float* deg, std::size_t n);
+
+      void calc_theta_int(const float* theta, int endcap, int* theta_int, std::size_t n);
+
+      void calc_phi_int(const float* glob, int sector, int* phi_int, std::size_t n);
+
     }  // namespace toolbox
 
   }  // namespace phase2
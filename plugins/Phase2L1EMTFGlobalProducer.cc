@@ -0,0 +1,162 @@
+// system include files
+#include <cassert>
+#include <memory>
+#include <iostream>
+#include <sstream>
+
+// user include files
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFContext.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFPackedHit.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFProfiler.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFRunContext.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFScratch.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFWorker.h"
+
+// Objects owned by each stream
+struct Phase2L1EMTFStreamCache {
+  std::unique_ptr<emtf::phase2::EMTFScratch> scratch;  // reused across events
+  emtf::phase2::EMTFProfiler::Stats stats;            // merged into the EMTFContext at the end of the stream
+};
+
+// Same algorithm as Phase2L1EMTFProducer, but a single EMTFWorker is shared by all the streams.
+// The EventSetup-dependent helper objects are held in a RunCache and updated at the beginning of
+// each run. The scratch buffers and the timers and counters are held in a StreamCache.
+class Phase2L1EMTFGlobalProducer
+    : public edm::global::EDProducer<edm::RunCache<emtf::phase2::EMTFRunContext>,
+                                     edm::StreamCache<Phase2L1EMTFStreamCache> > {
+public:
+  using run_cache_t = emtf::phase2::EMTFRunContext;
+  using stream_cache_t = Phase2L1EMTFStreamCache;
+
+  explicit Phase2L1EMTFGlobalProducer(const edm::ParameterSet&);
+  ~Phase2L1EMTFGlobalProducer() override;
+
+  static void fillDescriptions(edm::ConfigurationDescriptions&);
+
+private:
+  std::shared_ptr<run_cache_t> globalBeginRun(const edm::Run&, const edm::EventSetup&) const final;
+  void globalEndRun(const edm::Run&, const edm::EventSetup&) const final;
+
+  std::unique_ptr<stream_cache_t> beginStream(edm::StreamID) const final;
+  void endStream(edm::StreamID) const final;
+  void endJob() final;
+
+  void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const final;
+
+private:
+  const std::unique_ptr<emtf::phase2::EMTFContext> context_;
+  const std::unique_ptr<emtf::phase2::EMTFWorker> worker_;
+
+  // Output enables
+  const bool produceHits_;
+  const bool producePackedHits_;
+
+  // Output tokens
+  const edm::EDPutTokenT<emtf::phase2::EMTFHitCollection> hitToken_;
+  const edm::EDPutTokenT<emtf::phase2::EMTFPackedHitCollection> packedHitToken_;
+  const edm::EDPutTokenT<emtf::phase2::EMTFTrackCollection> trkToken_;
+};
+
+// _____________________________________________________________________________
+// The worker registers its ESGetTokens for the BeginRun transition.
+Phase2L1EMTFGlobalProducer::Phase2L1EMTFGlobalProducer(const edm::ParameterSet& iConfig)
+    : context_(std::make_unique<emtf::phase2::EMTFContext>(iConfig)),
+      worker_(std::make_unique<emtf::phase2::EMTFWorker>(
+          *context_, iConfig, consumesCollector(), edm::Transition::BeginRun)),
+      produceHits_(iConfig.getParameter<bool>("produceHits")),
+      producePackedHits_(iConfig.getParameter<bool>("producePackedHits")),
+      hitToken_(produceHits_ ? produces<emtf::phase2::EMTFHitCollection>()
+                             : edm::EDPutTokenT<emtf::phase2::EMTFHitCollection>()),
+      packedHitToken_(producePackedHits_ ? produces<emtf::phase2::EMTFPackedHitCollection>()
+                                         : edm::EDPutTokenT<emtf::phase2::EMTFPackedHitCollection>()),
+      trkToken_(produces<emtf::phase2::EMTFTrackCollection>()) {}
+
+Phase2L1EMTFGlobalProducer::~Phase2L1EMTFGlobalProducer() {}
+
+// This is called once per run, before any event in the run is processed.
+std::shared_ptr<Phase2L1EMTFGlobalProducer::run_cache_t> Phase2L1EMTFGlobalProducer::globalBeginRun(
+    const edm::Run& iRun, const edm::EventSetup& iSetup) const {
+  auto iRunContext = std::make_shared<run_cache_t>(*worker_);
+  iRunContext->before_run(*context_, iSetup);
+  return iRunContext;
+}
+
+void Phase2L1EMTFGlobalProducer::globalEndRun(const edm::Run& iRun, const edm::EventSetup& iSetup) const {}
+
+std::unique_ptr<Phase2L1EMTFGlobalProducer::stream_cache_t> Phase2L1EMTFGlobalProducer::beginStream(
+    edm::StreamID iStream) const {
+  auto iStreamCache = std::make_unique<stream_cache_t>();
+  iStreamCache->scratch = worker_->make_scratch();
+  return iStreamCache;
+}
+
+// This is called once per stream, after the last event of the stream.
+void Phase2L1EMTFGlobalProducer::endStream(edm::StreamID iStream) const {
+  if (auto* profiler = context_->get_profiler()) {
+    profiler->merge(streamCache(iStream)->stats);  // lock-free
+  }
+}
+
+void Phase2L1EMTFGlobalProducer::endJob() {
+  if (const auto* profiler = context_->get_profiler()) {
+    std::ostringstream oss;
+    profiler->print_summary(oss);
+    edm::LogPrint("Phase2L1EMTF") << oss.str();
+  }
+}
+
+// This is called by multiple streams concurrently.
+void Phase2L1EMTFGlobalProducer::produce(edm::StreamID iStream,
+                                         edm::Event& iEvent,
+                                         const edm::EventSetup& iSetup) const {
+  emtf::phase2::EMTFHitCollection out_hits;
+  emtf::phase2::EMTFTrackCollection out_tracks;
+
+  // Access the RunCache object
+  const run_cache_t* iRunContext = runCache(iEvent.getRun().index());
+  assert(iRunContext != nullptr);
+
+  // Access the StreamCache object
+  stream_cache_t* iStreamCache = streamCache(iStream);
+  assert(iStreamCache != nullptr);
+
+  // Only collect the timers and counters if instrumentation is enabled
+  emtf::phase2::EMTFProfiler::Stats* stats = (context_->get_profiler() != nullptr) ? &iStreamCache->stats : nullptr;
+
+  // Dispatch
+  worker_->process(iEvent, *iRunContext, *iStreamCache->scratch, out_hits, out_tracks, stats);  // const function
+
+  // Output the products. The packed hits are in the same order as the full hits.
+  if (producePackedHits_) {
+    emtf::phase2::EMTFPackedHitCollection out_packed_hits;
+    emtf::phase2::pack_hits(out_hits, out_packed_hits);
+    iEvent.emplace(packedHitToken_, std::move(out_packed_hits));
+  }
+  if (produceHits_) {
+    iEvent.emplace(hitToken_, std::move(out_hits));
+  }
+  iEvent.emplace(trkToken_, std::move(out_tracks));
+}
+
+// This static function provides the configuration parameters.
+void Phase2L1EMTFGlobalProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  emtf::phase2::EMTFWorker::fill_description(desc);
+  desc.add<bool>("produceHits", true);
+  desc.add<bool>("producePackedHits", false);
+  descriptions.add("phase2L1EMTFGlobalProducer", desc);
+}
+
+// define this as a plug-in
+#include "FWCore/Framework/interface/MakerMacros.h"
+DEFINE_FWK_MODULE(Phase2L1EMTFGlobalProducer);
@@ -2,6 +2,7 @@
 #include <cassert>
 #include <memory>
 #include <iostream>
+#include <sstream>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -14,6 +15,8 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFContext.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFPackedHit.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFProfiler.h"
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFWorker.h"
 
 class Phase2L1EMTFProducer : public edm::stream::EDProducer<edm::GlobalCache<emtf::phase2::EMTFContext> > {
@@ -31,20 +34,34 @@ public:
 
 private:
   void produce(edm::Event&, const edm::EventSetup&) final;
+  void endStream() final;
 
 private:
   std::unique_ptr<emtf::phase2::EMTFWorker> worker_;
 
+  // Timers and counters of this stream, merged into the GlobalCache object at the end
+  emtf::phase2::EMTFProfiler::Stats stats_;
+
+  // Output enables
+  const bool produceHits_;
+  const bool producePackedHits_;
+
   // Output tokens
   const edm::EDPutTokenT<emtf::phase2::EMTFHitCollection> hitToken_;
+  const edm::EDPutTokenT<emtf::phase2::EMTFPackedHitCollection> packedHitToken_;
   const edm::EDPutTokenT<emtf::phase2::EMTFTrackCollection> trkToken_;
 };
 
 // _____________________________________________________________________________
 // Constructor with access to the GlobalCache object.
 Phase2L1EMTFProducer::Phase2L1EMTFProducer(const edm::ParameterSet& iConfig, const global_cache_t* iContext)
-    : worker_(std::make_unique<emtf::phase2::EMTFWorker>(iConfig, consumesCollector())),
-      hitToken_(produces<emtf::phase2::EMTFHitCollection>()),
+    : worker_(std::make_unique<emtf::phase2::EMTFWorker>(*iContext, iConfig, consumesCollector())),
+      produceHits_(iConfig.getParameter<bool>("produceHits")),
+      producePackedHits_(iConfig.getParameter<bool>("producePackedHits")),
+      hitToken_(produceHits_ ? produces<emtf::phase2::EMTFHitCollection>()
+                             : edm::EDPutTokenT<emtf::phase2::EMTFHitCollection>()),
+      packedHitToken_(producePackedHits_ ? produces<emtf::phase2::EMTFPackedHitCollection>()
+                                         : edm::EDPutTokenT<emtf::phase2::EMTFPackedHitCollection>()),
       trkToken_(produces<emtf::phase2::EMTFTrackCollection>()) {}
 
 Phase2L1EMTFProducer::~Phase2L1EMTFProducer() {}
@@ -56,7 +73,13 @@ Phase2L1EMTFProducer::global_cache_pointer Phase2L1EMTFProducer::initializeGloba
 }
 
 // This static function is called only once at the end of the job.
-void Phase2L1EMTFProducer::globalEndJob(const global_cache_t* iContext) {}
+void Phase2L1EMTFProducer::globalEndJob(const global_cache_t* iContext) {
+  if (const auto* profiler = iContext->get_profiler()) {
+    std::ostringstream oss;
+    profiler->print_summary(oss);
+    edm::LogPrint("Phase2L1EMTF") << oss.str();
+  }
+}
 
 // This is called by multiple streams.
 void Phase2L1EMTFProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
@@ -67,30 +90,38 @@ void Phase2L1EMTFProducer::produce(edm::Event& iEvent, const edm::EventSetup& iS
   const global_cache_t* iContext = globalCache();
   assert(iContext != nullptr);
 
-  // Dispatch
-  worker_->before_process(*iContext, iSetup);      // non-const function
-  worker_->process(iEvent, out_hits, out_tracks);  // const function
+  // Only collect the timers and counters if instrumentation is enabled
+  emtf::phase2::EMTFProfiler::Stats* stats = (iContext->get_profiler() != nullptr) ? &stats_ : nullptr;
 
-  // Output the products
-  iEvent.emplace(hitToken_, std::move(out_hits));
+  // Dispatch
+  worker_->before_process(*iContext, iSetup);             // non-const function
+  worker_->process(iEvent, out_hits, out_tracks, stats);  // const function
+
+  // Output the products. The packed hits are in the same order as the full hits.
+  if (producePackedHits_) {
+    emtf::phase2::EMTFPackedHitCollection out_packed_hits;
+    emtf::phase2::pack_hits(out_hits, out_packed_hits);
+    iEvent.emplace(packedHitToken_, std::move(out_packed_hits));
+  }
+  if (produceHits_) {
+    iEvent.emplace(hitToken_, std::move(out_hits));
+  }
   iEvent.emplace(trkToken_, std::move(out_tracks));
 }
 
+// This is called once per stream, after the last event of the stream.
+void Phase2L1EMTFProducer::endStream() {
+  if (auto* profiler = globalCache()->get_profiler()) {
+    profiler->merge(stats_);  // lock-free
+  }
+}
+
 // This static function provides the configuration parameters.
 void Phase2L1EMTFProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
   edm::ParameterSetDescription desc;
-  desc.add<edm::InputTag>("cscLabel", edm::InputTag("simCscTriggerPrimitiveDigisForEMTF", "MPCSORTED"));
-  desc.add<edm::InputTag>("rpcLabel", edm::InputTag("rpcRecHitsForEMTF"));
-  desc.add<edm::InputTag>("gemLabel", edm::InputTag("simMuonGEMPadDigiClusters"));
-  desc.add<edm::InputTag>("me0Label", edm::InputTag("me0TriggerConvertedPseudoDigis"));
-  desc.add<bool>("cscEnable", true);
-  desc.add<bool>("rpcEnable", true);
-  desc.add<bool>("gemEnable", true);
-  desc.add<bool>("me0Enable", true);
-  desc.add<int>("minBX", -2);
-  desc.add<int>("maxBX", 2);
-  desc.add<int>("bxWindow", 1);
-  desc.addUntracked<int>("verbosity", 0);
+  emtf::phase2::EMTFWorker::fill_description(desc);
+  desc.add<bool>("produceHits", true);
+  desc.add<bool>("producePackedHits", false);
   descriptions.add("phase2L1EMTFProducer", desc);
 
   //edm::ParameterSetDescription default_desc;
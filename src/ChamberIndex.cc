@@ -0,0 +1,115 @@
+#include "L1Trigger/Phase2L1EMTF/interface/ChamberIndex.h"
+
+#include <algorithm>  // provides std::sort, std::find, std::lower_bound
+#include <iterator>   // provides std::next
+
+using namespace emtf::phase2;
+
+ChamberIndex::ChamberIndex() {}
+
+ChamberIndex::~ChamberIndex() {}
+
+void ChamberIndex::build(const SubsystemCollection& muon_primitives) {
+  build_csc(muon_primitives);
+  build_gem(muon_primitives);
+}
+
+ConstSpan<ChamberIndex::wire_t> ChamberIndex::get_wire_ambi(const csc_subsystem_tag::detid_type& detid,
+                                                            const csc_subsystem_tag::digi_type& digi) const {
+  const Range* range = find_range(csc_ranges_, make_key(detid.rawId(), digi.getBX()));
+  if (range == nullptr)
+    return ConstSpan<wire_t>();
+  return ConstSpan<wire_t>(csc_wires_.data() + range->begin, csc_wires_.data() + range->end);
+}
+
+ConstSpan<ChamberIndex::copad_t> ChamberIndex::get_copad_vec(const gem_subsystem_tag::detid_type& detid,
+                                                             const gem_subsystem_tag::digi_type& digi) const {
+  // Remove layer number and roll number from detid
+  gem_subsystem_tag::detid_type detid_mod(detid.region(), detid.ring(), detid.station(), 0, detid.chamber(), 0);
+  const Range* range = find_range(gem_ranges_, make_key(detid_mod.rawId(), digi.bx()));
+  if (range == nullptr)
+    return ConstSpan<copad_t>();
+  return ConstSpan<copad_t>(gem_copads_.data() + range->begin, gem_copads_.data() + range->end);
+}
+
+// _____________________________________________________________________________
+ChamberIndex::key_t ChamberIndex::make_key(uint32_t rawId, int bx) {
+  return (static_cast<key_t>(rawId) << 32) | static_cast<uint32_t>(bx);
+}
+
+const ChamberIndex::Range* ChamberIndex::find_range(const std::vector<Range>& ranges, key_t key) {
+  auto cmp = [](const Range& lhs, key_t rhs) { return lhs.key < rhs; };
+  auto found = std::lower_bound(ranges.begin(), ranges.end(), key, cmp);
+  if ((found == ranges.end()) or (found->key != key))
+    return nullptr;
+  return &(*found);
+}
+
+void ChamberIndex::build_csc(const SubsystemCollection& muon_primitives) {
+  const auto& primitives = muon_primitives.get<csc_subsystem_tag>();
+
+  csc_ranges_.clear();
+  csc_wires_.clear();
+
+  // Sort by (key, index), so that the original order is kept within a key
+  sort_buffer_.clear();
+  for (uint32_t iprim = 0; iprim < primitives.size(); ++iprim) {
+    const auto& [detid, digi_ptr] = primitives[iprim];
+    sort_buffer_.emplace_back(make_key(detid.rawId(), digi_ptr->getBX()), iprim);
+  }
+  std::sort(sort_buffer_.begin(), sort_buffer_.end());
+
+  for (const auto& [key, iprim] : sort_buffer_) {
+    if (csc_ranges_.empty() or (csc_ranges_.back().key != key)) {
+      const uint32_t pos = csc_wires_.size();
+      csc_ranges_.push_back(Range{key, pos, pos});
+    }
+
+    // Keep the unique wires
+    Range& range = csc_ranges_.back();
+    const wire_t tp_wire = primitives[iprim].digi().getKeyWG();
+    auto range_begin = std::next(csc_wires_.begin(), range.begin);
+    if (std::find(range_begin, csc_wires_.end(), tp_wire) == csc_wires_.end()) {
+      csc_wires_.push_back(tp_wire);
+      range.end = csc_wires_.size();
+    }
+  }  // end loop
+}
+
+void ChamberIndex::build_gem(const SubsystemCollection& muon_primitives) {
+  const auto& primitives = muon_primitives.get<gem_subsystem_tag>();
+
+  gem_ranges_.clear();
+  gem_copads_.clear();
+
+  // Sort by (key, index), so that the original order is kept within a key. Only the valid
+  // primitives in layer 1 (incidence) and layer 2 (coincidence) create a key.
+  sort_buffer_.clear();
+  for (uint32_t iprim = 0; iprim < primitives.size(); ++iprim) {
+    const auto& [detid, digi_ptr] = primitives[iprim];
+    const int tp_layer = detid.layer();
+    if (digi_ptr->isValid() and ((tp_layer == 1) or (tp_layer == 2))) {
+      // Remove layer number and roll number from detid
+      gem_subsystem_tag::detid_type detid_mod(detid.region(), detid.ring(), detid.station(), 0, detid.chamber(), 0);
+      sort_buffer_.emplace_back(make_key(detid_mod.rawId(), digi_ptr->bx()), iprim);
+    }
+  }
+  std::sort(sort_buffer_.begin(), sort_buffer_.end());
+
+  for (const auto& [key, iprim] : sort_buffer_) {
+    if (gem_ranges_.empty() or (gem_ranges_.back().key != key)) {
+      const uint32_t pos = gem_copads_.size();
+      gem_ranges_.push_back(Range{key, pos, pos});
+    }
+
+    // Layer 2 is used as coincidence
+    const auto& [detid, digi_ptr] = primitives[iprim];
+    if (detid.layer() == 2) {
+      const uint16_t tp_roll = detid.roll();
+      const uint16_t tp_pad_lo = digi_ptr->pads().front();
+      const uint16_t tp_pad_hi = digi_ptr->pads().back();
+      gem_copads_.push_back(copad_t{{tp_roll, tp_pad_lo, tp_pad_hi}});
+      gem_ranges_.back().end = gem_copads_.size();
+    }
+  }  // end loop
+}
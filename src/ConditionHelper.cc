@@ -3,16 +3,22 @@
 using namespace emtf::phase2;
 
 ConditionHelper::ConditionHelper(edm::ConsumesCollector&& iConsumes)
-    : paramsToken_(iConsumes.esConsumes<L1TMuonEndCapParams, L1TMuonEndCapParamsRcd>()),
-      forestToken_(iConsumes.esConsumes<L1TMuonEndCapForest, L1TMuonEndCapForestRcd>()),
+    : ConditionHelper(iConsumes, edm::Transition::Event) {}
+
+ConditionHelper::ConditionHelper(edm::ConsumesCollector& iConsumes)
+    : ConditionHelper(iConsumes, edm::Transition::Event) {}
+
+ConditionHelper::ConditionHelper(edm::ConsumesCollector& iConsumes, edm::Transition iTransition)
+    : paramsToken_(es_consumes<L1TMuonEndCapParams, L1TMuonEndCapParamsRcd>(iConsumes, iTransition)),
+      forestToken_(es_consumes<L1TMuonEndCapForest, L1TMuonEndCapForestRcd>(iConsumes, iTransition)),
       paramsWatcher_(this, &ConditionHelper::watch_params),
       forestWatcher_(this, &ConditionHelper::watch_forest),
       params_(nullptr),
       forest_(nullptr) {}
 
-ConditionHelper::ConditionHelper(edm::ConsumesCollector& iConsumes)
-    : paramsToken_(iConsumes.esConsumes<L1TMuonEndCapParams, L1TMuonEndCapParamsRcd>()),
-      forestToken_(iConsumes.esConsumes<L1TMuonEndCapForest, L1TMuonEndCapForestRcd>()),
+ConditionHelper::ConditionHelper(const ConditionHelper& other)
+    : paramsToken_(other.paramsToken_),
+      forestToken_(other.forestToken_),
       paramsWatcher_(this, &ConditionHelper::watch_params),
       forestWatcher_(this, &ConditionHelper::watch_forest),
       params_(nullptr),
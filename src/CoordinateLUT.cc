@@ -0,0 +1,312 @@
+#include "L1Trigger/Phase2L1EMTF/interface/CoordinateLUT.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Geometry/CSCGeometry/interface/CSCGeometry.h"
+#include "Geometry/RPCGeometry/interface/RPCGeometry.h"
+#include "Geometry/GEMGeometry/interface/GEMGeometry.h"
+#include "Geometry/GEMGeometry/interface/ME0Geometry.h"
+
+#include "L1Trigger/CSCCommonTrigger/interface/CSCConstants.h"
+#include "L1Trigger/CSCCommonTrigger/interface/CSCPatternLUT.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/GeometryHelper.h"
+#include "L1Trigger/Phase2L1EMTF/interface/Toolbox.h"
+
+using namespace emtf::phase2;
+
+namespace {
+  constexpr int csc_num_endcaps = 2;
+  constexpr int csc_num_stations = 4;
+  constexpr int csc_num_rings = 4;  // including ME1/1a
+  constexpr int csc_num_chambers = 36;
+}  // namespace
+
+CoordinateLUT::CoordinateLUT(const GeometryHelper& geom_helper) {
+  build_csc(geom_helper.getCSCGeometry());
+  build_rpc(geom_helper.getRPCGeometry());
+  build_gem(geom_helper.getGEMGeometry());
+  build_me0(geom_helper.getME0Geometry());
+}
+
+CoordinateLUT::~CoordinateLUT() {}
+
+unsigned CoordinateLUT::get_csc_chamber_index(int endcap, int station, int ring, int chamber) {
+  return (((((endcap - 1) * csc_num_stations) + (station - 1)) * csc_num_rings + (ring - 1)) * csc_num_chambers) +
+         (chamber - 1);
+}
+
+void CoordinateLUT::build_csc(const CSCGeometry& detgeom) {
+  csc_chambers_.clear();
+  csc_chambers_.resize(csc_num_endcaps * csc_num_stations * csc_num_rings * csc_num_chambers);
+  csc_points_.clear();
+
+  for (int endcap = 1; endcap <= csc_num_endcaps; ++endcap) {
+    for (int station = 1; station <= csc_num_stations; ++station) {
+      for (int ring = 1; ring <= csc_num_rings; ++ring) {
+        const auto [max_strip, max_wire] = toolbox::get_csc_max_strip_and_wire(station, ring);
+        if (max_strip == 0)  // no such ring
+          continue;
+
+        for (int chamber = 1; chamber <= csc_num_chambers; ++chamber) {
+          const CSCChamber* chamb = detgeom.chamber(CSCDetId(endcap, station, ring, chamber, 0));
+          if (chamb == nullptr)  // no such chamber
+            continue;
+
+          // Same as SegmentFormatter::get_global_point()
+          const CSCLayer* layer = chamb->layer(CSCConstants::KEY_ALCT_LAYER);
+          const CSCLayerGeometry* layer_geom = layer->geometry();
+
+          auto is_counter_clockwise_fn = [&layer]() -> bool {
+            const float phi1 = layer->centerOfStrip(1).phi();
+            const float phi2 = layer->centerOfStrip(2).phi();
+            const float abs_diff = std::abs(phi1 - phi2);
+            return ((abs_diff < M_PI) and (phi1 >= phi2)) or ((abs_diff >= M_PI) and (phi1 < phi2));
+          };
+
+          // The offset halfstrip can go up to max_strip (inclusive) after the pattern correction
+          CSCChamberEntry& entry = csc_chambers_.at(get_csc_chamber_index(endcap, station, ring, chamber));
+          entry.offset = csc_points_.size();
+          entry.num_fullstrips = (max_strip >> 1) + 1;
+          entry.num_wires = max_wire;
+          entry.ccw = is_counter_clockwise_fn();
+          entry.hs_offset = layer_geom->stripPhiPitch() / 4.0;
+          entry.valid = true;
+
+          for (int istrip = 0; istrip < entry.num_fullstrips; ++istrip) {
+            for (int iwire = 0; iwire < entry.num_wires; ++iwire) {
+              const uint16_t fullstrip = istrip + 1;  // geom starts from 1
+              const uint16_t tp_wire = iwire;
+              const LocalPoint& coarse_lp = layer_geom->stripWireGroupIntersection(fullstrip, tp_wire);
+              const GlobalPoint& coarse_gp = layer->surface().toGlobal(coarse_lp);
+              csc_points_.push_back(PolarPoint{coarse_gp.theta(), coarse_gp.phi().value(), coarse_gp.mag()});
+            }
+          }
+        }  // end loop over chamber
+      }    // end loop over ring
+    }      // end loop over station
+  }        // end loop over endcap
+}
+
+void CoordinateLUT::build_rpc(const RPCGeometry& detgeom) {
+  rpc_rolls_.clear();
+  rpc_points_.clear();
+
+  for (const RPCRoll* roll : detgeom.rolls()) {
+    const RPCDetId& detid = roll->id();
+
+    // Identifier for barrel RPC
+    const bool is_barrel = (detid.region() == 0);
+    if (is_barrel)  // always rejected
+      continue;
+
+    // Identifier for iRPC (RE3/1, RE4/1)
+    const bool is_irpc = ((not is_barrel) and (detid.station() >= 3) and (detid.ring() == 1));
+
+    // (strip_lo + strip_hi) goes from 2 to (2 * nstrips)
+    RPCRollEntry& entry = rpc_rolls_[detid.rawId()];
+    entry.offset = rpc_points_.size();
+    entry.num_points = (2 * roll->nstrips()) - 1;
+    entry.roll = roll;
+    entry.is_irpc = is_irpc;
+
+    for (int ipoint = 0; ipoint < entry.num_points; ++ipoint) {
+      const int tp_strip_sum = ipoint + 2;
+
+      // Same as SegmentFormatter::get_global_point()
+      const float center_of_strip = -0.5f + (0.5f * tp_strip_sum);
+      const LocalPoint& lp_strip = roll->centreOfStrip(center_of_strip);
+      const GlobalPoint& gp_strip = roll->surface().toGlobal(lp_strip);
+      rpc_points_.push_back(PolarPoint{gp_strip.theta(), gp_strip.phi().value(), gp_strip.mag()});
+    }
+  }  // end loop over rolls
+}
+
+void CoordinateLUT::build_gem(const GEMGeometry& detgeom) {
+  gem_rolls_.clear();
+  gem_points_.clear();
+
+  for (const GEMEtaPartition* roll : detgeom.etaPartitions()) {
+    // (pad_lo + pad_hi) goes from 0 to (2 * (npads - 1))
+    GEMRollEntry& entry = gem_rolls_[roll->id().rawId()];
+    entry.offset = gem_points_.size();
+    entry.num_points = (2 * roll->npads()) - 1;
+
+    for (int ipoint = 0; ipoint < entry.num_points; ++ipoint) {
+      const int tp_pad_sum = ipoint;
+
+      // Same as SegmentFormatter::get_global_point()
+      const float center_of_pad = 0.5f + (0.5f * tp_pad_sum);
+      const LocalPoint& lp = roll->centreOfPad(center_of_pad);
+      const GlobalPoint& gp = roll->surface().toGlobal(lp);
+      gem_points_.push_back(CartesianPoint{gp.x(), gp.y(), gp.z()});
+    }
+  }  // end loop over rolls
+}
+
+void CoordinateLUT::build_me0(const ME0Geometry& detgeom) {
+  me0_chambers_.clear();
+  me0_points_.clear();
+
+  for (const ME0Chamber* chamb : detgeom.chambers()) {
+    const ME0Layer* layer = chamb->layer(CSCConstants::KEY_ALCT_LAYER);
+    if (layer == nullptr)
+      continue;
+
+    // The roll numbers are not assumed to be contiguous, and the num of strips can differ
+    int num_rolls = 0;
+    int num_phipositions = 0;
+    for (const ME0EtaPartition* roll : layer->etaPartitions()) {
+      if (roll == nullptr)
+        continue;
+      num_rolls = std::max(num_rolls, roll->id().roll());
+      num_phipositions = std::max(num_phipositions, 2 * roll->nstrips());
+    }
+    if (num_rolls == 0)
+      continue;
+
+    ME0ChamberEntry& entry = me0_chambers_[chamb->id().chamberId().rawId()];
+    entry.offset = me0_points_.size();
+    entry.num_rolls = num_rolls;
+    entry.num_phipositions = num_phipositions;
+    entry.roll_num_phipositions.assign(num_rolls, 0);
+    me0_points_.resize(me0_points_.size() + (num_rolls * num_phipositions), CartesianPoint{0., 0., 0.});
+
+    for (const ME0EtaPartition* roll : layer->etaPartitions()) {
+      if (roll == nullptr)
+        continue;
+
+      const int iroll = roll->id().roll() - 1;  // geom starts from 1
+      if (iroll < 0)
+        continue;
+
+      entry.roll_num_phipositions[iroll] = 2 * roll->nstrips();
+
+      for (int tp_phiposition = 0; tp_phiposition < entry.roll_num_phipositions[iroll]; ++tp_phiposition) {
+        // Same as SegmentFormatter::get_global_point()
+        const float center_of_strip = 0.25f + (0.5f * tp_phiposition);
+        const LocalPoint& lp = roll->centreOfStrip(center_of_strip);
+        const GlobalPoint& gp = roll->surface().toGlobal(lp);
+        me0_points_[entry.offset + (iroll * entry.num_phipositions) + tp_phiposition] =
+            CartesianPoint{gp.x(), gp.y(), gp.z()};
+      }
+    }
+  }  // end loop over chambers
+}
+
+bool CoordinateLUT::get_global_point(const csc_subsystem_tag::detid_type& detid,
+                                     const csc_subsystem_tag::digi_type& digi,
+                                     GlobalPoint& gp) const {
+  const int endcap = detid.endcap();
+  const int station = detid.station();
+  const int ring = detid.ring();
+  const int chamber = detid.chamber();
+
+  if (not((1 <= endcap) and (endcap <= csc_num_endcaps) and (1 <= station) and (station <= csc_num_stations) and
+          (1 <= ring) and (ring <= csc_num_rings) and (1 <= chamber) and (chamber <= csc_num_chambers)))
+    return false;
+
+  const CSCChamberEntry& entry = csc_chambers_[get_csc_chamber_index(endcap, station, ring, chamber)];
+  if (not entry.valid)
+    return false;
+
+  // Local coordinates
+  const uint16_t tp_strip = digi.getStrip();  // halfstrip
+  const uint16_t tp_wire = digi.getKeyWG();   // wiregroup
+  const uint16_t tp_pattern = digi.getPattern();
+
+  // assume TMB2007 half-strips only as baseline
+  const float offset = CSCPatternLUT::get2007Position(tp_pattern);
+  const uint16_t halfstrip_offs = static_cast<uint16_t>(0.5f + tp_strip + offset);
+  const int istrip = (halfstrip_offs >> 1);
+
+  if (not((istrip < entry.num_fullstrips) and (tp_wire < entry.num_wires)))
+    return false;
+
+  const PolarPoint& coarse = csc_points_[entry.offset + (istrip * entry.num_wires) + tp_wire];
+
+  // we need to subtract the offset of even half strips and add the odd ones
+  const float hs_offset = entry.hs_offset;
+  const float phi_offset = ((halfstrip_offs % 2) ? 1 : -1) * (entry.ccw ? -hs_offset : hs_offset);
+
+  gp = GlobalPoint(GlobalPoint::Polar(coarse.theta, (coarse.phi + phi_offset), coarse.mag));
+  return true;
+}
+
+bool CoordinateLUT::get_global_point(const rpc_subsystem_tag::detid_type& detid,
+                                     const rpc_subsystem_tag::digi_type& digi,
+                                     GlobalPoint& gp) const {
+  auto found = rpc_rolls_.find(detid.rawId());
+  if (found == rpc_rolls_.end())
+    return false;
+
+  const RPCRollEntry& entry = found->second;
+
+  // Local coordinates
+  const int tp_clus_width = digi.clusterSize();  // strip_hi - strip_lo + 1
+  const int tp_strip_lo = digi.firstClusterStrip();
+  const int tp_strip_hi = tp_strip_lo + tp_clus_width - 1;
+  const int ipoint = (tp_strip_lo + tp_strip_hi) - 2;
+
+  if (not((0 <= ipoint) and (ipoint < entry.num_points)))
+    return false;
+
+  const PolarPoint& p_strip = rpc_points_[entry.offset + ipoint];
+
+  // For iRPC, theta is taken from localPosition()
+  if (entry.is_irpc) {
+    const LocalPoint& lp = digi.localPosition();
+    const GlobalPoint& gp_irpc = entry.roll->surface().toGlobal(lp);
+    gp = GlobalPoint(GlobalPoint::Polar(gp_irpc.theta(), p_strip.phi, p_strip.mag));
+  } else {
+    gp = GlobalPoint(GlobalPoint::Polar(p_strip.theta, p_strip.phi, p_strip.mag));
+  }
+  return true;
+}
+
+bool CoordinateLUT::get_global_point(const gem_subsystem_tag::detid_type& detid,
+                                     const gem_subsystem_tag::digi_type& digi,
+                                     GlobalPoint& gp) const {
+  auto found = gem_rolls_.find(detid.rawId());
+  if (found == gem_rolls_.end())
+    return false;
+
+  const GEMRollEntry& entry = found->second;
+
+  // Local coordinates
+  const uint16_t tp_pad_lo = digi.pads().front();
+  const uint16_t tp_pad_hi = digi.pads().back();
+  const int ipoint = (tp_pad_lo + tp_pad_hi);
+
+  if (not(ipoint < entry.num_points))
+    return false;
+
+  const CartesianPoint& p = gem_points_[entry.offset + ipoint];
+  gp = GlobalPoint(p.x, p.y, p.z);
+  return true;
+}
+
+bool CoordinateLUT::get_global_point(const me0_subsystem_tag::detid_type& detid,
+                                     const me0_subsystem_tag::digi_type& digi,
+                                     GlobalPoint& gp) const {
+  auto found = me0_chambers_.find(detid.chamberId().rawId());
+  if (found == me0_chambers_.end())
+    return false;
+
+  const ME0ChamberEntry& entry = found->second;
+
+  // Local coordinates
+  const int tp_phiposition = digi.getPhiposition();  // in half-strip unit
+  const int tp_partition = digi.getPartition();      // in half-roll unit
+  const int iroll = (tp_partition >> 1);             // starts from 0 here
+
+  // Missing rolls have no valid phiposition
+  if (not((0 <= iroll) and (iroll < entry.num_rolls) and (0 <= tp_phiposition) and
+          (tp_phiposition < entry.roll_num_phipositions[iroll])))
+    return false;
+
+  const CartesianPoint& p = me0_points_[entry.offset + (iroll * entry.num_phipositions) + tp_phiposition];
+  gp = GlobalPoint(p.x, p.y, p.z);
+  return true;
+}
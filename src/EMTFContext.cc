@@ -1,10 +1,50 @@
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFContext.h"
 
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/CoordinateLUT.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFModel.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFProfiler.h"
+#include "L1Trigger/Phase2L1EMTF/interface/GeometryHelper.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SectorTensorFile.h"
 #include "L1Trigger/Phase2L1EMTF/interface/VersionControl.h"
 
 using namespace emtf::phase2;
 
 EMTFContext::EMTFContext(const edm::ParameterSet& iConfig)
-    : pset_(iConfig), version_control_(std::make_unique<VersionControl>()) {}
+    : pset_(iConfig),
+      version_control_(std::make_unique<VersionControl>()),
+      model_(std::make_unique<EMTFModel>()),
+      coord_lut_(nullptr),
+      coord_lut_cache_id_(0) {
+  // Persist the model input/output tensors if requested
+  const std::string& tensor_fname = iConfig.getUntrackedParameter<std::string>("tensorFileName", "");
+  if (not tensor_fname.empty()) {
+    tensor_writer_ = std::make_unique<SectorTensorWriter>(tensor_fname,
+                                                          model_->version(),
+                                                          model_->get_input_shape().num_elements(),
+                                                          model_->get_output_shape().num_elements());
+    if (not tensor_writer_->is_open()) {
+      throw cms::Exception("Configuration") << "Cannot open tensorFileName: " << tensor_fname;
+    }
+  }
+
+  // Collect timers and counters if requested
+  if (iConfig.getUntrackedParameter<bool>("instrumentation", false)) {
+    profiler_ = std::make_unique<EMTFProfiler>();
+  }
+}
 
 EMTFContext::~EMTFContext() {}
+
+std::shared_ptr<const CoordinateLUT> EMTFContext::get_coordinate_lut(const GeometryHelper& geom_helper) const {
+  std::lock_guard<std::mutex> guard(coord_lut_mutex_);
+
+  // Rebuild if the geometry has changed
+  const unsigned long long cache_id = geom_helper.getMuonGeometryCacheId();
+  if ((coord_lut_ == nullptr) or (coord_lut_cache_id_ != cache_id)) {
+    coord_lut_ = std::make_shared<const CoordinateLUT>(geom_helper);
+    coord_lut_cache_id_ = cache_id;
+  }
+  return coord_lut_;
+}
@@ -1,8 +1,14 @@
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFModel.h"
 
+#ifdef EMTF_HLSLIB_NATIVE_TYPES
+// CPU implementation with native integers
+#include "emtf_hlslib/native_ap_int.h"
+#include "emtf_hlslib/native_ap_fixed.h"
+#else
 // Xilinx HLS
 #include "ap_int.h"
 #include "ap_fixed.h"
+#endif  // EMTF_HLSLIB_NATIVE_TYPES defined
 
 // EMTF HLS
 #include "emtf_hlslib.h"
@@ -31,6 +37,13 @@ NdArrayDesc EMTFModel::get_output_shape() const {
   return NdArrayDesc{};
 }
 
+int EMTFModel::get_num_chambers() const {
+  if (version_ == 3) {
+    return num_emtf_chambers_v3;
+  }
+  return 0;
+}
+
 int EMTFModel::get_num_segments() const {
   if (version_ == 3) {
     return num_emtf_segments_v3;
@@ -45,7 +58,7 @@ int EMTFModel::get_num_tracks() const {
   return 0;
 }
 
-void EMTFModel::fit_impl_v3(const Vector& in0, Vector& out) const {
+void EMTFModel::fit_impl_v3(const int* in0, int* out) const {
   // Check consistency with the parameters from namespace emtf_hlslib
   static_assert(EMTFModel::num_emtf_chambers_v3 == emtf_hlslib::phase2::num_emtf_chambers);
   static_assert(EMTFModel::num_emtf_segments_v3 == emtf_hlslib::phase2::num_emtf_segments);
@@ -54,6 +67,11 @@ void EMTFModel::fit_impl_v3(const Vector& in0, Vector& out) const {
   static_assert(EMTFModel::num_emtf_trk_variables_v3 ==
                 (emtf_hlslib::phase2::num_emtf_features + emtf_hlslib::phase2::num_emtf_sites + 2));
 
+  // Check the upper bounds
+  static_assert(EMTFModel::num_emtf_chambers_v3 <= EMTFModel::max_num_chambers);
+  static_assert((num_emtf_chambers_v3 * num_emtf_segments_v3 * num_emtf_variables_v3) <= EMTFModel::max_input_size);
+  static_assert((num_emtf_tracks_v3 * num_emtf_trk_variables_v3) <= EMTFModel::max_output_size);
+
   using namespace emtf_hlslib::phase2;
 
   // Unpack from in0
@@ -74,7 +92,7 @@ void EMTFModel::fit_impl_v3(const Vector& in0, Vector& out) const {
   seg_valid_t seg_valid[model_config::n_in];
 
   // Loop over in0
-  auto in0_iter = in0.begin();
+  auto in0_iter = in0;
 
   for (unsigned iseg = 0; iseg < model_config::n_in; iseg++) {
     emtf_phi[iseg] = *(in0_iter++);
@@ -93,9 +111,10 @@ void EMTFModel::fit_impl_v3(const Vector& in0, Vector& out) const {
   }  // end loop over in0
 
   // Intermediate arrays (for layers 0..3)
-  zoning_out_t zoning_0_out[zoning_config::n_out];
-  zoning_out_t zoning_1_out[zoning_config::n_out];
-  zoning_out_t zoning_2_out[zoning_config::n_out];
+  // Note: the zone images are kept as word bitsets, see zoning_bitset.h
+  zoning_bitset_row_t zoning_0_out[zoning_config::n_out];
+  zoning_bitset_row_t zoning_1_out[zoning_config::n_out];
+  zoning_bitset_row_t zoning_2_out[zoning_config::n_out];
   pooling_out_t pooling_0_out[pooling_config::n_out];
   pooling_out_t pooling_1_out[pooling_config::n_out];
   pooling_out_t pooling_2_out[pooling_config::n_out];
@@ -105,14 +124,17 @@ void EMTFModel::fit_impl_v3(const Vector& in0, Vector& out) const {
   zonemerging_out_t zonemerging_0_out[zonemerging_config::n_out];
 
   // Layer 0 - Zoning
+  // Use the word-parallel implementation, which gives the same images as zoning_layer
 
-  zoning_layer<m_zone_any_tag>(emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_0_out, zoning_1_out, zoning_2_out);
+  zoning_bitset_layer<m_zone_any_tag>(
+      emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_0_out, zoning_1_out, zoning_2_out);
 
   // Layer 1 - Pooling
+  // Use the word-parallel implementation, which gives the same output as pooling_layer
 
-  pooling_layer<m_zone_0_tag>(zoning_0_out, pooling_0_out);
-  pooling_layer<m_zone_1_tag>(zoning_1_out, pooling_1_out);
-  pooling_layer<m_zone_2_tag>(zoning_2_out, pooling_2_out);
+  pooling_bitset_layer<m_zone_0_tag>(zoning_0_out, pooling_0_out);
+  pooling_bitset_layer<m_zone_1_tag>(zoning_1_out, pooling_1_out);
+  pooling_bitset_layer<m_zone_2_tag>(zoning_2_out, pooling_2_out);
 
   // Layer 2 - Zone sorting
 
@@ -242,7 +264,7 @@ void EMTFModel::fit_impl_v3(const Vector& in0, Vector& out) const {
   }  // end loop over tracks
 
   // Copy to output: trk_feat_rm, trk_seg_rm, trk_valid_rm, trk_invpt
-  auto out_iter = out.begin();
+  auto out_iter = out;
 
   for (unsigned i = 0; i < model_config::n_out; i++) {
     const unsigned itrk = (i / model_config::n_out_per_trk);
@@ -0,0 +1,90 @@
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFPackedHit.h"
+
+#include <algorithm>
+
+using namespace emtf::phase2;
+
+EMTFPackedHit::EMTFPackedHit(const EMTFHit& hit) : words_{} {
+  // Segment word
+  set(kEmtfPhi, hit.emtfPhi());
+  set(kEmtfBend, hit.emtfBend());
+  set(kEmtfTheta1, hit.emtfTheta1());
+  set(kEmtfTheta2, hit.emtfTheta2());
+  set(kEmtfQual1, hit.emtfQual1());
+  set(kEmtfQual2, hit.emtfQual2());
+  set(kEmtfTime, hit.emtfTime());
+  set(kZones, hit.zones());
+  set(kTimezones, hit.timezones());
+  set(kValid, hit.valid());
+  set(kNeighbor, hit.neighbor());
+  set(kCscfr, hit.cscfr());
+  set(kGemdl, hit.gemdl());
+
+  // Location word
+  set(kEmtfChamber, hit.emtfChamber());
+  set(kEmtfSegment, hit.emtfSegment());
+  set(kEmtfSite, hit.emtfSite());
+  set(kEmtfHost, hit.emtfHost());
+  set(kEndcap, (hit.endcap() == 1));
+  set(kSector, hit.sector());
+  set(kBx, hit.bx());
+  set(kSubsystem, hit.subsystem());
+  set(kStation, hit.station());
+  set(kRing, hit.ring());
+  set(kChamber, hit.chamber());
+  set(kSubsector, hit.subsector());
+  set(kCscid, hit.cscid());
+}
+
+EMTFHit EMTFPackedHit::to_hit() const {
+  EMTFHit hit;
+
+  hit.setEmtfPhi(emtfPhi());
+  hit.setEmtfBend(emtfBend());
+  hit.setEmtfTheta1(emtfTheta1());
+  hit.setEmtfTheta2(emtfTheta2());
+  hit.setEmtfQual1(emtfQual1());
+  hit.setEmtfQual2(emtfQual2());
+  hit.setEmtfTime(emtfTime());
+  hit.setZones(zones());
+  hit.setTimezones(timezones());
+  hit.setValid(valid());
+  hit.setNeighbor(neighbor());
+  hit.setCscfr(cscfr());
+  hit.setGemdl(gemdl());
+
+  hit.setEmtfChamber(emtfChamber());
+  hit.setEmtfSegment(emtfSegment());
+  hit.setEmtfSite(emtfSite());
+  hit.setEmtfHost(emtfHost());
+  hit.setEndcap(endcap());
+  hit.setSector(sector());
+  hit.setBx(bx());
+  hit.setSubsystem(subsystem());
+  hit.setStation(station());
+  hit.setRing(ring());
+  hit.setChamber(chamber());
+  hit.setSubsector(subsector());
+  hit.setCscid(cscid());
+  return hit;
+}
+
+void EMTFPackedHit::set(const Field& f, int value) {
+  // Saturate to the range of the field
+  const int lo = f.is_signed ? -(1 << (f.width - 1)) : 0;
+  const int hi = f.is_signed ? ((1 << (f.width - 1)) - 1) : ((1 << f.width) - 1);
+  value = std::clamp(value, lo, hi);
+
+  const word_t mask = (word_t(1) << f.width) - 1;
+  words_[f.word] &= ~(mask << f.shift);
+  words_[f.word] |= ((static_cast<word_t>(value) & mask) << f.shift);
+}
+
+// _____________________________________________________________________________
+void emtf::phase2::pack_hits(const EMTFHitCollection& hits, EMTFPackedHitCollection& packed_hits) {
+  packed_hits.clear();
+  packed_hits.reserve(hits.size());
+  for (const auto& hit : hits) {
+    packed_hits.emplace_back(hit);
+  }
+}
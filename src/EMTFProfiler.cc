@@ -0,0 +1,110 @@
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFProfiler.h"
+
+#include <iomanip>
+
+using namespace emtf::phase2;
+
+namespace {
+  const char* const timer_names[EMTFProfiler::kNumTimers] = {"collection", "routing", "step 1", "step 2"};
+
+  const char* const counter_names[EMTFProfiler::kNumCounters] = {"events",
+                                                                 "CSC primitives",
+                                                                 "RPC primitives",
+                                                                 "GEM primitives",
+                                                                 "ME0 primitives",
+                                                                 "sectors",
+                                                                 "hits",
+                                                                 "dropped segments",
+                                                                 "fits",
+                                                                 "tracks"};
+}  // namespace
+
+void EMTFProfiler::Stats::add(const Stats& other) {
+  for (int i = 0; i < kNumTimers; ++i) {
+    time_ns[i] += other.time_ns[i];
+    calls[i] += other.calls[i];
+  }
+  for (int i = 0; i < kNumCounters; ++i) {
+    counts[i] += other.counts[i];
+  }
+  max_hits_per_sector = (other.max_hits_per_sector > max_hits_per_sector) ? other.max_hits_per_sector
+                                                                            : max_hits_per_sector;
+}
+
+// _____________________________________________________________________________
+EMTFProfiler::EMTFProfiler() : max_hits_per_sector_(0) {
+  for (int i = 0; i < kNumTimers; ++i) {
+    time_ns_[i] = 0;
+    calls_[i] = 0;
+  }
+  for (int i = 0; i < kNumCounters; ++i) {
+    counts_[i] = 0;
+  }
+}
+
+EMTFProfiler::~EMTFProfiler() {}
+
+void EMTFProfiler::merge(const Stats& stats) {
+  for (int i = 0; i < kNumTimers; ++i) {
+    time_ns_[i].fetch_add(stats.time_ns[i], std::memory_order_relaxed);
+    calls_[i].fetch_add(stats.calls[i], std::memory_order_relaxed);
+  }
+  for (int i = 0; i < kNumCounters; ++i) {
+    counts_[i].fetch_add(stats.counts[i], std::memory_order_relaxed);
+  }
+
+  // Atomic max
+  uint64_t curr_max = max_hits_per_sector_.load(std::memory_order_relaxed);
+  while ((stats.max_hits_per_sector > curr_max) and
+         not max_hits_per_sector_.compare_exchange_weak(
+             curr_max, stats.max_hits_per_sector, std::memory_order_relaxed)) {
+  }
+}
+
+EMTFProfiler::Stats EMTFProfiler::get_summary() const {
+  Stats summary;
+  for (int i = 0; i < kNumTimers; ++i) {
+    summary.time_ns[i] = time_ns_[i].load(std::memory_order_relaxed);
+    summary.calls[i] = calls_[i].load(std::memory_order_relaxed);
+  }
+  for (int i = 0; i < kNumCounters; ++i) {
+    summary.counts[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+  summary.max_hits_per_sector = max_hits_per_sector_.load(std::memory_order_relaxed);
+  return summary;
+}
+
+void EMTFProfiler::print_summary(std::ostream& os) const {
+  const Stats& summary = get_summary();
+  const uint64_t num_events = summary.counts[kEvents];
+  const double norm = (num_events > 0) ? (1.0 / num_events) : 0.;
+
+  const auto flags = os.flags();
+  os << std::fixed << std::setprecision(3);
+
+  os << "EMTF instrumentation summary (" << num_events << " events)" << std::endl;
+  os << std::left << std::setw(20) << "Timer" << std::right << std::setw(14) << "calls" << std::setw(14)
+     << "total [ms]" << std::setw(18) << "per event [us]" << std::setw(16) << "per call [us]" << std::endl;
+
+  for (int i = 0; i < kNumTimers; ++i) {
+    const double total_us = summary.time_ns[i] * 1e-3;
+    const double per_call_us = (summary.calls[i] > 0) ? (total_us / summary.calls[i]) : 0.;
+    os << std::left << std::setw(20) << timer_names[i] << std::right << std::setw(14) << summary.calls[i]
+       << std::setw(14) << (total_us * 1e-3) << std::setw(18) << (total_us * norm) << std::setw(16) << per_call_us
+       << std::endl;
+  }
+
+  os << std::left << std::setw(20) << "Counter" << std::right << std::setw(14) << "total" << std::setw(14) << ""
+     << std::setw(18) << "per event" << std::endl;
+
+  for (int i = 0; i < kNumCounters; ++i) {
+    os << std::left << std::setw(20) << counter_names[i] << std::right << std::setw(14) << summary.counts[i]
+       << std::setw(14) << "" << std::setw(18) << (summary.counts[i] * norm) << std::endl;
+  }
+
+  const uint64_t num_sectors = summary.counts[kSectors];
+  os << "hits per sector: mean " << ((num_sectors > 0) ? (double(summary.counts[kHits]) / num_sectors) : 0.)
+     << ", max " << summary.max_hits_per_sector << std::endl;
+
+  os.flags(flags);
+}
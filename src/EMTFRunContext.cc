@@ -0,0 +1,26 @@
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFRunContext.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFContext.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFWorker.h"
+#include "L1Trigger/Phase2L1EMTF/interface/GeometryHelper.h"
+#include "L1Trigger/Phase2L1EMTF/interface/ConditionHelper.h"
+
+using namespace emtf::phase2;
+
+EMTFRunContext::EMTFRunContext(const EMTFWorker& iWorker)
+    : useCoordinateLUT_(iWorker.useCoordinateLUT_),
+      geom_helper_(std::make_unique<GeometryHelper>(*iWorker.geom_helper_)),
+      cond_helper_(std::make_unique<ConditionHelper>(*iWorker.cond_helper_)) {}
+
+EMTFRunContext::~EMTFRunContext() {}
+
+void EMTFRunContext::before_run(const EMTFContext& iContext, const edm::EventSetup& iSetup) {
+  // Check and update based on EventSetup data
+  const bool geom_changed = geom_helper_->check(iSetup);
+  cond_helper_->check(iSetup);
+
+  // The tables are reused across runs if the geometry has not changed
+  if (geom_changed and useCoordinateLUT_) {
+    geom_helper_->setCoordinateLUT(iContext.get_coordinate_lut(*geom_helper_));
+  }
+}
@@ -0,0 +1,20 @@
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFScratch.h"
+
+using namespace emtf::phase2;
+
+void EMTFScratch::Sector::reset() {
+  out_hits.clear();
+  out_tracks.clear();
+  out_tensors.clear();
+  stats = EMTFProfiler::Stats{};
+}
+
+// _____________________________________________________________________________
+EMTFScratch::EMTFScratch(int min_bx, int max_bx) : router(min_bx, max_bx) {}
+
+EMTFScratch::~EMTFScratch() {}
+
+void EMTFScratch::reset() {
+  muon_primitives.clear();
+  out_tensors.clear();
+}
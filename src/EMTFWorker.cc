@@ -1,21 +1,36 @@
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFWorker.h"
 
+#include <algorithm>  // provides std::min, std::max
+#include <array>
+#include <iterator>  // provides std::make_move_iterator
+
+#include "tbb/parallel_for.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/ChamberIndex.h"
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFContext.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFRunContext.h"
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFModel.h"
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFScratch.h"
 #include "L1Trigger/Phase2L1EMTF/interface/GeometryHelper.h"
 #include "L1Trigger/Phase2L1EMTF/interface/ConditionHelper.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SectorProcessor.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SectorTensorFile.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SubsystemTags.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SubsystemCollection.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SubsystemCollector.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemRouter.h"
 
 using namespace emtf::phase2;
 
-EMTFWorker::EMTFWorker(const edm::ParameterSet& iConfig, edm::ConsumesCollector&& iConsumes)
+EMTFWorker::EMTFWorker(const EMTFContext& iContext,
+                       const edm::ParameterSet& iConfig,
+                       edm::ConsumesCollector&& iConsumes,
+                       edm::Transition iTransition)
     : pset_(iConfig),
-      model_(std::make_unique<EMTFModel>()),
-      geom_helper_(std::make_unique<GeometryHelper>(iConsumes)),
-      cond_helper_(std::make_unique<ConditionHelper>(iConsumes)),
+      model_(iContext.model_.get()),
+      tensor_writer_(iContext.tensor_writer_.get()),
+      geom_helper_(std::make_unique<GeometryHelper>(iConsumes, iTransition)),
+      cond_helper_(std::make_unique<ConditionHelper>(iConsumes, iTransition)),
       cscToken_(
           iConsumes.consumes<csc_subsystem_tag::collection_type>(iConfig.getParameter<edm::InputTag>("cscLabel"))),
       rpcToken_(
@@ -30,41 +45,217 @@ EMTFWorker::EMTFWorker(const edm::ParameterSet& iConfig, edm::ConsumesCollector&
       me0Enable_(iConfig.getParameter<bool>("me0Enable")),
       minBX_(iConfig.getParameter<int>("minBX")),
       maxBX_(iConfig.getParameter<int>("maxBX")),
+      minTrackBX_(iConfig.getParameter<int>("minTrackBX")),
+      maxTrackBX_(iConfig.getParameter<int>("maxTrackBX")),
+      minConvBX_(std::min(minBX_, minTrackBX_)),
+      maxConvBX_(std::max(maxBX_, maxTrackBX_)),
       bxWindow_(iConfig.getParameter<int>("bxWindow")),
+      parallelSectors_(iConfig.getParameter<bool>("parallelSectors")),
+      useCoordinateLUT_(iConfig.getParameter<bool>("useCoordinateLUT")),
       verbose_(iConfig.getUntrackedParameter<int>("verbosity", 0)) {}
 
 EMTFWorker::~EMTFWorker() {}
 
+void EMTFWorker::fill_description(edm::ParameterSetDescription& desc) {
+  desc.add<edm::InputTag>("cscLabel", edm::InputTag("simCscTriggerPrimitiveDigisForEMTF", "MPCSORTED"));
+  desc.add<edm::InputTag>("rpcLabel", edm::InputTag("rpcRecHitsForEMTF"));
+  desc.add<edm::InputTag>("gemLabel", edm::InputTag("simMuonGEMPadDigiClusters"));
+  desc.add<edm::InputTag>("me0Label", edm::InputTag("me0TriggerConvertedPseudoDigis"));
+  desc.add<bool>("cscEnable", true);
+  desc.add<bool>("rpcEnable", true);
+  desc.add<bool>("gemEnable", true);
+  desc.add<bool>("me0Enable", true);
+  desc.add<int>("minBX", -2);
+  desc.add<int>("maxBX", 2);
+  desc.add<int>("minTrackBX", 0);
+  desc.add<int>("maxTrackBX", 0);
+  desc.add<int>("bxWindow", 1);
+  desc.add<bool>("parallelSectors", false);
+  desc.add<bool>("useCoordinateLUT", true);
+  desc.addUntracked<std::string>("tensorFileName", "");
+  desc.addUntracked<bool>("instrumentation", false);
+  desc.addUntracked<int>("verbosity", 0);
+}
+
+std::unique_ptr<EMTFScratch> EMTFWorker::make_scratch() const {
+  return std::make_unique<EMTFScratch>(minConvBX_, maxConvBX_);
+}
+
 void EMTFWorker::before_process(const EMTFContext& iContext, const edm::EventSetup& iSetup) {
+  // The worker belongs to a single stream, so it can hold the scratch buffers
+  if (scratch_ == nullptr) {
+    scratch_ = make_scratch();
+  }
+
   // Check and update based on EventSetup data
-  geom_helper_->check(iSetup);
+  const bool geom_changed = geom_helper_->check(iSetup);
   cond_helper_->check(iSetup);
+
+  // The tables are shared with the other workers through the context
+  if (geom_changed and useCoordinateLUT_) {
+    geom_helper_->setCoordinateLUT(iContext.get_coordinate_lut(*geom_helper_));
+  }
 }
 
-void EMTFWorker::process(const edm::Event& iEvent, EMTFHitCollection& out_hits, EMTFTrackCollection& out_tracks) const {
+void EMTFWorker::process(const edm::Event& iEvent,
+                         EMTFHitCollection& out_hits,
+                         EMTFTrackCollection& out_tracks,
+                         EMTFProfiler::Stats* stats) const {
+  emtf_assert(scratch_ != nullptr);  // before_process() must be called first
+  process_impl(iEvent, *geom_helper_, *scratch_, out_hits, out_tracks, stats);
+}
+
+void EMTFWorker::process(const edm::Event& iEvent,
+                         const EMTFRunContext& iRunContext,
+                         EMTFScratch& scratch,
+                         EMTFHitCollection& out_hits,
+                         EMTFTrackCollection& out_tracks,
+                         EMTFProfiler::Stats* stats) const {
+  process_impl(iEvent, *iRunContext.geom_helper_, scratch, out_hits, out_tracks, stats);
+}
+
+void EMTFWorker::process_impl(const edm::Event& iEvent,
+                              const GeometryHelper& geom_helper,
+                              EMTFScratch& scratch,
+                              EMTFHitCollection& out_hits,
+                              EMTFTrackCollection& out_tracks,
+                              EMTFProfiler::Stats* stats) const {
+  if (stats != nullptr) {
+    stats->count(EMTFProfiler::kEvents);
+  }
+
+  // The buffers keep their capacity from the previous events
+  scratch.reset();
+
   // Extract trigger primitives
   SubsystemCollector collector;
-  SubsystemCollection muon_primitives;
+  SubsystemCollection& muon_primitives = scratch.muon_primitives;
 
-  if (cscEnable_) {
-    collector.collect<csc_subsystem_tag>(iEvent, cscToken_, muon_primitives);
-  }
-  if (rpcEnable_) {
-    collector.collect<rpc_subsystem_tag>(iEvent, rpcToken_, muon_primitives);
-  }
-  if (gemEnable_) {
-    collector.collect<gem_subsystem_tag>(iEvent, gemToken_, muon_primitives);
+  {
+    EMTFProfiler::ScopedTimer timer(stats, EMTFProfiler::kCollection);
+
+    // Count the primitives added by each subsystem
+    auto collect_fn = [&](auto tag, const edm::EDGetToken& token, EMTFProfiler::Counter counter) {
+      const auto size_before = muon_primitives.size();
+      collector.collect<decltype(tag)>(iEvent, token, muon_primitives);
+      if (stats != nullptr) {
+        stats->count(counter, muon_primitives.size() - size_before);
+      }
+    };
+
+    if (cscEnable_) {
+      collect_fn(csc_subsystem_tag{}, cscToken_, EMTFProfiler::kCSCPrimitives);
+    }
+    if (rpcEnable_) {
+      collect_fn(rpc_subsystem_tag{}, rpcToken_, EMTFProfiler::kRPCPrimitives);
+    }
+    if (gemEnable_) {
+      collect_fn(gem_subsystem_tag{}, gemToken_, EMTFProfiler::kGEMPrimitives);
+    }
+    if (me0Enable_) {
+      collect_fn(me0_subsystem_tag{}, me0Token_, EMTFProfiler::kME0Primitives);
+    }
   }
-  if (me0Enable_) {
-    collector.collect<me0_subsystem_tag>(iEvent, me0Token_, muon_primitives);
+
+  // Sort the primitives into (endcap, sector, bx) buckets in one pass, and index the chamber-level
+  // information that is shared by all the sectors
+  SubsystemRouter& router = scratch.router;
+  ChamberIndex& chamber_index = scratch.chamber_index;
+  {
+    EMTFProfiler::ScopedTimer timer(stats, EMTFProfiler::kRouting);
+    router.route(muon_primitives);
+    chamber_index.build(muon_primitives);
   }
 
   // Run the sector processors
-  for (int endcap = MIN_ENDCAP; endcap <= MAX_ENDCAP; ++endcap) {
-    for (int sector = MIN_TRIGSECTOR; sector <= MAX_TRIGSECTOR; ++sector) {
-      SectorProcessor processor;
-      const edm::EventID& evt_id = iEvent.id();
-      processor.process(*this, endcap, sector, evt_id, muon_primitives, out_hits, out_tracks);
+  const edm::EventID& evt_id = iEvent.id();
+
+  // Model input/output tensors, only kept if they are written out
+  SectorTensorBuffer* out_tensors_ptr = (tensor_writer_ != nullptr) ? &scratch.out_tensors : nullptr;
+
+#ifdef EMTF_DUMP_INFO
+  // The debugging dump expects the output of all the previous sectors, so run serially
+  const bool run_parallel = false;
+#else
+  const bool run_parallel = parallelSectors_;
+#endif  // EMTF_DUMP_INFO is defined
+
+  constexpr int num_sectors_per_endcap = NUM_TRIGSECTORS / 2;
+
+  if (not run_parallel) {
+    for (int endcap = MIN_ENDCAP; endcap <= MAX_ENDCAP; ++endcap) {
+      for (int sector = MIN_TRIGSECTOR; sector <= MAX_TRIGSECTOR; ++sector) {
+        const int isector = ((endcap - MIN_ENDCAP) * num_sectors_per_endcap) + (sector - MIN_TRIGSECTOR);
+        SectorProcessor processor;
+        processor.process(*this,
+                          geom_helper,
+                          endcap,
+                          sector,
+                          evt_id,
+                          muon_primitives,
+                          router,
+                          chamber_index,
+                          scratch.sectors[isector],
+                          out_hits,
+                          out_tracks,
+                          out_tensors_ptr,
+                          stats);
+      }
     }
+    write_tensors(evt_id, out_tensors_ptr);
+    return;
   }
+
+  // Run each sector as an independent task. Each sector writes to its own buffers, which are
+  // merged afterwards in the same (endcap, sector) order as the serial loop.
+  // EMTFModel::fit() is called from several tasks at once. This is only safe because the hlslib
+  // lookup tables are filled at static initialization (see layer_helpers.h), and not on the first
+  // call. A table that is filled lazily in a function-local static must not be added back.
+  tbb::parallel_for(0, NUM_TRIGSECTORS, [&](int isector) {
+    const int endcap = MIN_ENDCAP + (isector / num_sectors_per_endcap);
+    const int sector = MIN_TRIGSECTOR + (isector % num_sectors_per_endcap);
+    EMTFScratch::Sector& sector_scratch = scratch.sectors[isector];
+    sector_scratch.reset();
+    SectorProcessor processor;
+    processor.process(*this,
+                      geom_helper,
+                      endcap,
+                      sector,
+                      evt_id,
+                      muon_primitives,
+                      router,
+                      chamber_index,
+                      sector_scratch,
+                      sector_scratch.out_hits,
+                      sector_scratch.out_tracks,
+                      (out_tensors_ptr != nullptr) ? &sector_scratch.out_tensors : nullptr,
+                      (stats != nullptr) ? &sector_scratch.stats : nullptr);
+  });
+
+  for (auto&& sector_scratch : scratch.sectors) {
+    out_hits.insert(out_hits.end(),
+                    std::make_move_iterator(sector_scratch.out_hits.begin()),
+                    std::make_move_iterator(sector_scratch.out_hits.end()));
+    out_tracks.insert(out_tracks.end(),
+                      std::make_move_iterator(sector_scratch.out_tracks.begin()),
+                      std::make_move_iterator(sector_scratch.out_tracks.end()));
+    if (out_tensors_ptr != nullptr) {
+      out_tensors_ptr->append(sector_scratch.out_tensors);
+    }
+    if (stats != nullptr) {
+      stats->add(sector_scratch.stats);
+    }
+  }
+  write_tensors(evt_id, out_tensors_ptr);
+}
+
+void EMTFWorker::write_tensors(const edm::EventID& evt_id, const SectorTensorBuffer* out_tensors) const {
+  if (out_tensors == nullptr)
+    return;
+
+  // Events are written in the order they finish, the event index keeps the event IDs
+  const bool success =
+      tensor_writer_->write_event(evt_id.run(), evt_id.luminosityBlock(), evt_id.event(), *out_tensors);
+  emtf_assert(success);
+  emtf_maybe_unused(success);
 }
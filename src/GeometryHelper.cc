@@ -3,12 +3,18 @@
 using namespace emtf::phase2;
 
 GeometryHelper::GeometryHelper(edm::ConsumesCollector&& iConsumes)
-    : magFieldToken_(iConsumes.esConsumes<MagneticField, IdealMagneticFieldRecord>()),
-      dtGeomToken_(iConsumes.esConsumes<DTGeometry, MuonGeometryRecord>()),
-      cscGeomToken_(iConsumes.esConsumes<CSCGeometry, MuonGeometryRecord>()),
-      rpcGeomToken_(iConsumes.esConsumes<RPCGeometry, MuonGeometryRecord>()),
-      gemGeomToken_(iConsumes.esConsumes<GEMGeometry, MuonGeometryRecord>()),
-      me0GeomToken_(iConsumes.esConsumes<ME0Geometry, MuonGeometryRecord>()),
+    : GeometryHelper(iConsumes, edm::Transition::Event) {}
+
+GeometryHelper::GeometryHelper(edm::ConsumesCollector& iConsumes)
+    : GeometryHelper(iConsumes, edm::Transition::Event) {}
+
+GeometryHelper::GeometryHelper(edm::ConsumesCollector& iConsumes, edm::Transition iTransition)
+    : magFieldToken_(es_consumes<MagneticField, IdealMagneticFieldRecord>(iConsumes, iTransition)),
+      dtGeomToken_(es_consumes<DTGeometry, MuonGeometryRecord>(iConsumes, iTransition)),
+      cscGeomToken_(es_consumes<CSCGeometry, MuonGeometryRecord>(iConsumes, iTransition)),
+      rpcGeomToken_(es_consumes<RPCGeometry, MuonGeometryRecord>(iConsumes, iTransition)),
+      gemGeomToken_(es_consumes<GEMGeometry, MuonGeometryRecord>(iConsumes, iTransition)),
+      me0GeomToken_(es_consumes<ME0Geometry, MuonGeometryRecord>(iConsumes, iTransition)),
       magFieldWatcher_(this, &GeometryHelper::watch_mag_field),
       dtGeomWatcher_(this, &GeometryHelper::watch_dt_geom),
       cscGeomWatcher_(this, &GeometryHelper::watch_csc_geom),
@@ -20,15 +26,17 @@ GeometryHelper::GeometryHelper(edm::ConsumesCollector&& iConsumes)
       cscGeom_(nullptr),
       rpcGeom_(nullptr),
       gemGeom_(nullptr),
-      me0Geom_(nullptr) {}
+      me0Geom_(nullptr),
+      muonGeomCacheId_(0),
+      coordLUT_(nullptr) {}
 
-GeometryHelper::GeometryHelper(edm::ConsumesCollector& iConsumes)
-    : magFieldToken_(iConsumes.esConsumes<MagneticField, IdealMagneticFieldRecord>()),
-      dtGeomToken_(iConsumes.esConsumes<DTGeometry, MuonGeometryRecord>()),
-      cscGeomToken_(iConsumes.esConsumes<CSCGeometry, MuonGeometryRecord>()),
-      rpcGeomToken_(iConsumes.esConsumes<RPCGeometry, MuonGeometryRecord>()),
-      gemGeomToken_(iConsumes.esConsumes<GEMGeometry, MuonGeometryRecord>()),
-      me0GeomToken_(iConsumes.esConsumes<ME0Geometry, MuonGeometryRecord>()),
+GeometryHelper::GeometryHelper(const GeometryHelper& other)
+    : magFieldToken_(other.magFieldToken_),
+      dtGeomToken_(other.dtGeomToken_),
+      cscGeomToken_(other.cscGeomToken_),
+      rpcGeomToken_(other.rpcGeomToken_),
+      gemGeomToken_(other.gemGeomToken_),
+      me0GeomToken_(other.me0GeomToken_),
       magFieldWatcher_(this, &GeometryHelper::watch_mag_field),
       dtGeomWatcher_(this, &GeometryHelper::watch_dt_geom),
       cscGeomWatcher_(this, &GeometryHelper::watch_csc_geom),
@@ -40,7 +48,9 @@ GeometryHelper::GeometryHelper(edm::ConsumesCollector& iConsumes)
       cscGeom_(nullptr),
       rpcGeom_(nullptr),
       gemGeom_(nullptr),
-      me0Geom_(nullptr) {}
+      me0Geom_(nullptr),
+      muonGeomCacheId_(0),
+      coordLUT_(nullptr) {}
 
 GeometryHelper::~GeometryHelper() {}
 
@@ -1,13 +1,10 @@
 #include "L1Trigger/Phase2L1EMTF/interface/SectorProcessor.h"
 
-#include <algorithm>  // provides std::find
-#include <array>
+#include <algorithm>  // provides std::fill, std::min
 #include <iostream>
 #include <iterator>  // provides std::make_move_iterator
 #include <type_traits>
-#include <map>
 #include <utility>
-#include <variant>
 #include <vector>
 
 #include "L1Trigger/Phase2L1EMTF/interface/EMTFWorker.h"
@@ -16,33 +13,76 @@
 #include "L1Trigger/Phase2L1EMTF/interface/ConditionHelper.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SegmentFormatter.h"
 #include "L1Trigger/Phase2L1EMTF/interface/SegmentPrinter.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SectorTensorFile.h"
 #include "L1Trigger/Phase2L1EMTF/interface/TrackFormatter.h"
 
 using namespace emtf::phase2;
 
 void SectorProcessor::process(const EMTFWorker& iWorker,
+                              const GeometryHelper& geom_helper,
                               int endcap,
                               int sector,
                               const edm::EventID& evt_id,
                               const SubsystemCollection& muon_primitives,
+                              const SubsystemRouter& router,
+                              const ChamberIndex& chamber_index,
+                              EMTFScratch::Sector& scratch,
                               EMTFHitCollection& out_hits,
-                              EMTFTrackCollection& out_tracks) const {
+                              EMTFTrackCollection& out_tracks,
+                              SectorTensorBuffer* out_tensors,
+                              EMTFProfiler::Stats* stats) const {
   // Loop over BX
-  for (int bx = iWorker.minBX_; bx <= iWorker.maxBX_; ++bx) {
+  // Hits are converted for every BX in [minBX, maxBX] or [minTrackBX, maxTrackBX], but are only
+  // kept in the output if the BX is in [minBX, maxBX]. Tracks are built if the BX is in
+  // [minTrackBX, maxTrackBX].
+  for (int bx = iWorker.minConvBX_; bx <= iWorker.maxConvBX_; ++bx) {
+    const bool keep_hits = (iWorker.minBX_ <= bx) and (bx <= iWorker.maxBX_);
+    const bool build_tracks = (iWorker.minTrackBX_ <= bx) and (bx <= iWorker.maxTrackBX_);
+
     // 1 - Preprocessing
-    EMTFHitCollection sector_hits;
-    process_step_1(iWorker, endcap, sector, bx, muon_primitives, sector_hits);
+    // The segments are written directly into the model input if tracks are built, and into
+    // sector_hits only if the hits are kept.
+    EMTFHitCollection& sector_hits = scratch.sector_hits;
+    sector_hits.clear();
+    // Only the primitives routed to this (endcap, sector, bx) are visited
+    const SubsystemRouter::bucket_t& bucket = router.get_bucket(endcap, sector, bx);
+    int num_hits = 0;
+    {
+      EMTFProfiler::ScopedTimer timer(stats, EMTFProfiler::kStep1);
+      num_hits = process_step_1(iWorker,
+                                geom_helper,
+                                endcap,
+                                sector,
+                                bx,
+                                muon_primitives,
+                                bucket,
+                                chamber_index,
+                                build_tracks,
+                                keep_hits,
+                                scratch,
+                                sector_hits,
+                                stats);
+    }
 
     // 2 - Real processing
-    // Only BX=0 is supported at the moment
-    EMTFTrackCollection sector_tracks;
-    if (bx == 0) {
-      process_step_2(iWorker, endcap, sector, bx, sector_hits, sector_tracks);
+    EMTFTrackCollection& sector_tracks = scratch.sector_tracks;
+    sector_tracks.clear();
+    if (build_tracks) {
+      EMTFProfiler::ScopedTimer timer(stats, EMTFProfiler::kStep2);
+      process_step_2(iWorker, endcap, sector, bx, num_hits, scratch, sector_tracks, out_tensors, stats);
+    }
+
+    if (stats != nullptr) {
+      stats->count(EMTFProfiler::kSectors);
+      stats->count_hits(num_hits);
+      stats->count(EMTFProfiler::kTracks, sector_tracks.size());
     }
 
     // 3 - Postprocessing
-    out_hits.insert(
-        out_hits.end(), std::make_move_iterator(sector_hits.begin()), std::make_move_iterator(sector_hits.end()));
+    if (keep_hits) {
+      out_hits.insert(
+          out_hits.end(), std::make_move_iterator(sector_hits.begin()), std::make_move_iterator(sector_hits.end()));
+    }
     out_tracks.insert(
         out_tracks.end(), std::make_move_iterator(sector_tracks.begin()), std::make_move_iterator(sector_tracks.end()));
 
@@ -56,229 +96,185 @@ void SectorProcessor::process(const EMTFWorker& iWorker,
   }  // end loop over BX
 }
 
-void SectorProcessor::process_step_1(const EMTFWorker& iWorker,
-                                     int endcap,
-                                     int sector,
-                                     int bx,
-                                     const SubsystemCollection& muon_primitives,
-                                     EMTFHitCollection& sector_hits) const {
-  // For CSC, keep a list of wire ambiguity. Store the list in a map with key: (detid, bx), value: (wire,).
-  // For GEM, keep a list of coincidence pads. Store the list in a map with key: (detid, bx), value: (roll, pad_lo, pad_hi).
-  // For RPC and ME0, do nothing.
-  std::map<std::pair<uint32_t, uint16_t>, std::vector<uint16_t> > csc_chamber_wire_ambi;
-  std::map<std::pair<uint32_t, uint16_t>, std::vector<std::array<uint16_t, 3> > > gem_chamber_copad_vec;
-
-  // Loop over muon_primitives (1st pass)
-  for (const auto& [a, b, c] : muon_primitives) {
-    // clang-format off
-    std::visit([&](auto&& subsystem, auto&& detid, auto&& digi) {
-      using T1 = std::decay_t<decltype(subsystem)>;
-      using T2 = std::decay_t<decltype(detid)>;
-      using T3 = std::decay_t<decltype(digi)>;
-      // Enable if (subsystem, detid, digi) are consistent
-      if constexpr (std::is_same_v<typename T1::detid_type, T2> and std::is_same_v<typename T1::digi_type, T3>) {
-        // Enable if subsystem is CSC/RPC/GEM/ME0
-        if constexpr (std::is_same_v<T1, csc_subsystem_tag>) {
-          uint16_t tp_wire = digi.getKeyWG();
-          auto akey = std::make_pair(detid.rawId(), digi.getBX());
-          // If key and value both exist, do nothing. If key exists, but not value, insert value.
-          // If neither key nor value exists, insert both key and value.
-          auto found = csc_chamber_wire_ambi.find(akey);
-          if (found != csc_chamber_wire_ambi.end()) {
-            auto inner_found = std::find(found->second.begin(), found->second.end(), tp_wire);
-            if (inner_found != found->second.end()) {
-              // Do nothing
-            } else {
-              found->second.push_back(tp_wire);
-            }
-          } else {
-            csc_chamber_wire_ambi[akey].push_back(tp_wire);
-          }
-
-        } else if constexpr (std::is_same_v<T1, rpc_subsystem_tag>) {
-          // Do nothing
-
-        } else if constexpr (std::is_same_v<T1, gem_subsystem_tag>) {
-          uint16_t tp_layer = detid.layer();
-          uint16_t tp_roll = detid.roll();
-          uint16_t tp_pad_lo = digi.pads().front();
-          uint16_t tp_pad_hi = digi.pads().back();
-          bool tp_valid = digi.isValid();
-          // Remove layer number and roll number from detid
-          gem_subsystem_tag::detid_type detid_mod(
-              detid.region(), detid.ring(), detid.station(), 0, detid.chamber(), 0);
-          auto akey = std::make_pair(detid_mod.rawId(), digi.bx());
-          if (tp_valid and (tp_layer == 1)) {  // layer 1 is used as incidence
-            // If key does not exist, insert an empty vector. If key exists, do nothing.
-            decltype(gem_chamber_copad_vec)::mapped_type avec;
-            gem_chamber_copad_vec.insert({akey, avec});
-          } else if (tp_valid and (tp_layer == 2)) {  // layer 2 is used as coincidence
-            // If key does not exist, insert an empty vector and push a value. If key exists, push a value.
-            decltype(gem_chamber_copad_vec)::mapped_type::value_type aval{{tp_roll, tp_pad_lo, tp_pad_hi}};
-            gem_chamber_copad_vec[akey].push_back(std::move(aval));
-          }
-
-        } else if constexpr (std::is_same_v<T1, me0_subsystem_tag>) {
-          // Do nothing
-
-        } else {
-          // Make sure every subsystem type has been visited
-          static_assert(dependent_false<T1>::value, "unreachable!");
-        }         // end inner constexpr if statement
-      }           // end outer constexpr if statement
-    }, a, b, c);  // end visit
-    // clang-format on
+int SectorProcessor::process_step_1(const EMTFWorker& iWorker,
+                                    const GeometryHelper& geom_helper,
+                                    int endcap,
+                                    int sector,
+                                    int bx,
+                                    const SubsystemCollection& muon_primitives,
+                                    const SubsystemRouter::bucket_t& bucket,
+                                    const ChamberIndex& chamber_index,
+                                    bool fill_input,
+                                    bool keep_hits,
+                                    EMTFScratch::Sector& scratch,
+                                    EMTFHitCollection& sector_hits,
+                                    EMTFProfiler::Stats* stats) const {
+  const NdArrayDesc& input_shape = iWorker.model_->get_input_shape();
+  const int num_chambers = iWorker.model_->get_num_chambers();
+  const int num_segments = iWorker.model_->get_num_segments();
 
-  }  // end loop
+  // Count num of valid segments in each chamber
+  std::fill(scratch.segment_counts.begin(), scratch.segment_counts.end(), 0);
+  int num_hits = 0;
 
-  // Convert/format input segments
-  SegmentFormatter formatter;
-  EMTFHitCollection substitutes;
-
-  // Loop over muon_primitives (2nd pass)
-  for (const auto& [a, b, c] : muon_primitives) {
-    SegmentFormatter::ChamberInfo chminfo;
-    EMTFHit hit;
-    int strategy = 0;  // default strategy
-
-    // clang-format off
-    std::visit([&](auto&& subsystem, auto&& detid, auto&& digi) {
-      using T1 = std::decay_t<decltype(subsystem)>;
-      using T2 = std::decay_t<decltype(detid)>;
-      using T3 = std::decay_t<decltype(digi)>;
-      using T4 = typename T1::detgeom_type;
-      // Enable if (subsystem, detid, digi) are consistent
-      if constexpr (std::is_same_v<typename T1::detid_type, T2> and std::is_same_v<typename T1::digi_type, T3>) {
-        // Enable if subsystem is CSC/RPC/GEM/ME0
-        if constexpr (std::is_same_v<T1, csc_subsystem_tag>) {
-          // For CSC, send the list of wire ambiguity
-          auto akey = std::make_pair(detid.rawId(), digi.getBX());
-          chminfo.wire_ambi = csc_chamber_wire_ambi.at(akey);
-
-        } else if constexpr (std::is_same_v<T1, rpc_subsystem_tag>) {
-          // Do nothing
-
-        } else if constexpr (std::is_same_v<T1, gem_subsystem_tag>) {
-          // For GEM, send the list of coincidence pads
-          // Remove layer number and roll number from detid
-          gem_subsystem_tag::detid_type detid_mod(
-              detid.region(), detid.ring(), detid.station(), 0, detid.chamber(), 0);
-          auto akey = std::make_pair(detid_mod.rawId(), digi.bx());
-          chminfo.copad_vec = gem_chamber_copad_vec.at(akey);
-
-        } else if constexpr (std::is_same_v<T1, me0_subsystem_tag>) {
-          // Do nothing
-
-        } else {
-          // Make sure every subsystem type has been visited
-          static_assert(dependent_false<T1>::value, "unreachable!");
-        }         // end inner constexpr if statement
-
-        // Get subsystem geometry and do the conversion
-        auto&& detgeom = iWorker.geom_helper_->get<T4>();
-        formatter.format(endcap, sector, bx, strategy, detgeom, detid, digi, chminfo, hit);
-
-        // Try again with a different strategy
-        if (not hit.valid()) {
-          strategy++;
-          formatter.format(endcap, sector, bx, strategy, detgeom, detid, digi, chminfo, hit);
-        }
-      }           // end outer constexpr if statement
-    }, a, b, c);  // end visit
-    // clang-format on
-
-    // Does not belong to this sector
-    if (not hit.valid())
-      continue;
+  // Assign emtf_segment, write the segment into the model input, and keep the hit
+  auto accept_fn = [&](EMTFHit& hit) {
+    const int emtf_chamber = hit.emtfChamber();
+    emtf_assert((0 <= emtf_chamber) and (emtf_chamber < num_chambers));
+    emtf_maybe_unused(num_chambers);
+
+    const int emtf_segment = scratch.segment_counts[emtf_chamber]++;
+    hit.setEmtfSegment(emtf_segment);
+    ++num_hits;
+
+    if (fill_input) {
+      // Accept at most 2 segments
+      if (emtf_segment < num_segments) {
+        const unsigned iseg = (emtf_chamber * num_segments) + emtf_segment;
+        const unsigned ivar = 0;
+        fill_model_input(hit, &(scratch.in0[input_shape.get_index({iseg, ivar})]));
+      } else if (stats != nullptr) {
+        stats->count(EMTFProfiler::kDroppedSegments);
+      }
+    }
 
-    // Keep the valid segment
-    if (strategy == 0) {
+    if (keep_hits) {
       sector_hits.push_back(std::move(hit));
-    } else {
-      substitutes.push_back(std::move(hit));
     }
-  }  // end loop
+  };
 
-  // Insert substitutes at the end of sector_hits
-  sector_hits.insert(
-      sector_hits.end(), std::make_move_iterator(substitutes.begin()), std::make_move_iterator(substitutes.end()));
-
-  // Modify the segments in-place
-  std::map<int, int> counter_map;  // key: emtf_chamber
-
-  for (auto&& hit : sector_hits) {
-    // Count num of valid segments in this chamber
-    int emtf_chamber = hit.emtfChamber();
-    counter_map[emtf_chamber]++;                          // increment counter
-    int emtf_segment = counter_map.at(emtf_chamber) - 1;  // decrement to get the original count
-    hit.setEmtfSegment(emtf_segment);                     // assign emtf_segment
+  // Convert/format input segments
+  SegmentFormatter formatter(geom_helper.getCoordinateLUT());
+  EMTFHitCollection& formatted_hits = scratch.formatted_hits;
+  std::vector<int>& formatted_strategies = scratch.formatted_strategies;
+  SegmentFormatter::CoordinateBatch& coordinates = scratch.coordinates;
+  formatted_hits.clear();
+  formatted_strategies.clear();
+  coordinates.clear();
+
+  // Loop over the primitives of one subsystem in this bucket
+  auto format_fn = [&](auto subsystem) {
+    using T1 = decltype(subsystem);
+    using T4 = typename T1::detgeom_type;
+
+    const auto& primitives = muon_primitives.get<T1>();
+    auto&& detgeom = geom_helper.get<T4>();
+
+    for (const SubsystemRouter::Route& route : bucket.get<T1>()) {
+      const auto& detid = primitives[route.iprim].detid;
+      const auto& digi = primitives[route.iprim].digi();
+      SegmentFormatter::ChamberInfo chminfo;
+      EMTFHit hit;
+
+      if constexpr (std::is_same_v<T1, csc_subsystem_tag>) {
+        // For CSC, send the list of wire ambiguity
+        chminfo.wire_ambi = chamber_index.get_wire_ambi(detid, digi);
+
+      } else if constexpr (std::is_same_v<T1, rpc_subsystem_tag>) {
+        // Do nothing
+
+      } else if constexpr (std::is_same_v<T1, gem_subsystem_tag>) {
+        // For GEM, send the list of coincidence pads
+        chminfo.copad_vec = chamber_index.get_copad_vec(detid, digi);
+
+      } else if constexpr (std::is_same_v<T1, me0_subsystem_tag>) {
+        // Do nothing
+
+      } else {
+        // Make sure every subsystem type has been visited
+        static_assert(dependent_false<T1>::value, "unreachable!");
+      }  // end constexpr if statement
+
+      // Do the conversion
+      const int strategy = formatter.format(endcap, sector, bx, detgeom, detid, digi, chminfo, coordinates, hit);
+
+      // Does not belong to this sector
+      if (not hit.valid())
+        continue;
+
+      // A delayed primitive is never accepted by the default strategy
+      emtf_assert(not(route.is_delayed and (strategy == 0)));
+
+      // Keep the valid segment
+      formatted_hits.push_back(std::move(hit));
+      formatted_strategies.push_back(strategy);
+    }  // end loop
+  };
+
+  format_fn(csc_subsystem_tag{});
+  format_fn(rpc_subsystem_tag{});
+  format_fn(gem_subsystem_tag{});
+  format_fn(me0_subsystem_tag{});
+
+  // Convert the coordinates of all the segments at once
+  formatter.finalize(endcap, sector, coordinates, formatted_hits);
+
+  // The substitutes are accepted after all the other segments
+  for (unsigned i = 0; i < formatted_hits.size(); ++i) {
+    if (formatted_strategies[i] == 0) {
+      accept_fn(formatted_hits[i]);
+    }
   }
+  for (unsigned i = 0; i < formatted_hits.size(); ++i) {
+    if (formatted_strategies[i] != 0) {
+      accept_fn(formatted_hits[i]);
+    }
+  }
+  return num_hits;
 }
 
 void SectorProcessor::process_step_2(const EMTFWorker& iWorker,
                                      int endcap,
                                      int sector,
                                      int bx,
-                                     const EMTFHitCollection& sector_hits,
-                                     EMTFTrackCollection& sector_tracks) const {
+                                     int num_hits,
+                                     EMTFScratch::Sector& scratch,
+                                     EMTFTrackCollection& sector_tracks,
+                                     SectorTensorBuffer* out_tensors,
+                                     EMTFProfiler::Stats* stats) const {
   // Exit early if sector is empty
-  bool early_exit = sector_hits.empty();
+  bool early_exit = (num_hits == 0);
 
   if (early_exit)
     return;
 
   const NdArrayDesc& input_shape = iWorker.model_->get_input_shape();
   const NdArrayDesc& output_shape = iWorker.model_->get_output_shape();
+  const unsigned num_chambers = iWorker.model_->get_num_chambers();
   const unsigned num_segments = iWorker.model_->get_num_segments();
   const unsigned num_tracks = iWorker.model_->get_num_tracks();
 
-  // Model input and output
-  std::vector<int> in0(input_shape.num_elements(), 0);
-  std::vector<int> out(output_shape.num_elements(), 0);
+  // Model input and output. The input has been filled in step 1.
+  const int* in0 = scratch.in0.data();
+  int* out = scratch.out.data();
+  emtf_assert(input_shape.num_elements() <= scratch.in0.size());
+  emtf_assert(output_shape.num_elements() <= scratch.out.size());
 
-  // Fill values
-  for (auto&& hit : sector_hits) {
-    const int emtf_chamber = hit.emtfChamber();
-    const int emtf_segment = hit.emtfSegment();
-    emtf_assert(hit.valid() == true);  // segment must be valid
+  // Fit
+  iWorker.model_->fit(in0, out);
 
-    // Accept at most 2 segments
-    if (not(static_cast<unsigned>(emtf_segment) < num_segments))
-      continue;
+  if (stats != nullptr) {
+    stats->count(EMTFProfiler::kFits);
+  }
 
-    // Populate the variables
-    //
-    // +-------------+-------------+-------------+-------------+
-    // | emtf_phi    | emtf_bend   | emtf_theta1 | emtf_theta2 |
-    // +-------------+-------------+-------------+-------------+
-    // | emtf_qual1  | emtf_qual2  | emtf_time   | seg_zones   |
-    // +-------------+-------------+-------------+-------------+
-    // | seg_tzones  | seg_cscfr   | seg_gemdl   | seg_bx      |
-    // +-------------+-------------+-------------+-------------+
-    // | seg_valid   |             |             |             |
-    // +-------------+-------------+-------------+-------------+
-
-    const unsigned iseg = (emtf_chamber * num_segments) + emtf_segment;
-    const unsigned ivar = 0;
-    auto in0_iter = std::next(in0.begin(), input_shape.get_index({iseg, ivar}));
-
-    *(in0_iter++) = hit.emtfPhi();
-    *(in0_iter++) = hit.emtfBend();
-    *(in0_iter++) = hit.emtfTheta1();
-    *(in0_iter++) = hit.emtfTheta2();
-    *(in0_iter++) = hit.emtfQual1();
-    *(in0_iter++) = hit.emtfQual2();
-    *(in0_iter++) = hit.emtfTime();
-    *(in0_iter++) = hit.zones();
-    *(in0_iter++) = hit.timezones();
-    *(in0_iter++) = hit.cscfr();
-    *(in0_iter++) = hit.gemdl();
-    *(in0_iter++) = hit.bx();
-    *(in0_iter++) = hit.valid();
-  }  // end loop
+  // Keep the tensors to be written out
+  if (out_tensors != nullptr) {
+    out_tensors->add(endcap, sector, bx, in0, input_shape.num_elements(), out, output_shape.num_elements());
+  }
 
-  // Fit
-  iWorker.model_->fit(in0, out);
+  // Clear the segments of the model input that were filled, so that it is all zeros for the next use.
+  // The segments of a chamber are contiguous.
+  const unsigned num_variables = input_shape.num_elements() / (num_chambers * num_segments);
+
+  for (unsigned emtf_chamber = 0; emtf_chamber < num_chambers; ++emtf_chamber) {
+    const unsigned count = std::min(static_cast<unsigned>(scratch.segment_counts[emtf_chamber]), num_segments);
+    if (count == 0)
+      continue;
+    const unsigned iseg = (emtf_chamber * num_segments);
+    const unsigned ivar = 0;
+    auto in0_iter = std::next(scratch.in0.begin(), input_shape.get_index({iseg, ivar}));
+    std::fill(in0_iter, std::next(in0_iter, count * num_variables), 0);
+  }
 
   // Convert/format output tracks
   TrackFormatter formatter;
@@ -290,10 +286,11 @@ void SectorProcessor::process_step_2(const EMTFWorker& iWorker,
     EMTFTrack trk;
 
     // Get the span of data and do the conversion
-    auto out_iter = std::next(out.begin(), output_shape.get_index({itrk, ivar}));
-    auto out_iter_end =
-        ((itrk + 1) < num_tracks) ? std::next(out.begin(), output_shape.get_index({itrk + 1, ivar})) : out.end();
-    std::vector<int> trk_data(out_iter, out_iter_end);
+    auto out_iter = std::next(out, output_shape.get_index({itrk, ivar}));
+    auto out_iter_end = ((itrk + 1) < num_tracks) ? std::next(out, output_shape.get_index({itrk + 1, ivar}))
+                                                  : std::next(out, output_shape.num_elements());
+    std::vector<int>& trk_data = scratch.trk_data;
+    trk_data.assign(out_iter, out_iter_end);
     formatter.format(endcap, sector, bx, model_version, unconstrained, trk_data, trk);
 
     // Skip the invalid track
@@ -305,6 +302,36 @@ void SectorProcessor::process_step_2(const EMTFWorker& iWorker,
   }  // end loop
 }
 
+void SectorProcessor::fill_model_input(const EMTFHit& hit, int* in0_iter) const {
+  emtf_assert(hit.valid() == true);  // segment must be valid
+
+  // Populate the variables
+  //
+  // +-------------+-------------+-------------+-------------+
+  // | emtf_phi    | emtf_bend   | emtf_theta1 | emtf_theta2 |
+  // +-------------+-------------+-------------+-------------+
+  // | emtf_qual1  | emtf_qual2  | emtf_time   | seg_zones   |
+  // +-------------+-------------+-------------+-------------+
+  // | seg_tzones  | seg_cscfr   | seg_gemdl   | seg_bx      |
+  // +-------------+-------------+-------------+-------------+
+  // | seg_valid   |             |             |             |
+  // +-------------+-------------+-------------+-------------+
+
+  *(in0_iter++) = hit.emtfPhi();
+  *(in0_iter++) = hit.emtfBend();
+  *(in0_iter++) = hit.emtfTheta1();
+  *(in0_iter++) = hit.emtfTheta2();
+  *(in0_iter++) = hit.emtfQual1();
+  *(in0_iter++) = hit.emtfQual2();
+  *(in0_iter++) = hit.emtfTime();
+  *(in0_iter++) = hit.zones();
+  *(in0_iter++) = hit.timezones();
+  *(in0_iter++) = hit.cscfr();
+  *(in0_iter++) = hit.gemdl();
+  *(in0_iter++) = hit.bx();
+  *(in0_iter++) = hit.valid();
+}
+
 void SectorProcessor::dump_input_output(const edm::EventID& evt_id,
                                         const SubsystemCollection& muon_primitives,
                                         const EMTFHitCollection& out_hits,
@@ -318,20 +345,7 @@ void SectorProcessor::dump_input_output(const edm::EventID& evt_id,
   SegmentPrinter printer;
 
   // Loop over muon_primitives
-  for (const auto& [a, b, c] : muon_primitives) {
-    // clang-format off
-    std::visit([&](auto&& subsystem, auto&& detid, auto&& digi) {
-      using T1 = std::decay_t<decltype(subsystem)>;
-      using T2 = std::decay_t<decltype(detid)>;
-      using T3 = std::decay_t<decltype(digi)>;
-      // Enable if (subsystem, detid, digi) are consistent
-      if constexpr (std::is_same_v<typename T1::detid_type, T2> and std::is_same_v<typename T1::digi_type, T3>) {
-        printer.print(detid, digi);
-      }           // end constexpr if statement
-    }, a, b, c);  // end visit
-    // clang-format on
-
-  }  // end loop
+  muon_primitives.for_each([&](auto&& subsystem, auto&& detid, auto&& digi) { printer.print(detid, digi); });
 
   std::cout << "[" << bold_seq << "TX#0" << reset_seq << "]" << std::endl;
 
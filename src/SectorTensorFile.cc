@@ -0,0 +1,204 @@
+#include "L1Trigger/Phase2L1EMTF/interface/SectorTensorFile.h"
+
+#include <algorithm>  // provides std::copy
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace emtf::phase2;
+
+namespace {
+  constexpr char sector_tensor_magic[8] = {'E', 'M', 'T', 'F', 'T', 'N', 'S', 'R'};
+  constexpr uint32_t sector_tensor_format_version = 1;
+  constexpr uint32_t sector_tensor_byte_order = 0x01020304;
+
+  static_assert(sizeof(int) == sizeof(int32_t));
+  static_assert(sizeof(SectorTensorFileHeader) == 64);
+  static_assert(sizeof(SectorTensorRecordHeader) == 32);
+  static_assert(sizeof(SectorTensorIndexEntry) == 32);
+
+  // Round up to a multiple of 8 bytes, so that every record and the index stay aligned
+  constexpr size_t align_record_size(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+}  // namespace
+
+// _____________________________________________________________________________
+void SectorTensorBuffer::add(int endcap, int sector, int bx, const std::vector<int>& in0, const std::vector<int>& out) {
+  add(endcap, sector, bx, in0.data(), in0.size(), out.data(), out.size());
+}
+
+void SectorTensorBuffer::add(
+    int endcap, int sector, int bx, const int* in0, size_t in0_size, const int* out, size_t out_size) {
+  SectorTensorRecordHeader rec_header{};
+  rec_header.endcap = endcap;
+  rec_header.sector = sector;
+  rec_header.bx = bx;
+  headers_.push_back(rec_header);
+
+  data_.insert(data_.end(), in0, in0 + in0_size);
+  data_.insert(data_.end(), out, out + out_size);
+}
+
+void SectorTensorBuffer::append(const SectorTensorBuffer& other) {
+  headers_.insert(headers_.end(), other.headers_.begin(), other.headers_.end());
+  data_.insert(data_.end(), other.data_.begin(), other.data_.end());
+}
+
+// _____________________________________________________________________________
+SectorTensorWriter::SectorTensorWriter(const std::string& fname,
+                                       unsigned model_version,
+                                       size_t in0_size,
+                                       size_t out_size)
+    : fp_(std::fopen(fname.c_str(), "wb")), header_{} {
+  std::memcpy(header_.magic, sector_tensor_magic, sizeof(header_.magic));
+  header_.format_version = sector_tensor_format_version;
+  header_.byte_order = sector_tensor_byte_order;
+  header_.header_size = sizeof(SectorTensorFileHeader);
+  header_.record_size =
+      align_record_size(sizeof(SectorTensorRecordHeader) + ((in0_size + out_size) * sizeof(int32_t)));
+  header_.model_version = model_version;
+  header_.in0_size = in0_size;
+  header_.out_size = out_size;
+  header_.num_records = 0;
+  header_.num_events = 0;
+  header_.index_offset = 0;
+
+  record_buffer_.resize(header_.record_size, 0);
+
+  // Write a provisional header, the final one is written by close()
+  if (is_open() and not write_header()) {
+    std::fclose(fp_);
+    fp_ = nullptr;
+  }
+}
+
+SectorTensorWriter::~SectorTensorWriter() { close(); }
+
+bool SectorTensorWriter::write_event(uint32_t run, uint32_t lumi, uint64_t event, const SectorTensorBuffer& buffer) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (not is_open())
+    return false;
+
+  const size_t data_size = header_.in0_size + header_.out_size;
+  if (buffer.data_.size() != (buffer.headers_.size() * data_size))
+    return false;
+
+  SectorTensorIndexEntry entry{};
+  entry.run = run;
+  entry.lumi = lumi;
+  entry.event = event;
+  entry.first_record = header_.num_records;
+  entry.num_records = buffer.size();
+
+  // Loop over records
+  auto data_iter = buffer.data_.begin();
+
+  for (const auto& rec_header : buffer.headers_) {
+    SectorTensorRecordHeader curr_header = rec_header;
+    curr_header.run = run;
+    curr_header.lumi = lumi;
+    curr_header.event = event;
+
+    char* dst = record_buffer_.data();
+    std::memcpy(dst, &curr_header, sizeof(SectorTensorRecordHeader));
+    std::copy(data_iter, data_iter + data_size, reinterpret_cast<int32_t*>(dst + sizeof(SectorTensorRecordHeader)));
+    data_iter += data_size;
+
+    if (std::fwrite(dst, 1, record_buffer_.size(), fp_) != record_buffer_.size())
+      return false;
+    ++header_.num_records;
+  }  // end loop over records
+
+  index_.push_back(entry);
+  ++header_.num_events;
+  return true;
+}
+
+bool SectorTensorWriter::close() {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (not is_open())
+    return false;
+
+  // Append the event index after the last record
+  header_.index_offset = header_.header_size + (header_.num_records * header_.record_size);
+
+  bool success = (std::fseek(fp_, header_.index_offset, SEEK_SET) == 0);
+  success = success and
+            (std::fwrite(index_.data(), sizeof(SectorTensorIndexEntry), index_.size(), fp_) == index_.size());
+  success = success and write_header();
+  success = (std::fclose(fp_) == 0) and success;
+  fp_ = nullptr;
+  return success;
+}
+
+bool SectorTensorWriter::write_header() {
+  return (std::fseek(fp_, 0, SEEK_SET) == 0) and (std::fwrite(&header_, sizeof(header_), 1, fp_) == 1) and
+         (std::fseek(fp_, 0, SEEK_END) == 0);
+}
+
+// _____________________________________________________________________________
+SectorTensorReader::SectorTensorReader(const std::string& fname)
+    : addr_(MAP_FAILED), length_(0), header_(nullptr), records_(nullptr), index_(nullptr) {
+  const int fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat st;
+  if ((::fstat(fd, &st) == 0) and (static_cast<size_t>(st.st_size) >= sizeof(SectorTensorFileHeader))) {
+    length_ = st.st_size;
+    addr_ = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  ::close(fd);  // the mapping stays valid
+
+  if (addr_ == MAP_FAILED)
+    return;
+
+  // Records are read in order most of the time
+  ::madvise(addr_, length_, MADV_SEQUENTIAL);
+
+  header_ = static_cast<const SectorTensorFileHeader*>(addr_);
+  if (not validate()) {
+    header_ = nullptr;
+    return;
+  }
+
+  records_ = static_cast<const char*>(addr_) + header_->header_size;
+  index_ = reinterpret_cast<const SectorTensorIndexEntry*>(static_cast<const char*>(addr_) + header_->index_offset);
+}
+
+SectorTensorReader::~SectorTensorReader() {
+  if (addr_ != MAP_FAILED) {
+    ::munmap(addr_, length_);
+  }
+}
+
+SectorTensorReader::Record SectorTensorReader::get_record(size_t i) const {
+  const char* rec = records_ + (i * header_->record_size);
+  const int32_t* in0 = reinterpret_cast<const int32_t*>(rec + sizeof(SectorTensorRecordHeader));
+  return Record{reinterpret_cast<const SectorTensorRecordHeader*>(rec), in0, in0 + header_->in0_size};
+}
+
+bool SectorTensorReader::validate() const {
+  const SectorTensorFileHeader& h = *header_;
+
+  if (std::memcmp(h.magic, sector_tensor_magic, sizeof(h.magic)) != 0)
+    return false;
+  if ((h.format_version != sector_tensor_format_version) or (h.byte_order != sector_tensor_byte_order))
+    return false;
+  if (h.header_size < sizeof(SectorTensorFileHeader))
+    return false;
+  if (h.record_size <
+      (sizeof(SectorTensorRecordHeader) + ((static_cast<size_t>(h.in0_size) + h.out_size) * sizeof(int32_t))))
+    return false;
+
+  // An unfinished file has no index
+  const size_t index_offset = h.header_size + (h.num_records * h.record_size);
+  if ((h.index_offset != index_offset) or
+      ((index_offset + (h.num_events * sizeof(SectorTensorIndexEntry))) > length_))
+    return false;
+  return true;
+}
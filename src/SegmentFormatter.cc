@@ -1,11 +1,10 @@
 #include "L1Trigger/Phase2L1EMTF/interface/SegmentFormatter.h"
 
 #include <algorithm>  // provides std::clamp, std::find_if
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
-#include <map>
-#include <tuple>
-#include <utility>
 
 #include "Geometry/CSCGeometry/interface/CSCGeometry.h"
 #include "Geometry/RPCGeometry/interface/RPCGeometry.h"
@@ -15,6 +14,7 @@
 #include "L1Trigger/CSCCommonTrigger/interface/CSCConstants.h"
 #include "L1Trigger/CSCCommonTrigger/interface/CSCPatternLUT.h"
 
+#include "L1Trigger/Phase2L1EMTF/interface/CoordinateLUT.h"
 #include "L1Trigger/Phase2L1EMTF/interface/Toolbox.h"
 
 using namespace emtf::phase2;
@@ -150,211 +150,281 @@ struct SegmentFormatter::find_emtf_time {
   }
 };
 
+namespace {
+
+  // Dense lookup tables. All the keys are small bounded integers, so the tables are indexed
+  // directly and built at compile time from the lists of (key, value) entries.
+  constexpr int kDenseNumSubsystems = 5;  // L1TMuon::kDT .. L1TMuon::kME0
+  constexpr int kDenseNumStations = 5;    // 1 .. 4
+  constexpr int kDenseNumRings = 5;       // 1 .. 4
+  constexpr int kDenseNumHosts = 19;      // emtf_host
+  constexpr int kDenseNumThetas = 128;    // emtf_theta is 7 bits
+  constexpr int kDenseNumZones = 3;
+
+  struct StationRingEntry {
+    int subsystem;
+    int station;
+    int ring;
+    int value;
+  };
+
+  struct Range {
+    int lo;
+    int hi;
+  };
+
+  struct HostRangeEntry {
+    int host;
+    int lo;
+    int hi;
+  };
+
+  typedef std::array<int, kDenseNumSubsystems * kDenseNumStations * kDenseNumRings> station_ring_table_t;
+  typedef std::array<std::array<uint8_t, kDenseNumThetas>, kDenseNumHosts> theta_table_t;
+  typedef std::array<Range, kDenseNumHosts> range_table_t;
+
+  constexpr int get_station_ring_index(int subsystem, int station, int ring) {
+    return (((subsystem * kDenseNumStations) + station) * kDenseNumRings) + ring;
+  }
+
+  constexpr bool is_station_ring_key(int subsystem, int station, int ring) {
+    return (0 <= subsystem) and (subsystem < kDenseNumSubsystems) and (0 <= station) and
+           (station < kDenseNumStations) and (0 <= ring) and (ring < kDenseNumRings);
+  }
+
+  template <std::size_t N>
+  constexpr station_ring_table_t make_station_ring_table(const StationRingEntry (&entries)[N], int invalid) {
+    station_ring_table_t table{};
+    for (auto& value : table) {
+      value = invalid;
+    }
+    for (const auto& entry : entries) {
+      table[get_station_ring_index(entry.subsystem, entry.station, entry.ring)] = entry.value;
+    }
+    return table;
+  }
+
+  // For each (emtf_host, emtf_theta), the word of the zones whose theta window contains emtf_theta.
+  // Zone 0 is the MSB.
+  template <std::size_t N0, std::size_t N1, std::size_t N2>
+  constexpr theta_table_t make_theta_table(const HostRangeEntry (&entries_0)[N0],
+                                           const HostRangeEntry (&entries_1)[N1],
+                                           const HostRangeEntry (&entries_2)[N2]) {
+    theta_table_t table{};
+    auto fill_fn = [&table](const HostRangeEntry& entry, int zone) {
+      for (int theta = entry.lo; theta <= entry.hi; ++theta) {
+        table[entry.host][theta] |= (1 << (kDenseNumZones - 1 - zone));
+      }
+    };
+    for (const auto& entry : entries_0) {
+      fill_fn(entry, 0);
+    }
+    for (const auto& entry : entries_1) {
+      fill_fn(entry, 1);
+    }
+    for (const auto& entry : entries_2) {
+      fill_fn(entry, 2);
+    }
+    return table;
+  }
+
+  // Hosts without an entry get an empty range
+  template <std::size_t N>
+  constexpr range_table_t make_range_table(const HostRangeEntry (&entries)[N]) {
+    range_table_t table{};
+    for (auto& value : table) {
+      value = Range{1, 0};
+    }
+    for (const auto& entry : entries) {
+      table[entry.host] = Range{entry.lo, entry.hi};
+    }
+    return table;
+  }
+
+}  // namespace
+
 struct SegmentFormatter::find_emtf_site {
-  int operator()(int subsystem, int tp_station, int tp_ring) const {
-    auto akey = std::make_tuple(subsystem, tp_station, tp_ring);
-    auto found = amap.find(akey);
-    return (found != amap.end()) ? found->second : kInvalid;
+  constexpr int operator()(int subsystem, int tp_station, int tp_ring) const {
+    return is_station_ring_key(subsystem, tp_station, tp_ring)
+               ? table[get_station_ring_index(subsystem, tp_station, tp_ring)]
+               : kInvalid;
   }
 
-  typedef std::tuple<int, int, int> key_type;
-  typedef std::map<key_type, int> map_type;
-  static const map_type amap;
-};
+  static constexpr StationRingEntry entries[] = {
+      {1, 1, 4, 0},   // ME1/1a
+      {1, 1, 1, 0},   // ME1/1b
+      {1, 1, 2, 1},   // ME1/2
+      {1, 1, 3, 1},   // ME1/3
+      {1, 2, 1, 2},   // ME2/1
+      {1, 2, 2, 2},   // ME2/2
+      {1, 3, 1, 3},   // ME3/1
+      {1, 3, 2, 3},   // ME3/2
+      {1, 4, 1, 4},   // ME4/1
+      {1, 4, 2, 4},   // ME4/2
+      {2, 1, 2, 5},   // RE1/2
+      {2, 1, 3, 5},   // RE1/3
+      {2, 2, 2, 6},   // RE2/2
+      {2, 2, 3, 6},   // RE2/3
+      {2, 3, 1, 7},   // RE3/1
+      {2, 3, 2, 7},   // RE3/2
+      {2, 3, 3, 7},   // RE3/3
+      {2, 4, 1, 8},   // RE4/1
+      {2, 4, 2, 8},   // RE4/2
+      {2, 4, 3, 8},   // RE4/3
+      {3, 1, 1, 9},   // GE1/1
+      {3, 2, 1, 10},  // GE2/1
+      {4, 1, 4, 11}   // ME0
+  };
 
-const SegmentFormatter::find_emtf_site::map_type SegmentFormatter::find_emtf_site::amap = {
-    {{1, 1, 4}, 0},   // ME1/1a
-    {{1, 1, 1}, 0},   // ME1/1b
-    {{1, 1, 2}, 1},   // ME1/2
-    {{1, 1, 3}, 1},   // ME1/3
-    {{1, 2, 1}, 2},   // ME2/1
-    {{1, 2, 2}, 2},   // ME2/2
-    {{1, 3, 1}, 3},   // ME3/1
-    {{1, 3, 2}, 3},   // ME3/2
-    {{1, 4, 1}, 4},   // ME4/1
-    {{1, 4, 2}, 4},   // ME4/2
-    {{2, 1, 2}, 5},   // RE1/2
-    {{2, 1, 3}, 5},   // RE1/3
-    {{2, 2, 2}, 6},   // RE2/2
-    {{2, 2, 3}, 6},   // RE2/3
-    {{2, 3, 1}, 7},   // RE3/1
-    {{2, 3, 2}, 7},   // RE3/2
-    {{2, 3, 3}, 7},   // RE3/3
-    {{2, 4, 1}, 8},   // RE4/1
-    {{2, 4, 2}, 8},   // RE4/2
-    {{2, 4, 3}, 8},   // RE4/3
-    {{3, 1, 1}, 9},   // GE1/1
-    {{3, 2, 1}, 10},  // GE2/1
-    {{4, 1, 4}, 11}   // ME0
+  static constexpr station_ring_table_t table = make_station_ring_table(entries, kInvalid);
 };
 
 struct SegmentFormatter::find_emtf_host {
-  int operator()(int subsystem, int tp_station, int tp_ring) const {
-    auto akey = std::make_tuple(subsystem, tp_station, tp_ring);
-    auto found = amap.find(akey);
-    return (found != amap.end()) ? found->second : kInvalid;
+  constexpr int operator()(int subsystem, int tp_station, int tp_ring) const {
+    return is_station_ring_key(subsystem, tp_station, tp_ring)
+               ? table[get_station_ring_index(subsystem, tp_station, tp_ring)]
+               : kInvalid;
   }
 
-  typedef std::tuple<int, int, int> key_type;
-  typedef std::map<key_type, int> map_type;
-  static const map_type amap;
-};
+  static constexpr StationRingEntry entries[] = {
+      {1, 1, 4, 0},   // ME1/1a
+      {1, 1, 1, 0},   // ME1/1b
+      {1, 1, 2, 1},   // ME1/2
+      {1, 1, 3, 2},   // ME1/3
+      {1, 2, 1, 3},   // ME2/1
+      {1, 2, 2, 4},   // ME2/2
+      {1, 3, 1, 5},   // ME3/1
+      {1, 3, 2, 6},   // ME3/2
+      {1, 4, 1, 7},   // ME4/1
+      {1, 4, 2, 8},   // ME4/2
+      {3, 1, 1, 9},   // GE1/1
+      {2, 1, 2, 10},  // RE1/2
+      {2, 1, 3, 11},  // RE1/3
+      {3, 2, 1, 12},  // GE2/1
+      {2, 2, 2, 13},  // RE2/2
+      {2, 2, 3, 13},  // RE2/3
+      {2, 3, 1, 14},  // RE3/1
+      {2, 3, 2, 15},  // RE3/2
+      {2, 3, 3, 15},  // RE3/3
+      {2, 4, 1, 16},  // RE4/1
+      {2, 4, 2, 17},  // RE4/2
+      {2, 4, 3, 17},  // RE4/3
+      {4, 1, 4, 18}   // ME0
+  };
 
-const SegmentFormatter::find_emtf_host::map_type SegmentFormatter::find_emtf_host::amap = {
-    {{1, 1, 4}, 0},   // ME1/1a
-    {{1, 1, 1}, 0},   // ME1/1b
-    {{1, 1, 2}, 1},   // ME1/2
-    {{1, 1, 3}, 2},   // ME1/3
-    {{1, 2, 1}, 3},   // ME2/1
-    {{1, 2, 2}, 4},   // ME2/2
-    {{1, 3, 1}, 5},   // ME3/1
-    {{1, 3, 2}, 6},   // ME3/2
-    {{1, 4, 1}, 7},   // ME4/1
-    {{1, 4, 2}, 8},   // ME4/2
-    {{3, 1, 1}, 9},   // GE1/1
-    {{2, 1, 2}, 10},  // RE1/2
-    {{2, 1, 3}, 11},  // RE1/3
-    {{3, 2, 1}, 12},  // GE2/1
-    {{2, 2, 2}, 13},  // RE2/2
-    {{2, 2, 3}, 13},  // RE2/3
-    {{2, 3, 1}, 14},  // RE3/1
-    {{2, 3, 2}, 15},  // RE3/2
-    {{2, 3, 3}, 15},  // RE3/3
-    {{2, 4, 1}, 16},  // RE4/1
-    {{2, 4, 2}, 17},  // RE4/2
-    {{2, 4, 3}, 17},  // RE4/3
-    {{4, 1, 4}, 18}   // ME0
+  static constexpr station_ring_table_t table = make_station_ring_table(entries, kInvalid);
 };
 
 struct SegmentFormatter::find_seg_zones {
-  int operator()(int emtf_host, int emtf_theta) const {
-    auto found_0 = amap_0.find(emtf_host);
-    auto found_1 = amap_1.find(emtf_host);
-    auto found_2 = amap_2.find(emtf_host);
-    bool b0 = (found_0 != amap_0.end()) and
-              ((found_0->second.first <= emtf_theta) and (emtf_theta <= found_0->second.second));
-    bool b1 = (found_1 != amap_1.end()) and
-              ((found_1->second.first <= emtf_theta) and (emtf_theta <= found_1->second.second));
-    bool b2 = (found_2 != amap_2.end()) and
-              ((found_2->second.first <= emtf_theta) and (emtf_theta <= found_2->second.second));
-    int word = (b0 << 2) | (b1 << 1) | (b2 << 0);
-    return word;
+  constexpr int operator()(int emtf_host, int emtf_theta) const { return lookup(emtf_host, emtf_theta); }
+
+  constexpr int operator()(int emtf_host, int emtf_theta1, int emtf_theta2) const {
+    return lookup(emtf_host, emtf_theta1) | lookup(emtf_host, emtf_theta2);
   }
 
-  int operator()(int emtf_host, int emtf_theta1, int emtf_theta2) const {
-    auto found_0 = amap_0.find(emtf_host);
-    auto found_1 = amap_1.find(emtf_host);
-    auto found_2 = amap_2.find(emtf_host);
-    bool b0 = (found_0 != amap_0.end()) and
-              (((found_0->second.first <= emtf_theta1) and (emtf_theta1 <= found_0->second.second)) or
-               ((found_0->second.first <= emtf_theta2) and (emtf_theta2 <= found_0->second.second)));
-    bool b1 = (found_1 != amap_1.end()) and
-              (((found_1->second.first <= emtf_theta1) and (emtf_theta1 <= found_1->second.second)) or
-               ((found_1->second.first <= emtf_theta2) and (emtf_theta2 <= found_1->second.second)));
-    bool b2 = (found_2 != amap_2.end()) and
-              (((found_2->second.first <= emtf_theta1) and (emtf_theta1 <= found_2->second.second)) or
-               ((found_2->second.first <= emtf_theta2) and (emtf_theta2 <= found_2->second.second)));
-    int word = (b0 << 2) | (b1 << 1) | (b2 << 0);
-    return word;
+  // All the theta windows are within [0, kDenseNumThetas), so an out-of-range key is in no zone
+  static constexpr int lookup(int emtf_host, int emtf_theta) {
+    const bool valid = (0 <= emtf_host) and (emtf_host < kDenseNumHosts) and (0 <= emtf_theta) and
+                       (emtf_theta < kDenseNumThetas);
+    return valid ? table[emtf_host][emtf_theta] : 0;
   }
 
-  typedef std::pair<int, int> value_type;
-  typedef std::map<int, value_type> map_type;
-  static const map_type amap_0;  // zone 0
-  static const map_type amap_1;  // zone 1
-  static const map_type amap_2;  // zone 2
-};
+  // Theta windows, key: emtf_host
+  static constexpr HostRangeEntry entries_0[] = {
+      // zone 0
+      {0, 4, 26},   // ME1/1
+      {3, 4, 25},   // ME2/1
+      {5, 4, 25},   // ME3/1
+      {7, 4, 25},   // ME4/1
+      {9, 17, 26},  // GE1/1
+      {12, 7, 25},  // GE2/1
+      {14, 4, 25},  // RE3/1
+      {16, 4, 25},  // RE4/1
+      {18, 4, 23}   // ME0
+  };
 
-const SegmentFormatter::find_seg_zones::map_type SegmentFormatter::find_seg_zones::amap_0 = {
-    {0, {4, 26}},   // ME1/1
-    {3, {4, 25}},   // ME2/1
-    {5, {4, 25}},   // ME3/1
-    {7, {4, 25}},   // ME4/1
-    {9, {17, 26}},  // GE1/1
-    {12, {7, 25}},  // GE2/1
-    {14, {4, 25}},  // RE3/1
-    {16, {4, 25}},  // RE4/1
-    {18, {4, 23}}   // ME0
-};
+  static constexpr HostRangeEntry entries_1[] = {
+      // zone 1
+      {0, 24, 53},   // ME1/1
+      {1, 46, 54},   // ME1/2
+      {3, 23, 49},   // ME2/1
+      {5, 23, 41},   // ME3/1
+      {6, 44, 54},   // ME3/2
+      {7, 23, 35},   // ME4/1
+      {8, 38, 54},   // ME4/2
+      {9, 24, 52},   // GE1/1
+      {10, 52, 56},  // RE1/2
+      {12, 23, 46},  // GE2/1
+      {14, 23, 36},  // RE3/1
+      {15, 40, 52},  // RE3/2
+      {16, 23, 31},  // RE4/1
+      {17, 35, 54}   // RE4/2
+  };
 
-const SegmentFormatter::find_seg_zones::map_type SegmentFormatter::find_seg_zones::amap_1 = {
-    {0, {24, 53}},   // ME1/1
-    {1, {46, 54}},   // ME1/2
-    {3, {23, 49}},   // ME2/1
-    {5, {23, 41}},   // ME3/1
-    {6, {44, 54}},   // ME3/2
-    {7, {23, 35}},   // ME4/1
-    {8, {38, 54}},   // ME4/2
-    {9, {24, 52}},   // GE1/1
-    {10, {52, 56}},  // RE1/2
-    {12, {23, 46}},  // GE2/1
-    {14, {23, 36}},  // RE3/1
-    {15, {40, 52}},  // RE3/2
-    {16, {23, 31}},  // RE4/1
-    {17, {35, 54}}   // RE4/2
-};
+  static constexpr HostRangeEntry entries_2[] = {
+      // zone 2
+      {1, 52, 88},   // ME1/2
+      {4, 52, 88},   // ME2/2
+      {6, 50, 88},   // ME3/2
+      {8, 50, 88},   // ME4/2
+      {10, 52, 84},  // RE1/2
+      {13, 52, 88},  // RE2/2
+      {15, 48, 84},  // RE3/2
+      {17, 52, 84}   // RE4/2
+  };
 
-const SegmentFormatter::find_seg_zones::map_type SegmentFormatter::find_seg_zones::amap_2 = {
-    {1, {52, 88}},   // ME1/2
-    {4, {52, 88}},   // ME2/2
-    {6, {50, 88}},   // ME3/2
-    {8, {50, 88}},   // ME4/2
-    {10, {52, 84}},  // RE1/2
-    {13, {52, 88}},  // RE2/2
-    {15, {48, 84}},  // RE3/2
-    {17, {52, 84}}   // RE4/2
+  static constexpr theta_table_t table = make_theta_table(entries_0, entries_1, entries_2);
 };
 
 struct SegmentFormatter::find_seg_timezones {
-  int operator()(int emtf_host, int tp_bx) const {
-    auto found_0 = amap_0.find(emtf_host);
-    bool b0 = (found_0 != amap_0.end()) and
-              ((found_0->second.first <= (tp_bx + 0)) and ((tp_bx + 0) <= found_0->second.second));
-    bool b1 = (found_0 != amap_0.end()) and
-              ((found_0->second.first <= (tp_bx + 1)) and ((tp_bx + 1) <= found_0->second.second));  // add +1 delay
-    bool b2 = (found_0 != amap_0.end()) and
-              ((found_0->second.first <= (tp_bx + 2)) and ((tp_bx + 2) <= found_0->second.second));  // add +2 delay
+  constexpr int operator()(int emtf_host, int tp_bx) const {
+    if (not((0 <= emtf_host) and (emtf_host < kDenseNumHosts)))
+      return 0;
+    const Range& range = table[emtf_host];
+    bool b0 = (range.lo <= (tp_bx + 0)) and ((tp_bx + 0) <= range.hi);
+    bool b1 = (range.lo <= (tp_bx + 1)) and ((tp_bx + 1) <= range.hi);  // add +1 delay
+    bool b2 = (range.lo <= (tp_bx + 2)) and ((tp_bx + 2) <= range.hi);  // add +2 delay
     int word = (b0 << 2) | (b1 << 1) | (b2 << 0);
     return word;
   }
 
-  typedef std::pair<int, int> value_type;
-  typedef std::map<int, value_type> map_type;
-  static const map_type amap_0;  // timezone 0
-};
+  // BX windows, key: emtf_host
+  static constexpr HostRangeEntry entries_0[] = {
+      // timezone 0
+      {0, -1, 0},   // ME1/1
+      {1, -1, 0},   // ME1/2
+      {2, -1, 0},   // ME1/3
+      {3, -1, 0},   // ME2/1
+      {4, -1, 0},   // ME2/2
+      {5, -1, 0},   // ME3/1
+      {6, -1, 0},   // ME3/2
+      {7, -1, 0},   // ME4/1
+      {8, -1, 0},   // ME4/2
+      {9, -1, 0},   // GE1/1
+      {10, 0, 0},   // RE1/2
+      {11, 0, 0},   // RE1/3
+      {12, -1, 0},  // GE2/1
+      {13, 0, 0},   // RE2/2
+      {14, 0, 0},   // RE3/1
+      {15, 0, 0},   // RE3/2
+      {16, 0, 0},   // RE4/1
+      {17, 0, 0},   // RE4/2
+      {18, 0, 0}    // ME0
+  };
 
-const SegmentFormatter::find_seg_timezones::map_type SegmentFormatter::find_seg_timezones::amap_0 = {
-    {0, {-1, 0}},   // ME1/1
-    {1, {-1, 0}},   // ME1/2
-    {2, {-1, 0}},   // ME1/3
-    {3, {-1, 0}},   // ME2/1
-    {4, {-1, 0}},   // ME2/2
-    {5, {-1, 0}},   // ME3/1
-    {6, {-1, 0}},   // ME3/2
-    {7, {-1, 0}},   // ME4/1
-    {8, {-1, 0}},   // ME4/2
-    {9, {-1, 0}},   // GE1/1
-    {10, {0, 0}},   // RE1/2
-    {11, {0, 0}},   // RE1/3
-    {12, {-1, 0}},  // GE2/1
-    {13, {0, 0}},   // RE2/2
-    {14, {0, 0}},   // RE3/1
-    {15, {0, 0}},   // RE3/2
-    {16, {0, 0}},   // RE4/1
-    {17, {0, 0}},   // RE4/2
-    {18, {0, 0}}    // ME0
+  static constexpr range_table_t table = make_range_table(entries_0);
 };
 
 // _____________________________________________________________________________
-void SegmentFormatter::format_impl(int endcap,
-                                   int sector,
-                                   int bx,
-                                   int strategy,
-                                   const CSCGeometry& detgeom,
-                                   const csc_subsystem_tag::detid_type& detid,
-                                   const csc_subsystem_tag::digi_type& digi,
-                                   const ChamberInfo& chminfo,
-                                   EMTFHit& hit) const {
+int SegmentFormatter::format_impl(int endcap,
+                                  int sector,
+                                  int bx,
+                                  const CSCGeometry& detgeom,
+                                  const csc_subsystem_tag::detid_type& detid,
+                                  const csc_subsystem_tag::digi_type& digi,
+                                  const ChamberInfo& chminfo,
+                                  CoordinateBatch& batch,
+                                  EMTFHit& hit) const {
   static const int subsystem = L1TMuon::kCSC;
   static const int csc_bx_shift = -CSCConstants::LCT_CENTRAL_BX;
 
@@ -398,6 +468,10 @@ void SegmentFormatter::format_impl(int endcap,
   int tp_subbx = 0;  // no fine resolution timing
   bool tp_valid = digi.isValid();
 
+  // Rejected
+  if (not tp_valid)
+    return kInvalid;
+
   // Apply ME1/1a -> ring 4 convention
   // Override tp_ring, tp_strip, tp_strip_es
   const bool is_me11a = (tp_station == 1) and (tp_ring == 1) and (tp_strip >= 128);
@@ -423,32 +497,8 @@ void SegmentFormatter::format_impl(int endcap,
   emtf_assert((1 <= chminfo.wire_ambi.size()) and (chminfo.wire_ambi.size() <= 2));
   const bool has_wire_ambi = (chminfo.wire_ambi.size() > 1);
   if (has_wire_ambi) {
-    tp_wire1 = chminfo.wire_ambi.at(0);
-    tp_wire2 = chminfo.wire_ambi.at(1);
-  }
-
-  // Guard against unexpected data
-  // Do this at the first sector only
-  if ((endcap == 1) and (sector == 1) and (bx == 0)) {
-    const auto [max_strip, max_wire] = toolbox::get_csc_max_strip_and_wire(tp_station, tp_ring);
-    const auto [max_pattern, max_quality] = toolbox::get_csc_max_pattern_and_quality(tp_station, tp_ring);
-    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
-    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
-    emtf_assert((0 <= tp_subsector) and (tp_subsector <= 2));
-    emtf_assert((1 <= tp_station) and (tp_station <= 4));
-    emtf_assert((1 <= tp_ring) and (tp_ring <= 4));
-    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
-    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 9));
-    emtf_assert((0 <= tp_strip) and (tp_strip < max_strip));
-    emtf_assert((0 <= tp_wire1) and (tp_wire1 < max_wire));
-    emtf_assert((0 <= tp_wire2) and (tp_wire2 < max_wire));
-    emtf_assert((2 <= tp_pattern) and (tp_pattern < max_pattern));
-    emtf_assert((1 <= tp_quality) and (tp_quality < max_quality));
-    emtf_assert(tp_valid == true);
-    emtf_maybe_unused(max_strip);
-    emtf_maybe_unused(max_wire);
-    emtf_maybe_unused(max_pattern);
-    emtf_maybe_unused(max_quality);
+    tp_wire1 = chminfo.wire_ambi[0];
+    tp_wire2 = chminfo.wire_ambi[1];
   }
 
   // Assign chamber and segment numbers
@@ -460,22 +510,28 @@ void SegmentFormatter::format_impl(int endcap,
   auto is_in_sector_fn = is_in_sector{endcap, sector};
   auto is_in_neighbor_sector_fn = is_in_neighbor_sector{endcap, sector};
 
-#ifdef EMTF_USE_CSC_BX0_ONLY
+  // Strategy 0 takes the segments from this BX only. Strategy 1 also takes the segments from
+  // the previous BX.
   const bool is_timely = is_in_bx_fn(tp_bx);
+#ifdef EMTF_USE_CSC_BX0_ONLY
+  const bool is_kindof_timely = is_timely;
   emtf_maybe_unused(is_kindof_in_bx_fn(tp_bx));
 #else
-  const bool is_timely = (strategy == 0) ? is_in_bx_fn(tp_bx) : is_kindof_in_bx_fn(tp_bx);
+  const bool is_kindof_timely = is_kindof_in_bx_fn(tp_bx);
 #endif
   const bool is_native = is_in_sector_fn(tp_endcap, tp_sector);
   const bool is_neighbor = is_in_neighbor_sector_fn(tp_endcap, tp_sector, tp_subsector, tp_station, tp_cscid);
 
-  if (is_timely and (is_native or is_neighbor)) {
+  if (is_kindof_timely and (is_native or is_neighbor)) {
     emtf_chamber = find_emtf_chamber{}(subsystem, tp_subsector, tp_station, tp_cscid, is_neighbor);
   }
 
   // Does not belong to this sector
   if (emtf_chamber == kInvalid)
-    return;
+    return kInvalid;
+
+  // Accepted by strategy 1 only if late by one BX
+  const int strategy = is_timely ? 0 : 1;
 
   // Get global coordinates and convert them
   auto detid_corr = CSCDetId(detid.endcap(), detid.station(), tp_ring, detid.chamber(), detid.layer());  // correct ring
@@ -486,31 +542,21 @@ void SegmentFormatter::format_impl(int endcap,
   digi_w1.setWireGroup(tp_wire1);  // patch the wiregroup number
   digi_w2.setWireGroup(tp_wire2);
 
-  const GlobalPoint& gp_w1 = get_global_point(detgeom, detid_corr, digi_w1);
-  const GlobalPoint& gp_w2 = has_wire_ambi ? get_global_point(detgeom, detid_corr, digi_w2) : GlobalPoint{};
-  const float glob_phi = toolbox::rad_to_deg(gp_w1.phi().value());
-  const float glob_theta1 = toolbox::rad_to_deg(gp_w1.theta().value());
-  const float glob_theta2 = has_wire_ambi ? toolbox::rad_to_deg(gp_w2.theta().value()) : 0.;
+  // The conversion to EMTF coordinates is done in finalize()
+  const GlobalPoint& gp_w1 = find_global_point(detgeom, detid_corr, digi_w1);
+  const GlobalPoint& gp_w2 = has_wire_ambi ? find_global_point(detgeom, detid_corr, digi_w2) : GlobalPoint{};
   const float glob_time = 0.;  // no fine resolution timing
-  const int ph = toolbox::calc_phi_int(glob_phi, sector);
-  const int th1 = toolbox::calc_theta_int(glob_theta1, endcap_pm);
-  const int th2 = has_wire_ambi ? toolbox::calc_theta_int(glob_theta2, endcap_pm) : 0;
-  emtf_assert((0 <= ph) and (ph < 5040));
-  emtf_assert((1 <= th1) and (th1 < 128));
-  emtf_assert((0 <= th2) and (th2 < 128));
 
   // Find EMTF variables
-  const int emtf_phi = find_emtf_phi{}(subsystem, ph);
   const int emtf_bend = find_emtf_bend{}(subsystem, tp_bend);
-  const int emtf_theta1 = find_emtf_theta{}(subsystem, th1);
-  const int emtf_theta2 = find_emtf_theta{}(subsystem, th2);
   const int emtf_qual1 = find_emtf_qual{}(subsystem, tp_quality);
   const int emtf_qual2 = tp_pattern;
   const int emtf_time = find_emtf_time{}(subsystem, tp_bx - bx, tp_subbx);
   const int emtf_site = find_emtf_site{}(subsystem, tp_station, tp_ring);
   const int emtf_host = find_emtf_host{}(subsystem, tp_station, tp_ring);
-  const int seg_zones = find_seg_zones{}(emtf_host, emtf_theta1, emtf_theta2);
   const int seg_timezones = find_seg_timezones{}(emtf_host, tp_bx - bx);
+  batch.push_back(
+      subsystem, emtf_host, gp_w1.phi().value(), gp_w1.theta().value(), gp_w2.theta().value(), has_wire_ambi);
 
   // Set all the variables
   hit.setRawDetId(detid.rawId());
@@ -531,7 +577,6 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setQuality(tp_quality);
   hit.setPattern(tp_pattern);
   hit.setNeighbor(is_neighbor);
-  hit.setZones(seg_zones);
   hit.setTimezones(seg_timezones);
   hit.setCscfr(tp_cscfr);
   hit.setGemdl(tp_layer);
@@ -539,32 +584,28 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setBx(bx);
   hit.setEmtfChamber(emtf_chamber);
   hit.setEmtfSegment(emtf_segment);
-  hit.setEmtfPhi(emtf_phi);
   hit.setEmtfBend(emtf_bend);
-  hit.setEmtfTheta1(emtf_theta1);
-  hit.setEmtfTheta2(emtf_theta2);
   hit.setEmtfQual1(emtf_qual1);
   hit.setEmtfQual2(emtf_qual2);
   hit.setEmtfTime(emtf_time);
   hit.setEmtfSite(emtf_site);
   hit.setEmtfHost(emtf_host);
-  hit.setGlobPhi(glob_phi);
-  hit.setGlobTheta(glob_theta1);
   hit.setGlobPerp(gp_w1.perp());
   hit.setGlobZ(gp_w1.z());
   hit.setGlobTime(glob_time);
   hit.setValid(tp_valid);
+  return strategy;
 }
 
-void SegmentFormatter::format_impl(int endcap,
-                                   int sector,
-                                   int bx,
-                                   int strategy,
-                                   const RPCGeometry& detgeom,
-                                   const rpc_subsystem_tag::detid_type& detid,
-                                   const rpc_subsystem_tag::digi_type& digi,
-                                   const ChamberInfo& chminfo,
-                                   EMTFHit& hit) const {
+int SegmentFormatter::format_impl(int endcap,
+                                  int sector,
+                                  int bx,
+                                  const RPCGeometry& detgeom,
+                                  const rpc_subsystem_tag::detid_type& detid,
+                                  const rpc_subsystem_tag::digi_type& digi,
+                                  const ChamberInfo& chminfo,
+                                  CoordinateBatch& batch,
+                                  EMTFHit& hit) const {
   static const int subsystem = L1TMuon::kRPC;
   static const int clus_width_cut = 4;
   static const int clus_width_cut_irpc = 6;
@@ -624,17 +665,13 @@ void SegmentFormatter::format_impl(int endcap,
     }
   }
 
-  // If strategy is 0, reject ring 3 (RE3/3, RE4/3); otherwise, accept ring 3
+  // Strategy 0 rejects ring 3 (RE3/3, RE4/3); strategy 1 accepts ring 3
   // (ring 3 gets a lower priority than ring 2)
-  if (strategy == 0) {
-    if (tp_ring == 3) {
-      tp_valid = false;
-    }
-  }
+  const int strategy = (tp_ring == 3) ? 1 : 0;
 
   // Rejected
   if (not tp_valid)
-    return;
+    return kInvalid;
 
   // Extract from detid (cont.)
   int tp_chamber = ((tp_sector_rpc - 1) * (is_irpc ? 3 : 6)) + tp_subsector_rpc;
@@ -651,23 +688,6 @@ void SegmentFormatter::format_impl(int endcap,
   }
   int tp_cscfr = toolbox::get_trigger_cscfr(tp_ring, tp_station, tp_chamber);
 
-  // Guard against unexpected data
-  // Do this at the first sector only
-  if ((endcap == 1) and (sector == 1) and (bx == 0)) {
-    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
-    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
-    emtf_assert((0 <= tp_subsector) and (tp_subsector <= 2));
-    emtf_assert((1 <= tp_station) and (tp_station <= 4));
-    emtf_assert((1 <= tp_ring) and (tp_ring <= 3));
-    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
-    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 9));
-    emtf_assert(((not is_irpc) and ((1 <= tp_strip) and (tp_strip <= 32))) or
-                (is_irpc and ((1 <= tp_strip) and (tp_strip <= 96))));
-    emtf_assert(((not is_irpc) and ((1 <= tp_roll) and (tp_roll <= 3))) or
-                (is_irpc and ((1 <= tp_roll) and (tp_roll <= 5))));
-    emtf_assert(tp_valid == true);
-  }
-
   // Assign chamber and segment numbers
   int emtf_chamber = kInvalid;
   int emtf_segment = kInvalid;
@@ -686,28 +706,21 @@ void SegmentFormatter::format_impl(int endcap,
 
   // Does not belong to this sector
   if (emtf_chamber == kInvalid)
-    return;
+    return kInvalid;
 
   // Get global coordinates and convert them
-  const GlobalPoint& gp = get_global_point(detgeom, detid, digi);
-  const float glob_phi = toolbox::rad_to_deg(gp.phi().value());
-  const float glob_theta = toolbox::rad_to_deg(gp.theta().value());
+  // The conversion to EMTF coordinates is done in finalize()
+  const GlobalPoint& gp = find_global_point(detgeom, detid, digi);
   const float glob_time = digi.time();
-  const int ph = toolbox::calc_phi_int(glob_phi, sector);
-  const int th = toolbox::calc_theta_int(glob_theta, endcap_pm);
-  emtf_assert((0 <= ph) and (ph < 5040));
-  emtf_assert((1 <= th) and (th < 128));
 
   // Find EMTF variables
-  const int emtf_phi = find_emtf_phi{}(subsystem, ph);
   const int emtf_bend = find_emtf_bend{}(subsystem, tp_bend);
-  const int emtf_theta = find_emtf_theta{}(subsystem, th);
   const int emtf_qual = find_emtf_qual{}(subsystem, tp_quality);
   const int emtf_time = find_emtf_time{}(subsystem, tp_bx - bx, tp_subbx);
   const int emtf_site = find_emtf_site{}(subsystem, tp_station, tp_ring);
   const int emtf_host = find_emtf_host{}(subsystem, tp_station, tp_ring);
-  const int seg_zones = find_seg_zones{}(emtf_host, emtf_theta);
   const int seg_timezones = find_seg_timezones{}(emtf_host, tp_bx - bx);
+  batch.push_back(subsystem, emtf_host, gp.phi().value(), gp.theta().value(), 0., false);
 
   // Set all the variables
   hit.setRawDetId(detid.rawId());
@@ -728,7 +741,6 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setQuality(tp_quality);
   hit.setPattern(0);
   hit.setNeighbor(is_neighbor);
-  hit.setZones(seg_zones);
   hit.setTimezones(seg_timezones);
   hit.setCscfr(tp_cscfr);
   hit.setGemdl(tp_layer);
@@ -736,32 +748,28 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setBx(bx);
   hit.setEmtfChamber(emtf_chamber);
   hit.setEmtfSegment(emtf_segment);
-  hit.setEmtfPhi(emtf_phi);
   hit.setEmtfBend(emtf_bend);
-  hit.setEmtfTheta1(emtf_theta);
-  hit.setEmtfTheta2(0);
   hit.setEmtfQual1(emtf_qual);
   hit.setEmtfQual2(0);
   hit.setEmtfTime(emtf_time);
   hit.setEmtfSite(emtf_site);
   hit.setEmtfHost(emtf_host);
-  hit.setGlobPhi(glob_phi);
-  hit.setGlobTheta(glob_theta);
   hit.setGlobPerp(gp.perp());
   hit.setGlobZ(gp.z());
   hit.setGlobTime(glob_time);
   hit.setValid(tp_valid);
+  return strategy;
 }
 
-void SegmentFormatter::format_impl(int endcap,
-                                   int sector,
-                                   int bx,
-                                   int strategy,
-                                   const GEMGeometry& detgeom,
-                                   const gem_subsystem_tag::detid_type& detid,
-                                   const gem_subsystem_tag::digi_type& digi,
-                                   const ChamberInfo& chminfo,
-                                   EMTFHit& hit) const {
+int SegmentFormatter::format_impl(int endcap,
+                                  int sector,
+                                  int bx,
+                                  const GEMGeometry& detgeom,
+                                  const gem_subsystem_tag::detid_type& detid,
+                                  const gem_subsystem_tag::digi_type& digi,
+                                  const ChamberInfo& chminfo,
+                                  CoordinateBatch& batch,
+                                  EMTFHit& hit) const {
   static const int subsystem = L1TMuon::kGEM;
   static const int max_delta_roll = 1;
   static const int max_delta_pad_ge11 = 4;
@@ -789,6 +797,7 @@ void SegmentFormatter::format_impl(int endcap,
   const bool is_ge21 = (tp_station == 2);
 
   // Reject if do not find coincidence
+  bool has_copad = tp_valid;
   if (tp_valid and (tp_layer == 1)) {  // layer 1 is used as incidence
     auto match_fn = [&tp_roll, &tp_pad_lo, &tp_pad_hi, &is_ge21](const ChamberInfo::copad_vec_t::value_type& elem) {
       // Compare roll and (pad_lo, pad_hi)-range with tolerance
@@ -801,16 +810,17 @@ void SegmentFormatter::format_impl(int endcap,
       return (tp_roll <= c_roll_hi) and (tp_roll >= c_roll_lo) and (tp_pad_lo <= c_pad_hi) and (tp_pad_hi >= c_pad_lo);
     };
     auto found = std::find_if(chminfo.copad_vec.begin(), chminfo.copad_vec.end(), match_fn);
-    bool has_copad = (found != chminfo.copad_vec.end());
-    bool kindof_has_copad = ((found != chminfo.copad_vec.end()) or chminfo.copad_vec.empty());
-    tp_valid = (strategy == 0) ? has_copad : kindof_has_copad;
+    // Strategy 0 requires a coincidence. Strategy 1 also accepts the segment if the chamber has no
+    // coincidence at all.
+    has_copad = (found != chminfo.copad_vec.end());
+    tp_valid = ((found != chminfo.copad_vec.end()) or chminfo.copad_vec.empty());
   } else if (tp_valid and (tp_layer == 2)) {  // layer 2 is used as coincidence
     tp_valid = false;
   }
 
   // Rejected
   if (not tp_valid)
-    return;
+    return kInvalid;
 
   // Extract from detid (cont.)
   int tp_sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
@@ -824,23 +834,6 @@ void SegmentFormatter::format_impl(int endcap,
   int tp_cscfr = toolbox::get_trigger_cscfr(tp_ring, tp_station, tp_chamber);
   int tp_subbx = 0;  // no fine resolution timing
 
-  // Guard against unexpected data
-  // Do this at the first sector only
-  if ((endcap == 1) and (sector == 1) and (bx == 0)) {
-    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
-    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
-    emtf_assert((0 <= tp_subsector) and (tp_subsector <= 2));
-    emtf_assert((1 <= tp_station) and (tp_station <= 2));
-    emtf_assert(tp_ring == 1);
-    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
-    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 3));
-    emtf_assert(((not is_ge21) and ((0 <= tp_pad) and (tp_pad < 192))) or
-                (is_ge21 and ((0 <= tp_pad) and (tp_pad < 384))));
-    emtf_assert(((not is_ge21) and ((1 <= tp_roll) and (tp_roll <= 8))) or
-                (is_ge21 and ((1 <= tp_roll) and (tp_roll <= 8))));
-    emtf_assert(tp_valid == true);
-  }
-
   // Assign chamber and segment numbers
   int emtf_chamber = kInvalid;
   int emtf_segment = kInvalid;
@@ -850,43 +843,42 @@ void SegmentFormatter::format_impl(int endcap,
   auto is_in_sector_fn = is_in_sector{endcap, sector};
   auto is_in_neighbor_sector_fn = is_in_neighbor_sector{endcap, sector};
 
-#ifdef EMTF_USE_CSC_BX0_ONLY
+  // Strategy 0 takes the segments from this BX only. Strategy 1 also takes the segments from
+  // the previous BX.
   const bool is_timely = is_in_bx_fn(tp_bx);
+#ifdef EMTF_USE_CSC_BX0_ONLY
+  const bool is_kindof_timely = is_timely;
   emtf_maybe_unused(is_kindof_in_bx_fn(tp_bx));
 #else
-  const bool is_timely = (strategy == 0) ? is_in_bx_fn(tp_bx) : is_kindof_in_bx_fn(tp_bx);
+  const bool is_kindof_timely = is_kindof_in_bx_fn(tp_bx);
 #endif
   const bool is_native = is_in_sector_fn(tp_endcap, tp_sector);
   const bool is_neighbor = is_in_neighbor_sector_fn(tp_endcap, tp_sector, tp_subsector, tp_station, tp_cscid);
 
-  if (is_timely and (is_native or is_neighbor)) {
+  if (is_kindof_timely and (is_native or is_neighbor)) {
     emtf_chamber = find_emtf_chamber{}(subsystem, tp_subsector, tp_station, tp_cscid, is_neighbor);
   }
 
   // Does not belong to this sector
   if (emtf_chamber == kInvalid)
-    return;
+    return kInvalid;
+
+  // Accepted by strategy 1 only if late by one BX or without coincidence
+  const int strategy = (is_timely and has_copad) ? 0 : 1;
 
   // Get global coordinates and convert them
-  const GlobalPoint& gp = get_global_point(detgeom, detid, digi);
-  const float glob_phi = toolbox::rad_to_deg(gp.phi().value());
-  const float glob_theta = toolbox::rad_to_deg(gp.theta().value());
+  // The conversion to EMTF coordinates is done in finalize()
+  const GlobalPoint& gp = find_global_point(detgeom, detid, digi);
   const float glob_time = 0.;  // no fine resolution timing
-  const int ph = toolbox::calc_phi_int(glob_phi, sector);
-  const int th = toolbox::calc_theta_int(glob_theta, endcap_pm);
-  emtf_assert((0 <= ph) and (ph < 5040));
-  emtf_assert((1 <= th) and (th < 128));
 
   // Find EMTF variables
-  const int emtf_phi = find_emtf_phi{}(subsystem, ph);
   const int emtf_bend = find_emtf_bend{}(subsystem, tp_bend);
-  const int emtf_theta = find_emtf_theta{}(subsystem, th);
   const int emtf_qual = find_emtf_qual{}(subsystem, tp_quality);
   const int emtf_time = find_emtf_time{}(subsystem, tp_bx - bx, tp_subbx);
   const int emtf_site = find_emtf_site{}(subsystem, tp_station, tp_ring);
   const int emtf_host = find_emtf_host{}(subsystem, tp_station, tp_ring);
-  const int seg_zones = find_seg_zones{}(emtf_host, emtf_theta);
   const int seg_timezones = find_seg_timezones{}(emtf_host, tp_bx - bx);
+  batch.push_back(subsystem, emtf_host, gp.phi().value(), gp.theta().value(), 0., false);
 
   // Set all the variables
   hit.setRawDetId(detid.rawId());
@@ -907,7 +899,6 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setQuality(tp_quality);
   hit.setPattern(0);
   hit.setNeighbor(is_neighbor);
-  hit.setZones(seg_zones);
   hit.setTimezones(seg_timezones);
   hit.setCscfr(tp_cscfr);
   hit.setGemdl(tp_layer);
@@ -915,32 +906,28 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setBx(bx);
   hit.setEmtfChamber(emtf_chamber);
   hit.setEmtfSegment(emtf_segment);
-  hit.setEmtfPhi(emtf_phi);
   hit.setEmtfBend(emtf_bend);
-  hit.setEmtfTheta1(emtf_theta);
-  hit.setEmtfTheta2(0);
   hit.setEmtfQual1(emtf_qual);
   hit.setEmtfQual2(0);
   hit.setEmtfTime(emtf_time);
   hit.setEmtfSite(emtf_site);
   hit.setEmtfHost(emtf_host);
-  hit.setGlobPhi(glob_phi);
-  hit.setGlobTheta(glob_theta);
   hit.setGlobPerp(gp.perp());
   hit.setGlobZ(gp.z());
   hit.setGlobTime(glob_time);
   hit.setValid(tp_valid);
+  return strategy;
 }
 
-void SegmentFormatter::format_impl(int endcap,
-                                   int sector,
-                                   int bx,
-                                   int strategy,
-                                   const ME0Geometry& detgeom,
-                                   const me0_subsystem_tag::detid_type& detid,
-                                   const me0_subsystem_tag::digi_type& digi,
-                                   const ChamberInfo& chminfo,
-                                   EMTFHit& hit) const {
+int SegmentFormatter::format_impl(int endcap,
+                                  int sector,
+                                  int bx,
+                                  const ME0Geometry& detgeom,
+                                  const me0_subsystem_tag::detid_type& detid,
+                                  const me0_subsystem_tag::digi_type& digi,
+                                  const ChamberInfo& chminfo,
+                                  CoordinateBatch& batch,
+                                  EMTFHit& hit) const {
   static const int subsystem = L1TMuon::kME0;
   static const int me0_bx_shift = -CSCConstants::LCT_CENTRAL_BX;
   static const int me0_max_partition = 9;  // limited to eta of 2.4
@@ -1000,7 +987,7 @@ void SegmentFormatter::format_impl(int endcap,
 
   // Rejected
   if (not tp_valid)
-    return;
+    return kInvalid;
 
   // Extract from detid (cont.)
   int tp_sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
@@ -1011,21 +998,6 @@ void SegmentFormatter::format_impl(int endcap,
   int tp_cscfr = toolbox::get_trigger_cscfr(tp_ring, tp_station, tp_chamber);
   int tp_subbx = 0;  // no fine resolution timing
 
-  // Guard against unexpected data
-  // Do this at the first sector only
-  if ((endcap == 1) and (sector == 1) and (bx == 0)) {
-    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
-    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
-    emtf_assert((1 <= tp_subsector) and (tp_subsector <= 2));
-    emtf_assert(tp_station == 1);
-    emtf_assert(tp_ring == 4);
-    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
-    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 3));
-    emtf_assert((0 <= tp_phiposition) and (tp_phiposition < 768));
-    emtf_assert((0 <= tp_partition) and (tp_partition < 16));
-    emtf_assert(tp_valid == true);
-  }
-
   // Assign chamber and segment numbers
   int emtf_chamber = kInvalid;
   int emtf_segment = kInvalid;
@@ -1044,28 +1016,21 @@ void SegmentFormatter::format_impl(int endcap,
 
   // Does not belong to this sector
   if (emtf_chamber == kInvalid)
-    return;
+    return kInvalid;
 
   // Get global coordinates and convert them
-  const GlobalPoint& gp = get_global_point(detgeom, detid, digi);
-  const float glob_phi = toolbox::rad_to_deg(gp.phi().value());
-  const float glob_theta = toolbox::rad_to_deg(gp.theta().value());
+  // The conversion to EMTF coordinates is done in finalize()
+  const GlobalPoint& gp = find_global_point(detgeom, detid, digi);
   const float glob_time = 0.;  // no fine resolution timing
-  const int ph = toolbox::calc_phi_int(glob_phi, sector);
-  const int th = toolbox::calc_theta_int(glob_theta, endcap_pm);
-  emtf_assert((0 <= ph) and (ph < 5040));
-  emtf_assert((1 <= th) and (th < 128));
 
   // Find EMTF variables
-  const int emtf_phi = find_emtf_phi{}(subsystem, ph);
   const int emtf_bend = find_emtf_bend{}(subsystem, tp_bend);
-  const int emtf_theta = find_emtf_theta{}(subsystem, th);
   const int emtf_qual = find_emtf_qual{}(subsystem, tp_quality);
   const int emtf_time = find_emtf_time{}(subsystem, tp_bx - bx, tp_subbx);
   const int emtf_site = find_emtf_site{}(subsystem, tp_station, tp_ring);
   const int emtf_host = find_emtf_host{}(subsystem, tp_station, tp_ring);
-  const int seg_zones = find_seg_zones{}(emtf_host, emtf_theta);
   const int seg_timezones = find_seg_timezones{}(emtf_host, tp_bx - bx);
+  batch.push_back(subsystem, emtf_host, gp.phi().value(), gp.theta().value(), 0., false);
 
   // Set all the variables
   hit.setRawDetId(detid.rawId());
@@ -1086,7 +1051,6 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setQuality(tp_quality);
   hit.setPattern(0);
   hit.setNeighbor(is_neighbor);
-  hit.setZones(seg_zones);
   hit.setTimezones(seg_timezones);
   hit.setCscfr(tp_cscfr);
   hit.setGemdl(tp_layer);
@@ -1094,24 +1058,93 @@ void SegmentFormatter::format_impl(int endcap,
   hit.setBx(bx);
   hit.setEmtfChamber(emtf_chamber);
   hit.setEmtfSegment(emtf_segment);
-  hit.setEmtfPhi(emtf_phi);
   hit.setEmtfBend(emtf_bend);
-  hit.setEmtfTheta1(emtf_theta);
-  hit.setEmtfTheta2(0);
   hit.setEmtfQual1(emtf_qual);
   hit.setEmtfQual2(0);
   hit.setEmtfTime(emtf_time);
   hit.setEmtfSite(emtf_site);
   hit.setEmtfHost(emtf_host);
-  hit.setGlobPhi(glob_phi);
-  hit.setGlobTheta(glob_theta);
   hit.setGlobPerp(gp.perp());
   hit.setGlobZ(gp.z());
   hit.setGlobTime(glob_time);
   hit.setValid(tp_valid);
+  return 0;  // default strategy
 }
 
 // _____________________________________________________________________________
+void SegmentFormatter::CoordinateBatch::clear() {
+  subsystem_.clear();
+  emtf_host_.clear();
+  phi_.clear();
+  theta1_.clear();
+  theta2_.clear();
+  has_theta2_.clear();
+}
+
+void SegmentFormatter::CoordinateBatch::push_back(
+    int subsystem, int emtf_host, float phi, float theta1, float theta2, bool has_theta2) {
+  subsystem_.push_back(subsystem);
+  emtf_host_.push_back(emtf_host);
+  phi_.push_back(phi);
+  theta1_.push_back(theta1);
+  theta2_.push_back(theta2);
+  has_theta2_.push_back(has_theta2);
+}
+
+void SegmentFormatter::finalize(int endcap, int sector, CoordinateBatch& batch, EMTFHitCollection& hits) const {
+  emtf_assert(batch.size() == hits.size());
+
+  const int endcap_pm = (endcap == 2) ? -1 : endcap;  // using endcap [-1,+1] convention
+  const std::size_t n = batch.size();
+
+  // Convert all the global coordinates at once
+  batch.ph_.resize(n);
+  batch.th1_.resize(n);
+  batch.th2_.resize(n);
+  toolbox::rad_to_deg(batch.phi_.data(), batch.phi_.data(), n);
+  toolbox::rad_to_deg(batch.theta1_.data(), batch.theta1_.data(), n);
+  toolbox::rad_to_deg(batch.theta2_.data(), batch.theta2_.data(), n);
+  toolbox::calc_phi_int(batch.phi_.data(), sector, batch.ph_.data(), n);
+  toolbox::calc_theta_int(batch.theta1_.data(), endcap_pm, batch.th1_.data(), n);
+  toolbox::calc_theta_int(batch.theta2_.data(), endcap_pm, batch.th2_.data(), n);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const int subsystem = batch.subsystem_[i];
+    const int ph = batch.ph_[i];
+    const int th1 = batch.th1_[i];
+    const int th2 = batch.has_theta2_[i] ? batch.th2_[i] : 0;
+    emtf_assert((0 <= ph) and (ph < 5040));
+    emtf_assert((1 <= th1) and (th1 < 128));
+    emtf_assert((0 <= th2) and (th2 < 128));
+
+    // Find EMTF variables
+    const int emtf_phi = find_emtf_phi{}(subsystem, ph);
+    const int emtf_theta1 = find_emtf_theta{}(subsystem, th1);
+    const int emtf_theta2 = find_emtf_theta{}(subsystem, th2);
+    const int seg_zones = find_seg_zones{}(batch.emtf_host_[i], emtf_theta1, emtf_theta2);
+
+    // Set the remaining variables
+    EMTFHit& hit = hits[i];
+    hit.setZones(seg_zones);
+    hit.setEmtfPhi(emtf_phi);
+    hit.setEmtfTheta1(emtf_theta1);
+    hit.setEmtfTheta2(emtf_theta2);
+    hit.setGlobPhi(batch.phi_[i]);
+    hit.setGlobTheta(batch.theta1_[i]);
+  }  // end loop
+}
+
+// _____________________________________________________________________________
+// Use the precomputed tables if available, and fall back to the geometry otherwise
+template <typename G, typename D, typename T>
+GlobalPoint SegmentFormatter::find_global_point(const G& detgeom, const D& detid, const T& digi) const {
+  GlobalPoint gp;
+  if ((coord_lut_ != nullptr) and coord_lut_->get_global_point(detid, digi, gp)) {
+    return gp;
+  }
+  return get_global_point(detgeom, detid, digi);
+}
+
 GlobalPoint SegmentFormatter::get_global_point(const CSCGeometry& detgeom,
                                                const csc_subsystem_tag::detid_type& detid,
                                                const csc_subsystem_tag::digi_type& digi) const {
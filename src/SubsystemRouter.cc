@@ -0,0 +1,309 @@
+#include "L1Trigger/Phase2L1EMTF/interface/SubsystemRouter.h"
+
+#include "L1Trigger/CSCCommonTrigger/interface/CSCConstants.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/Toolbox.h"
+
+using namespace emtf::phase2;
+
+SubsystemRouter::SubsystemRouter(int min_bx, int max_bx) : min_bx_(min_bx), max_bx_(max_bx) {
+  const int num_bx = (max_bx_ >= min_bx_) ? (max_bx_ - min_bx_ + 1) : 0;
+  buckets_.resize(NUM_TRIGSECTORS * num_bx);
+}
+
+SubsystemRouter::~SubsystemRouter() {}
+
+std::size_t SubsystemRouter::Bucket::size() const {
+  std::size_t sz = 0;
+  for (const auto& routes : routes_) {
+    sz += routes.size();
+  }
+  return sz;
+}
+
+// _____________________________________________________________________________
+template <typename T>
+void SubsystemRouter::route_impl(const SubsystemCollection& muon_primitives) {
+  const auto& primitives = muon_primitives.get<T>();
+
+  // Loop over the primitives of this subsystem
+  for (unsigned iprim = 0; iprim < primitives.size(); ++iprim) {
+    Destination dest;
+    if (find_destination(primitives[iprim].detid, primitives[iprim].digi(), dest)) {
+      fill(T::index, iprim, dest);
+    }
+  }  // end loop
+}
+
+void SubsystemRouter::route(const SubsystemCollection& muon_primitives) {
+  for (auto&& bucket : buckets_) {
+    for (auto&& routes : bucket.routes_) {
+      routes.clear();
+    }
+  }
+
+  route_impl<csc_subsystem_tag>(muon_primitives);
+  route_impl<rpc_subsystem_tag>(muon_primitives);
+  route_impl<gem_subsystem_tag>(muon_primitives);
+  route_impl<me0_subsystem_tag>(muon_primitives);
+}
+
+const SubsystemRouter::bucket_t& SubsystemRouter::get_bucket(int endcap, int sector, int bx) const {
+  return buckets_.at(get_index(endcap, sector, bx));
+}
+
+// _____________________________________________________________________________
+// The sector and BX assignment below must follow SegmentFormatter::format_impl(). A primitive
+// that is routed to a bucket can still be rejected by the formatter, but a primitive that is
+// not routed to a bucket is never seen by that sector.
+//
+// Every primitive goes through here exactly once per event, so this is also where the primitives
+// are guarded against unexpected data. Invalid primitives are skipped, as they are rejected by
+// the formatter anyway.
+
+bool SubsystemRouter::find_destination(const csc_subsystem_tag::detid_type& detid,
+                                       const csc_subsystem_tag::digi_type& digi,
+                                       Destination& dest) const {
+  static const int csc_bx_shift = -CSCConstants::LCT_CENTRAL_BX;
+
+  const int tp_station = detid.station();
+  const int tp_subsector = toolbox::get_trigger_subsector(tp_station, detid.chamber());
+  const int tp_cscid = digi.getCSCID();
+
+  // Guard against unexpected data
+  if (digi.isValid()) {
+    const int tp_endcap = detid.endcap();
+    const int tp_sector = detid.triggerSector();
+    const int tp_chamber = detid.chamber();
+    const int tp_wire = digi.getKeyWG();  // wiregroup
+    const int tp_pattern = digi.getPattern();
+
+    // Apply ME1/1a -> ring 4 convention
+    int tp_ring = detid.ring();
+    int tp_strip = digi.getStrip();  // halfstrip
+    if ((tp_station == 1) and (tp_ring == 1) and (tp_strip >= 128)) {
+      tp_ring = 4;
+      tp_strip -= 128;
+    }
+
+    const auto [max_strip, max_wire] = toolbox::get_csc_max_strip_and_wire(tp_station, tp_ring);
+    const auto [max_pattern, max_quality] = toolbox::get_csc_max_pattern_and_quality(tp_station, tp_ring);
+    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
+    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
+    emtf_assert((0 <= tp_subsector) and (tp_subsector <= 2));
+    emtf_assert((1 <= tp_station) and (tp_station <= 4));
+    emtf_assert((1 <= tp_ring) and (tp_ring <= 4));
+    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
+    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 9));
+    emtf_assert((0 <= tp_strip) and (tp_strip < max_strip));
+    emtf_assert((0 <= tp_wire) and (tp_wire < max_wire));
+    emtf_assert((2 <= tp_pattern) and (tp_pattern < max_pattern));
+    emtf_maybe_unused(tp_endcap);
+    emtf_maybe_unused(tp_sector);
+    emtf_maybe_unused(tp_chamber);
+    emtf_maybe_unused(tp_strip);
+    emtf_maybe_unused(tp_wire);
+    emtf_maybe_unused(tp_pattern);
+    emtf_maybe_unused(max_strip);
+    emtf_maybe_unused(max_wire);
+    emtf_maybe_unused(max_pattern);
+    emtf_maybe_unused(max_quality);
+  }
+
+  dest.endcap = detid.endcap();
+  dest.sector = detid.triggerSector();
+  dest.bx = static_cast<int>(digi.getBX()) + csc_bx_shift;
+  dest.is_shared = is_shared_chamber(tp_subsector, tp_station, tp_cscid);
+#ifdef EMTF_USE_CSC_BX0_ONLY
+  dest.is_delayed = false;
+#else
+  dest.is_delayed = true;
+#endif
+  return true;
+}
+
+bool SubsystemRouter::find_destination(const rpc_subsystem_tag::detid_type& detid,
+                                       const rpc_subsystem_tag::digi_type& digi,
+                                       Destination& dest) const {
+  const int tp_region = detid.region();  // 0: barrel, +/-1: endcap
+
+  // Barrel RPC is always rejected
+  if (tp_region == 0)
+    return false;
+
+  const int tp_station = detid.station();
+  const int tp_ring = detid.ring();
+  const bool is_irpc = ((tp_station >= 3) and (tp_ring == 1));
+  const int tp_chamber = ((detid.sector() - 1) * (is_irpc ? 3 : 6)) + detid.subsector();
+  const int tp_subsector = toolbox::get_trigger_subsector(tp_station, tp_chamber);
+  const int tp_cscid = toolbox::get_trigger_cscid(tp_ring, tp_station, tp_chamber);
+
+  // Guard against unexpected data
+  {
+    const int tp_endcap = (tp_region == -1) ? 2 : tp_region;
+    const int tp_sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
+    const int tp_roll = detid.roll();
+    const int tp_strip = (2 * digi.firstClusterStrip() + digi.clusterSize() - 1) / 2;
+    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
+    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
+    emtf_assert((0 <= tp_subsector) and (tp_subsector <= 2));
+    emtf_assert((1 <= tp_station) and (tp_station <= 4));
+    emtf_assert((1 <= tp_ring) and (tp_ring <= 3));
+    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
+    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 9));
+    emtf_assert(((not is_irpc) and ((1 <= tp_strip) and (tp_strip <= 32))) or
+                (is_irpc and ((1 <= tp_strip) and (tp_strip <= 96))));
+    emtf_assert(((not is_irpc) and ((1 <= tp_roll) and (tp_roll <= 3))) or
+                (is_irpc and ((1 <= tp_roll) and (tp_roll <= 5))));
+    emtf_maybe_unused(tp_endcap);
+    emtf_maybe_unused(tp_sector);
+    emtf_maybe_unused(tp_roll);
+    emtf_maybe_unused(tp_strip);
+  }
+
+  dest.endcap = (tp_region == -1) ? 2 : tp_region;
+  dest.sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
+  dest.bx = digi.BunchX();
+  dest.is_shared = is_shared_chamber(tp_subsector, tp_station, tp_cscid);
+  dest.is_delayed = false;
+  return true;
+}
+
+bool SubsystemRouter::find_destination(const gem_subsystem_tag::detid_type& detid,
+                                       const gem_subsystem_tag::digi_type& digi,
+                                       Destination& dest) const {
+  const int tp_region = detid.region();  // 0: barrel, +/-1: endcap
+  const int tp_station = detid.station();
+  const int tp_ring = detid.ring();
+  const int tp_chamber = detid.chamber();
+  const int tp_subsector = toolbox::get_trigger_subsector(tp_station, tp_chamber);
+  const int tp_cscid = toolbox::get_trigger_cscid(tp_ring, tp_station, tp_chamber);
+
+  // Guard against unexpected data
+  if (digi.isValid()) {
+    const int tp_endcap = (tp_region == -1) ? 2 : tp_region;
+    const int tp_sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
+    const int tp_roll = detid.roll();
+    const int tp_pad = (digi.pads().front() + digi.pads().back()) / 2;
+    const bool is_ge21 = (tp_station == 2);
+    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
+    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
+    emtf_assert((0 <= tp_subsector) and (tp_subsector <= 2));
+    emtf_assert((1 <= tp_station) and (tp_station <= 2));
+    emtf_assert(tp_ring == 1);
+    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
+    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 3));
+    emtf_assert(((not is_ge21) and ((0 <= tp_pad) and (tp_pad < 192))) or
+                (is_ge21 and ((0 <= tp_pad) and (tp_pad < 384))));
+    emtf_assert((1 <= tp_roll) and (tp_roll <= 8));
+    emtf_maybe_unused(tp_endcap);
+    emtf_maybe_unused(tp_sector);
+    emtf_maybe_unused(tp_roll);
+    emtf_maybe_unused(tp_pad);
+    emtf_maybe_unused(is_ge21);
+  }
+
+  dest.endcap = (tp_region == -1) ? 2 : tp_region;
+  dest.sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
+  dest.bx = digi.bx();
+  dest.is_shared = is_shared_chamber(tp_subsector, tp_station, tp_cscid);
+#ifdef EMTF_USE_CSC_BX0_ONLY
+  dest.is_delayed = false;
+#else
+  dest.is_delayed = true;
+#endif
+  return true;
+}
+
+bool SubsystemRouter::find_destination(const me0_subsystem_tag::detid_type& detid,
+                                       const me0_subsystem_tag::digi_type& digi,
+                                       Destination& dest) const {
+  static const int me0_bx_shift = -CSCConstants::LCT_CENTRAL_BX;
+  static const int me0_nstrips = 384;
+  static const int me0_nphipositions = me0_nstrips * 2;
+
+  const int tp_region = detid.region();  // 0: barrel, +/-1: endcap
+  const int tp_endcap = (tp_region == -1) ? 2 : tp_region;
+  const int tp_station = detid.station();
+  const int tp_ring = 4;
+  const int tp_phiposition = digi.getPhiposition();  // in half-strip unit
+
+  // Split 20-deg chamber into 10-deg chamber (same as SegmentFormatter)
+  int tp_chamber = (detid.chamber() - 1) * 2 + 1;
+  {
+    const int phiposition_q1 = me0_nphipositions / 4;
+    const int phiposition_q3 = (me0_nphipositions / 4) * 3;
+    if (tp_phiposition < phiposition_q1) {
+      tp_chamber = (tp_endcap == 1) ? toolbox::next_csc_chamber_10deg(tp_chamber)
+                                    : toolbox::prev_csc_chamber_10deg(tp_chamber);
+    } else if (tp_phiposition < phiposition_q3) {
+      // Do nothing
+    } else {
+      tp_chamber = (tp_endcap == 1) ? toolbox::prev_csc_chamber_10deg(tp_chamber)
+                                    : toolbox::next_csc_chamber_10deg(tp_chamber);
+    }
+  }
+
+  const int tp_subsector = toolbox::get_trigger_subsector(tp_station, tp_chamber);
+  const int tp_cscid = toolbox::get_trigger_cscid(tp_ring, tp_station, tp_chamber);
+
+  // Guard against unexpected data
+  if (digi.isValid()) {
+    const int tp_sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
+    const int tp_partition = digi.getPartition();  // in half-roll unit
+    emtf_assert((MIN_ENDCAP <= tp_endcap) and (tp_endcap <= MAX_ENDCAP));
+    emtf_assert((MIN_TRIGSECTOR <= tp_sector) and (tp_sector <= MAX_TRIGSECTOR));
+    emtf_assert((1 <= tp_subsector) and (tp_subsector <= 2));
+    emtf_assert(tp_station == 1);
+    emtf_assert((1 <= tp_chamber) and (tp_chamber <= 36));
+    emtf_assert((1 <= tp_cscid) and (tp_cscid <= 3));
+    emtf_assert((0 <= tp_phiposition) and (tp_phiposition < me0_nphipositions));
+    emtf_assert((0 <= tp_partition) and (tp_partition < 16));
+    emtf_maybe_unused(tp_sector);
+    emtf_maybe_unused(tp_partition);
+  }
+
+  dest.endcap = tp_endcap;
+  dest.sector = toolbox::get_trigger_sector(tp_ring, tp_station, tp_chamber);
+  dest.bx = static_cast<int>(digi.getBX()) + me0_bx_shift;
+  dest.is_shared = is_shared_chamber(tp_subsector, tp_station, tp_cscid);
+  dest.is_delayed = false;
+  return true;
+}
+
+bool SubsystemRouter::is_shared_chamber(int tp_subsector, int tp_station, int tp_cscid) const {
+  // Same as the chamber condition in SegmentFormatter::is_in_neighbor_sector
+  bool cond_me1 =
+      (tp_station == 1) and (tp_subsector == 2) and ((tp_cscid == 3) or (tp_cscid == 6) or (tp_cscid == 9));
+  bool cond_non_me1 = (tp_station != 1) and ((tp_cscid == 3) or (tp_cscid == 9));
+  return cond_me1 or cond_non_me1;
+}
+
+void SubsystemRouter::fill(int subsystem, unsigned iprim, const Destination& dest) {
+  if (not((MIN_ENDCAP <= dest.endcap) and (dest.endcap <= MAX_ENDCAP)))
+    return;
+  if (not((MIN_TRIGSECTOR <= dest.sector) and (dest.sector <= MAX_TRIGSECTOR)))
+    return;
+
+  const int num_delays = dest.is_delayed ? 2 : 1;
+
+  for (int delay = 0; delay < num_delays; ++delay) {
+    const int bx = dest.bx + delay;  // add +1 delay
+    if (not((min_bx_ <= bx) and (bx <= max_bx_)))
+      continue;
+
+    const Route route{iprim, (delay != 0)};
+    buckets_[get_index(dest.endcap, dest.sector, bx)].routes_[subsystem].push_back(route);
+    if (dest.is_shared) {
+      buckets_[get_index(dest.endcap, toolbox::next_trigger_sector(dest.sector), bx)].routes_[subsystem].push_back(
+          route);
+    }
+  }
+}
+
+unsigned SubsystemRouter::get_index(int endcap, int sector, int bx) const {
+  constexpr int num_sectors_per_endcap = NUM_TRIGSECTORS / 2;
+  const int num_bx = max_bx_ - min_bx_ + 1;
+  const int isector = ((endcap - MIN_ENDCAP) * num_sectors_per_endcap) + (sector - MIN_TRIGSECTOR);
+  return static_cast<unsigned>((isector * num_bx) + (bx - min_bx_));
+}
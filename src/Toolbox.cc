@@ -1,5 +1,13 @@
 #include "L1Trigger/Phase2L1EMTF/interface/Toolbox.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define EMTF_TOOLBOX_USE_SIMD
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define EMTF_TOOLBOX_USE_SIMD
+#endif
+
 namespace emtf {
 
   namespace phase2 {
@@ -209,6 +217,149 @@ namespace emtf {
         }
       }
 
+      // _______________________________________________________________________
+      // The SIMD versions follow the scalar versions operation by operation, including the
+      // float <-> double conversions, so that the results are bit-exact. They process 4 values at
+      // a time. With AVX2, the double precision steps use one 256-bit register instead of two.
+
+#ifdef EMTF_TOOLBOX_USE_SIMD
+      namespace {
+
+        // Same as std::round(): round half away from zero
+        inline __m128 round_half_away(__m128 x) {
+          const __m128 sign_mask = _mm_set1_ps(-0.f);
+          const __m128 t = _mm_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+          const __m128 frac = _mm_andnot_ps(sign_mask, _mm_sub_ps(x, t));            // exact
+          const __m128 one = _mm_or_ps(_mm_set1_ps(1.f), _mm_and_ps(sign_mask, x));  // copysign(1, x)
+          return _mm_add_ps(t, _mm_and_ps(_mm_cmpge_ps(frac, _mm_set1_ps(0.5f)), one));
+        }
+
+#if defined(__AVX2__)
+        struct Double4 {
+          __m256d v;
+        };
+
+        inline Double4 to_double4(__m128 x) { return {_mm256_cvtps_pd(x)}; }
+
+        inline __m128 to_float4(Double4 x) { return _mm256_cvtpd_ps(x.v); }
+
+        inline Double4 add(Double4 a, double b) { return {_mm256_add_pd(a.v, _mm256_set1_pd(b))}; }
+
+        inline Double4 sub(Double4 a, double b) { return {_mm256_sub_pd(a.v, _mm256_set1_pd(b))}; }
+
+        inline Double4 sub(double a, Double4 b) { return {_mm256_sub_pd(_mm256_set1_pd(a), b.v)}; }
+
+        inline Double4 mul(Double4 a, double b) { return {_mm256_mul_pd(a.v, _mm256_set1_pd(b))}; }
+
+        inline Double4 div(Double4 a, double b) { return {_mm256_div_pd(a.v, _mm256_set1_pd(b))}; }
+
+        // (cond < 0) ? a : b
+        inline Double4 select_negative(Double4 cond, Double4 a, Double4 b) {
+          const __m256d mask = _mm256_cmp_pd(cond.v, _mm256_setzero_pd(), _CMP_LT_OQ);
+          return {_mm256_blendv_pd(b.v, a.v, mask)};
+        }
+#else
+        struct Double4 {
+          __m128d lo;
+          __m128d hi;
+        };
+
+        inline Double4 to_double4(__m128 x) { return {_mm_cvtps_pd(x), _mm_cvtps_pd(_mm_movehl_ps(x, x))}; }
+
+        inline __m128 to_float4(Double4 x) { return _mm_movelh_ps(_mm_cvtpd_ps(x.lo), _mm_cvtpd_ps(x.hi)); }
+
+        inline Double4 add(Double4 a, double b) {
+          const __m128d vb = _mm_set1_pd(b);
+          return {_mm_add_pd(a.lo, vb), _mm_add_pd(a.hi, vb)};
+        }
+
+        inline Double4 sub(Double4 a, double b) {
+          const __m128d vb = _mm_set1_pd(b);
+          return {_mm_sub_pd(a.lo, vb), _mm_sub_pd(a.hi, vb)};
+        }
+
+        inline Double4 sub(double a, Double4 b) {
+          const __m128d va = _mm_set1_pd(a);
+          return {_mm_sub_pd(va, b.lo), _mm_sub_pd(va, b.hi)};
+        }
+
+        inline Double4 mul(Double4 a, double b) {
+          const __m128d vb = _mm_set1_pd(b);
+          return {_mm_mul_pd(a.lo, vb), _mm_mul_pd(a.hi, vb)};
+        }
+
+        inline Double4 div(Double4 a, double b) {
+          const __m128d vb = _mm_set1_pd(b);
+          return {_mm_div_pd(a.lo, vb), _mm_div_pd(a.hi, vb)};
+        }
+
+        // (cond < 0) ? a : b
+        inline Double4 select_negative(Double4 cond, Double4 a, Double4 b) {
+          const __m128d zero = _mm_setzero_pd();
+          return {_mm_blendv_pd(b.lo, a.lo, _mm_cmplt_pd(cond.lo, zero)),
+                  _mm_blendv_pd(b.hi, a.hi, _mm_cmplt_pd(cond.hi, zero))};
+        }
+#endif  // __AVX2__ is defined
+
+      }  // namespace
+#endif  // EMTF_TOOLBOX_USE_SIMD is defined
+
+      void rad_to_deg(const float* rad, float* deg, std::size_t n) {
+        std::size_t i = 0;
+#ifdef EMTF_TOOLBOX_USE_SIMD
+        constexpr float factor = 180. / M_PI;  // same as the scalar version
+        const __m128 vfactor = _mm_set1_ps(factor);
+        for (; (i + 4) <= n; i += 4) {
+          _mm_storeu_ps(deg + i, _mm_mul_ps(_mm_loadu_ps(rad + i), vfactor));
+        }
+#endif
+        for (; i < n; ++i) {
+          deg[i] = rad_to_deg(rad[i]);
+        }
+      }
+
+      void calc_theta_int(const float* theta, int endcap, int* theta_int, std::size_t n) {
+        std::size_t i = 0;
+#ifdef EMTF_TOOLBOX_USE_SIMD
+        const __m128i one = _mm_set1_epi32(1);
+        for (; (i + 4) <= n; i += 4) {
+          __m128 x = _mm_loadu_ps(theta + i);
+          if (endcap == -1) {
+            x = to_float4(sub(180., to_double4(x)));
+          }
+          x = to_float4(div(mul(sub(to_double4(x), 8.5), 128.), (45.0 - 8.5)));
+          __m128i r = _mm_cvttps_epi32(round_half_away(x));
+          r = _mm_max_epi32(r, one);  // protect against invalid value
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(theta_int + i), r);
+        }
+#endif
+        for (; i < n; ++i) {
+          theta_int[i] = calc_theta_int(theta[i], endcap);
+        }
+      }
+
+      void calc_phi_int(const float* glob, int sector, int* phi_int, std::size_t n) {
+        std::size_t i = 0;
+#ifdef EMTF_TOOLBOX_USE_SIMD
+        constexpr float twopi = 360.;  // same as wrap_phi_deg()
+        constexpr float recip = 1.0 / twopi;
+        const __m128 vtwopi = _mm_set1_ps(twopi);
+        const __m128 vrecip = _mm_set1_ps(recip);
+        const double offset = 60. * (sector - 1);
+        for (; (i + 4) <= n; i += 4) {
+          __m128 x = _mm_loadu_ps(glob + i);
+          x = _mm_sub_ps(x, _mm_mul_ps(round_half_away(_mm_mul_ps(x, vrecip)), vtwopi));
+          Double4 loc = to_double4(to_float4(sub(sub(to_double4(x), 15.), offset)));
+          loc = to_double4(to_float4(select_negative(add(loc, 22.), add(loc, 360.), loc)));
+          x = to_float4(mul(add(loc, 22.), 60.));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(phi_int + i), _mm_cvttps_epi32(round_half_away(x)));
+        }
+#endif
+        for (; i < n; ++i) {
+          phi_int[i] = calc_phi_int(glob[i], sector);
+        }
+      }
+
     }  // namespace toolbox
 
   }  // namespace phase2
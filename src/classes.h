@@ -0,0 +1,3 @@
+#include "DataFormats/Common/interface/Wrapper.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFPackedHit.h"
@@ -14,4 +14,10 @@
 #include "emtf_hlslib/duperemoval.h"
 #include "emtf_hlslib/fullyconnect.h"
 
+#ifndef __SYNTHESIS__
+// CPU implementations
+#include "emtf_hlslib/zoning_bitset.h"
+#include "emtf_hlslib/pooling_bitset.h"
+#endif  // __SYNTHESIS__ not defined
+
 #endif  // __EMTF_HLSLIB_H__ not defined
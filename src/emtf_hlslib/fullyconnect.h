@@ -40,17 +40,17 @@ namespace emtf_hlslib {
       const unsigned int N = detail::nnet_num_outbound_nodes_traits<Category>::value;
 
 #ifndef __SYNTHESIS__
-      static bool initialized = false;
-      static weight_t weights[N];
+      typedef detail::static_nnet_weights<weight_t, N, detail::get_nnet_weights_op<Category> > weights_table_t;
+      const weight_t(&weights)[N] = weights_table_t::instance.data;
 #else
       bool initialized = false;
       weight_t weights[N];
-#endif  // __SYNTHESIS__ not defined
 
       if (!initialized) {
         initialized = true;
         detail::init_nnet_weights_op<N>(weights, detail::get_nnet_weights_op<Category>());
       }
+#endif  // __SYNTHESIS__ not defined
 
       ap_fixed<T_IN::width, T_IN::width> in0_cast[N];  // cast from ap_int to ap_fixed
 
@@ -68,20 +68,21 @@ namespace emtf_hlslib {
       const unsigned int N = detail::nnet_num_outbound_nodes_traits<Category>::value;
 
 #ifndef __SYNTHESIS__
-      static bool initialized = false;
-      static weight_t weights[M * N];
-      static bias_t biases[N];
+      typedef detail::static_nnet_weights<weight_t, M * N, detail::get_nnet_weights_op<Category> > weights_table_t;
+      typedef detail::static_nnet_weights<bias_t, N, detail::get_nnet_biases_op<Category> > biases_table_t;
+      const weight_t(&weights)[M * N] = weights_table_t::instance.data;
+      const bias_t(&biases)[N] = biases_table_t::instance.data;
 #else
       bool initialized = false;
       weight_t weights[M * N];
       bias_t biases[N];
-#endif  // __SYNTHESIS__ not defined
 
       if (!initialized) {
         initialized = true;
         detail::init_nnet_weights_op<M * N>(weights, detail::get_nnet_weights_op<Category>());
         detail::init_nnet_weights_op<N>(biases, detail::get_nnet_biases_op<Category>());
       }
+#endif  // __SYNTHESIS__ not defined
 
       detail::mat_vec_mult_biasadd_op<M, N>(in0, weights, biases, out);
     }
@@ -95,20 +96,21 @@ namespace emtf_hlslib {
       const unsigned int N = detail::nnet_num_outbound_nodes_traits<Category>::value;
 
 #ifndef __SYNTHESIS__
-      static bool initialized = false;
-      static weight_t weights[M * N];
-      static bias_t biases[N];
+      typedef detail::static_nnet_weights<weight_t, M * N, detail::get_nnet_weights_op<Category> > weights_table_t;
+      typedef detail::static_nnet_weights<bias_t, N, detail::get_nnet_biases_op<Category> > biases_table_t;
+      const weight_t(&weights)[M * N] = weights_table_t::instance.data;
+      const bias_t(&biases)[N] = biases_table_t::instance.data;
 #else
       bool initialized = false;
       weight_t weights[M * N];
       bias_t biases[N];
-#endif  // __SYNTHESIS__ not defined
 
       if (!initialized) {
         initialized = true;
         detail::init_nnet_weights_op<M * N>(weights, detail::get_nnet_weights_op<Category>());
         detail::init_nnet_weights_op<N>(biases, detail::get_nnet_biases_op<Category>());
       }
+#endif  // __SYNTHESIS__ not defined
 
       emtf_assert(N == 1);
       detail::vec_vec_mult_biasadd_op<M>(in0, weights, biases[0], out[0]);
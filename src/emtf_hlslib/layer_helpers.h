@@ -1048,6 +1048,37 @@ namespace emtf_hlslib {
         }
       }
 
+#ifndef __SYNTHESIS__
+      // Helper class to hold a lookup table in the CPU build
+      // Note: The table is a static data member, so it is filled once during static initialization
+      // and can then be read by concurrent callers without a guard. The ops only read constexpr
+      // arrays, so the order of initialization does not matter.
+      template <typename T, unsigned int N, typename U>
+      struct static_lookup_table {
+        T data[N];
+
+        static_lookup_table() { init_table_op<N>(data, U{}); }
+
+        static const static_lookup_table instance;
+      };
+
+      template <typename T, unsigned int N, typename U>
+      const static_lookup_table<T, N, U> static_lookup_table<T, N, U>::instance;
+
+      // Helper class to hold a 2D lookup table in the CPU build
+      template <typename T, unsigned int M, unsigned int N, typename U>
+      struct static_2d_lookup_table {
+        T data[M * N];
+
+        static_2d_lookup_table() { init_2d_table_op<M, N>(data, U{}); }
+
+        static const static_2d_lookup_table instance;
+      };
+
+      template <typename T, unsigned int M, unsigned int N, typename U>
+      const static_2d_lookup_table<T, M, N, U> static_2d_lookup_table<T, M, N, U>::instance;
+#endif  // __SYNTHESIS__ not defined
+
       // Helper function to force registering
       template <typename T>
       T force_reg(const T& x) {
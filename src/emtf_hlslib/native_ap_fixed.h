@@ -0,0 +1,443 @@
+// CPU implementation of the Xilinx HLS arbitrary precision fixed-point types (ap_fixed, ap_ufixed).
+//
+// The raw bits are stored in an ap_int_base of the same width (see native_ap_int.h), so a value is
+// a native int16/int32/int64 scaled by 2^-(W-I). The results of the arithmetic operators have the
+// full precision, with the same widths as Xilinx. The quantization and the overflow handling are
+// only applied on assignment, following the Q and O modes of the destination type.
+//
+// Only the types up to 64 bits are implemented. All the quantization modes are supported. The
+// overflow modes AP_WRAP (with N = 0), AP_SAT and AP_SAT_ZERO are supported.
+//
+// The types are declared in the emtf_hlslib::native namespace. They are brought into the global
+// namespace (replacing ap_fixed.h) when EMTF_HLSLIB_NATIVE_TYPES is defined.
+
+#ifndef __EMTF_HLSLIB_NATIVE_AP_FIXED_H__
+#define __EMTF_HLSLIB_NATIVE_AP_FIXED_H__
+
+#include "native_ap_int.h"
+
+namespace emtf_hlslib {
+
+  namespace native {
+
+    // Quantization modes
+    enum ap_q_mode { AP_RND, AP_RND_ZERO, AP_RND_MIN_INF, AP_RND_INF, AP_RND_CONV, AP_TRN, AP_TRN_ZERO };
+
+    // Overflow modes
+    enum ap_o_mode { AP_SAT, AP_SAT_ZERO, AP_SAT_SYM, AP_WRAP, AP_WRAP_SM };
+
+    template <int W, int I, bool S, ap_q_mode Q, ap_o_mode O, int N>
+    class ap_fixed_base;
+
+    namespace detail {
+
+      // Drop the d lowest bits (d > 0) of raw, rounding as specified by Q
+      template <ap_q_mode Q>
+      wide_t quantize(wide_t raw, int d) {
+        d = AP_MIN(d, 100);  // |raw| < 2^65, so the result does not change beyond this
+        const wide_t fl = (raw >> d);
+        const wide_t rem = raw - (fl * (wide_t(1) << d));  // 0 <= rem < 2^d
+        const wide_t half = (wide_t(1) << (d - 1));
+        const bool odd = (fl & 1);
+        bool up = false;
+
+        switch (Q) {
+          case AP_RND:  // round half to plus infinity
+            up = (rem >= half);
+            break;
+          case AP_RND_ZERO:  // round half to zero
+            up = (rem > half) or ((rem == half) and (raw < 0));
+            break;
+          case AP_RND_MIN_INF:  // round half to minus infinity
+            up = (rem > half);
+            break;
+          case AP_RND_INF:  // round half away from zero
+            up = (rem > half) or ((rem == half) and (raw >= 0));
+            break;
+          case AP_RND_CONV:  // round half to even
+            up = (rem > half) or ((rem == half) and odd);
+            break;
+          case AP_TRN:  // truncate to minus infinity
+            up = false;
+            break;
+          case AP_TRN_ZERO:  // truncate to zero
+            up = (rem != 0) and (raw < 0);
+            break;
+        }
+        return up ? (fl + 1) : fl;
+      }
+
+      // Fit the integer r into W bits, as specified by O
+      template <int W, bool S, ap_o_mode O>
+      wide_t overflow(wide_t r) {
+        const wide_t max_v = S ? ((wide_t(1) << (W - 1)) - 1) : ((wide_t(1) << W) - 1);
+        const wide_t min_v = S ? -(wide_t(1) << (W - 1)) : wide_t(0);
+        if constexpr (O == AP_SAT) {
+          return (r > max_v) ? max_v : ((r < min_v) ? min_v : r);
+        } else if constexpr (O == AP_SAT_ZERO) {
+          return ((r > max_v) or (r < min_v)) ? wide_t(0) : r;
+        } else {
+          return r;  // wrapped when stored
+        }
+      }
+
+      // Maps the operands of the binary operators to ap_fixed_base. An ap_int_base or a C integer is
+      // used as a fixed-point number without fractional bits.
+      template <int W, int I, bool S, ap_q_mode Q, ap_o_mode O, int N>
+      ap_fixed_base<W, I, S, AP_TRN, AP_WRAP, 0> fixed_base_of(const ap_fixed_base<W, I, S, Q, O, N>*);
+      void fixed_base_of(...);
+
+      template <typename T, typename Enable = void>
+      struct fixed_operand {
+        static const bool value = false;
+        static const bool is_fixed = false;
+      };
+
+      template <typename T>
+      struct fixed_operand<
+          T,
+          typename std::enable_if<not std::is_void<decltype(fixed_base_of(static_cast<const T*>(nullptr)))>::value>::type> {
+        typedef decltype(fixed_base_of(static_cast<const T*>(nullptr))) type;
+        static const bool value = true;
+        static const bool is_fixed = true;
+        static const T& get(const T& x) { return x; }
+      };
+
+      template <typename T>
+      struct fixed_operand<T, typename std::enable_if<int_operand<T>::value>::type> {
+        typedef typename int_operand<T>::type int_type;
+        typedef ap_fixed_base<int_type::width, int_type::width, int_type::sign_flag, AP_TRN, AP_WRAP, 0> type;
+        static const bool value = true;
+        static const bool is_fixed = false;
+        static type get(const T& x) { return type(int_operand<T>::get(x)); }
+      };
+
+      template <typename A, typename B>
+      struct is_fixed_binary {
+        static const bool value = (fixed_operand<A>::value and fixed_operand<B>::value and
+                                   (fixed_operand<A>::is_fixed or fixed_operand<B>::is_fixed));
+      };
+
+      // Return types of the binary operators, same as Xilinx
+      template <int W1, int I1, bool S1, int W2, int I2, bool S2>
+      struct fixed_rtype {
+        enum {
+          F1 = W1 - I1,
+          F2 = W2 - I2,
+          mult_w = W1 + W2,
+          mult_i = I1 + I2,
+          mult_s = S1 || S2,
+          plus_i = AP_MAX(I1 + (S2 && !S1), I2 + (S1 && !S2)) + 1,
+          plus_w = plus_i + AP_MAX(F1, F2),
+          plus_s = S1 || S2,
+          minus_i = plus_i,
+          minus_w = plus_w,
+          minus_s = true,
+          logic_i = AP_MAX(I1 + (S2 && !S1), I2 + (S1 && !S2)),
+          logic_w = logic_i + AP_MAX(F1, F2),
+          logic_s = S1 || S2
+        };
+        typedef ap_fixed_base<mult_w, mult_i, mult_s, AP_TRN, AP_WRAP, 0> mult;
+        typedef ap_fixed_base<plus_w, plus_i, plus_s, AP_TRN, AP_WRAP, 0> plus;
+        typedef ap_fixed_base<minus_w, minus_i, minus_s, AP_TRN, AP_WRAP, 0> minus;
+        typedef ap_fixed_base<logic_w, logic_i, logic_s, AP_TRN, AP_WRAP, 0> logic;
+      };
+
+      template <typename A, typename B>
+      struct fixed_binary_rtype {
+        typedef typename fixed_operand<A>::type a_type;
+        typedef typename fixed_operand<B>::type b_type;
+        typedef fixed_rtype<a_type::width, a_type::iwidth, a_type::sign_flag, b_type::width, b_type::iwidth, b_type::sign_flag>
+            type;
+      };
+
+    }  // namespace detail
+
+    // _____________________________________________________________________________
+    // Base class of ap_fixed and ap_ufixed
+    template <int W, int I, bool S, ap_q_mode Q, ap_o_mode O, int N>
+    class ap_fixed_base {
+    public:
+      static_assert(W >= 1 and W <= 64, "W must be between 1 and 64");
+      static_assert(O == AP_WRAP || O == AP_SAT || O == AP_SAT_ZERO, "overflow mode not implemented");
+      static_assert(O != AP_WRAP || N == 0, "saturation bits not implemented");
+
+      static const int width = W;
+      static const int iwidth = I;
+      static const int fwidth = W - I;
+      static const bool sign_flag = S;
+      static const ap_q_mode qmode = Q;
+      static const ap_o_mode omode = O;
+
+      typedef detail::word_t word_t;
+      typedef detail::wide_t wide_t;
+
+      // Constructors
+      ap_fixed_base() : V() {}
+
+      template <int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2, int N2>
+      ap_fixed_base(const ap_fixed_base<W2, I2, S2, Q2, O2, N2>& op) {
+        set_value(op.V.value(), W2 - I2);
+      }
+
+      template <int W2, bool S2>
+      ap_fixed_base(const ap_int_base<W2, S2>& op) {
+        set_value(op.value(), 0);
+      }
+
+      template <int W2, bool S2>
+      ap_fixed_base(const ap_range_ref<W2, S2>& op) {
+        set_value(op.get().value(), 0);
+      }
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_fixed_base(C op) {
+        set_value(static_cast<wide_t>(op), 0);
+      }
+
+      // The value of the double is exact before the quantization
+      ap_fixed_base(double op) {
+        if (not std::isfinite(op)) {
+          V = 0;
+          return;
+        }
+        const double x = std::ldexp(op, W - I);
+        double fl = std::floor(x);
+        const double rem = x - fl;  // exact, 0 <= rem < 1
+        const bool odd = (std::fmod(fl, 2.) != 0.);
+        bool up = false;
+
+        switch (Q) {
+          case AP_RND:
+            up = (rem >= 0.5);
+            break;
+          case AP_RND_ZERO:
+            up = (rem > 0.5) or ((rem == 0.5) and (x < 0));
+            break;
+          case AP_RND_MIN_INF:
+            up = (rem > 0.5);
+            break;
+          case AP_RND_INF:
+            up = (rem > 0.5) or ((rem == 0.5) and (x >= 0));
+            break;
+          case AP_RND_CONV:
+            up = (rem > 0.5) or ((rem == 0.5) and odd);
+            break;
+          case AP_TRN:
+            up = false;
+            break;
+          case AP_TRN_ZERO:
+            up = (rem != 0.) and (x < 0);
+            break;
+        }
+        if (up)
+          fl += 1.;
+
+        wide_t r;
+        if (std::fabs(fl) < 0x1p100) {
+          r = static_cast<wide_t>(fl);
+        } else if (O == AP_WRAP) {
+          r = static_cast<wide_t>(std::fmod(fl, 0x1p64));  // same lowest W bits
+        } else {
+          r = (fl < 0) ? -(wide_t(1) << 100) : (wide_t(1) << 100);
+        }
+        V.set_word0(static_cast<word_t>(detail::overflow<W, S, O>(r)));
+      }
+
+      ap_fixed_base(float op) : ap_fixed_base(static_cast<double>(op)) {}
+
+      // Arithmetic assignment
+      template <typename T>
+      ap_fixed_base& operator+=(const T& op) {
+        return *this = (*this + op);
+      }
+      template <typename T>
+      ap_fixed_base& operator-=(const T& op) {
+        return *this = (*this - op);
+      }
+      template <typename T>
+      ap_fixed_base& operator*=(const T& op) {
+        return *this = (*this * op);
+      }
+
+      // Unary operators
+      ap_fixed_base operator+() const { return *this; }
+
+      ap_fixed_base<W + 1, I + 1, true, AP_TRN, AP_WRAP, 0> operator-() const {
+        ap_fixed_base<W + 1, I + 1, true, AP_TRN, AP_WRAP, 0> r;
+        r.V = -V;
+        return r;
+      }
+
+      bool operator!() const { return V.iszero(); }
+
+      // Bit and range select, on the raw bits
+      ap_bit_ref<W, S> operator[](int index) { return V[index]; }
+      bool operator[](int index) const { return V[index]; }
+
+      ap_range_ref<W, S> range(int hi, int lo) const { return V.range(hi, lo); }
+      ap_range_ref<W, S> range() const { return V.range(); }
+
+      // Conversions
+      int length() const { return W; }
+      double to_double() const { return std::ldexp(static_cast<double>(V.value()), -(W - I)); }
+      float to_float() const { return static_cast<float>(to_double()); }
+      operator long double() const { return to_double(); }
+
+      // Set from the integer raw with F1 fractional bits
+      void set_value(wide_t raw, int F1) {
+        const int d = F1 - (W - I);
+        wide_t r;
+        if (d > 0) {
+          r = detail::quantize<Q>(raw, d);
+        } else if (-d < 62) {
+          r = raw * (wide_t(1) << (-d));
+        } else {
+          // Nothing left in the lowest W bits
+          r = (raw == 0) ? 0 : ((O == AP_WRAP) ? 0 : ((raw < 0) ? -(wide_t(1) << 100) : (wide_t(1) << 100)));
+        }
+        V.set_word0(static_cast<word_t>(detail::overflow<W, S, O>(r)));
+      }
+
+      // The raw bits
+      ap_int_base<W, S> V;
+    };
+
+    // _____________________________________________________________________________
+    // Binary operators
+    template <typename A, typename B, typename std::enable_if<detail::is_fixed_binary<A, B>::value, int>::type = 0>
+    typename detail::fixed_binary_rtype<A, B>::type::mult operator*(const A& a, const B& b) {
+      typedef typename detail::fixed_binary_rtype<A, B>::type::mult result_type;
+      const auto& x = detail::fixed_operand<A>::get(a);
+      const auto& y = detail::fixed_operand<B>::get(b);
+      result_type r;
+      r.V = x.V * y.V;
+      return r;
+    }
+
+#define EMTF_HLSLIB_NATIVE_FIXED_ALIGNED_OP(OP, NAME)                                                          \
+  template <typename A, typename B, typename std::enable_if<detail::is_fixed_binary<A, B>::value, int>::type = 0> \
+  typename detail::fixed_binary_rtype<A, B>::type::NAME operator OP(const A& a, const B& b) {                  \
+    typedef typename detail::fixed_binary_rtype<A, B>::type::NAME result_type;                                 \
+    typedef typename detail::fixed_operand<A>::type a_type;                                                    \
+    typedef typename detail::fixed_operand<B>::type b_type;                                                    \
+    const auto& x = detail::fixed_operand<A>::get(a);                                                          \
+    const auto& y = detail::fixed_operand<B>::get(b);                                                          \
+    result_type r;                                                                                             \
+    r.V = (ap_int_base<result_type::width, result_type::sign_flag>(x.V)                                        \
+           << (result_type::fwidth - a_type::fwidth))                                                          \
+        OP(ap_int_base<result_type::width, result_type::sign_flag>(y.V) << (result_type::fwidth - b_type::fwidth)); \
+    return r;                                                                                                  \
+  }
+
+    EMTF_HLSLIB_NATIVE_FIXED_ALIGNED_OP(+, plus)
+    EMTF_HLSLIB_NATIVE_FIXED_ALIGNED_OP(-, minus)
+    EMTF_HLSLIB_NATIVE_FIXED_ALIGNED_OP(&, logic)
+    EMTF_HLSLIB_NATIVE_FIXED_ALIGNED_OP(|, logic)
+    EMTF_HLSLIB_NATIVE_FIXED_ALIGNED_OP(^, logic)
+
+#undef EMTF_HLSLIB_NATIVE_FIXED_ALIGNED_OP
+
+    // The values are compared after aligning the binary points
+#define EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP(OP)                                                             \
+  template <typename A, typename B, typename std::enable_if<detail::is_fixed_binary<A, B>::value, int>::type = 0> \
+  bool operator OP(const A& a, const B& b) {                                                                  \
+    typedef typename detail::fixed_operand<A>::type a_type;                                                    \
+    typedef typename detail::fixed_operand<B>::type b_type;                                                    \
+    constexpr int F = AP_MAX(a_type::fwidth, b_type::fwidth);                                                  \
+    const auto& x = detail::fixed_operand<A>::get(a);                                                          \
+    const auto& y = detail::fixed_operand<B>::get(b);                                                          \
+    const ap_int_base<a_type::width + F - a_type::fwidth, a_type::sign_flag> xx =                              \
+        ap_int_base<a_type::width + F - a_type::fwidth, a_type::sign_flag>(x.V) << (F - a_type::fwidth);      \
+    const ap_int_base<b_type::width + F - b_type::fwidth, b_type::sign_flag> yy =                              \
+        ap_int_base<b_type::width + F - b_type::fwidth, b_type::sign_flag>(y.V) << (F - b_type::fwidth);      \
+    return xx OP yy;                                                                                           \
+  }
+
+    EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP(==)
+    EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP(!=)
+    EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP(<)
+    EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP(>)
+    EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP(<=)
+    EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP(>=)
+
+#undef EMTF_HLSLIB_NATIVE_FIXED_RELATIONAL_OP
+
+    template <int W, int I, bool S, ap_q_mode Q, ap_o_mode O, int N>
+    std::ostream& operator<<(std::ostream& os, const ap_fixed_base<W, I, S, Q, O, N>& op) {
+      return os << op.to_double();
+    }
+
+    // _____________________________________________________________________________
+    // Signed and unsigned fixed-point numbers
+    template <int W, int I, ap_q_mode Q = AP_TRN, ap_o_mode O = AP_WRAP, int N = 0>
+    class ap_fixed : public ap_fixed_base<W, I, true, Q, O, N> {
+    public:
+      typedef ap_fixed_base<W, I, true, Q, O, N> Base;
+
+      ap_fixed() : Base() {}
+
+      template <int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2, int N2>
+      ap_fixed(const ap_fixed_base<W2, I2, S2, Q2, O2, N2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_fixed(const ap_int_base<W2, S2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_fixed(const ap_range_ref<W2, S2>& op) : Base(op) {}
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_fixed(C op) : Base(op) {}
+
+      ap_fixed(double op) : Base(op) {}
+      ap_fixed(float op) : Base(op) {}
+    };
+
+    template <int W, int I, ap_q_mode Q = AP_TRN, ap_o_mode O = AP_WRAP, int N = 0>
+    class ap_ufixed : public ap_fixed_base<W, I, false, Q, O, N> {
+    public:
+      typedef ap_fixed_base<W, I, false, Q, O, N> Base;
+
+      ap_ufixed() : Base() {}
+
+      template <int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2, int N2>
+      ap_ufixed(const ap_fixed_base<W2, I2, S2, Q2, O2, N2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_ufixed(const ap_int_base<W2, S2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_ufixed(const ap_range_ref<W2, S2>& op) : Base(op) {}
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_ufixed(C op) : Base(op) {}
+
+      ap_ufixed(double op) : Base(op) {}
+      ap_ufixed(float op) : Base(op) {}
+    };
+
+  }  // namespace native
+
+}  // namespace emtf_hlslib
+
+#ifdef EMTF_HLSLIB_NATIVE_TYPES
+using emtf_hlslib::native::ap_fixed;
+using emtf_hlslib::native::ap_fixed_base;
+using emtf_hlslib::native::ap_o_mode;
+using emtf_hlslib::native::ap_q_mode;
+using emtf_hlslib::native::ap_ufixed;
+using emtf_hlslib::native::AP_RND;
+using emtf_hlslib::native::AP_RND_CONV;
+using emtf_hlslib::native::AP_RND_INF;
+using emtf_hlslib::native::AP_RND_MIN_INF;
+using emtf_hlslib::native::AP_RND_ZERO;
+using emtf_hlslib::native::AP_SAT;
+using emtf_hlslib::native::AP_SAT_SYM;
+using emtf_hlslib::native::AP_SAT_ZERO;
+using emtf_hlslib::native::AP_TRN;
+using emtf_hlslib::native::AP_TRN_ZERO;
+using emtf_hlslib::native::AP_WRAP;
+using emtf_hlslib::native::AP_WRAP_SM;
+#endif  // EMTF_HLSLIB_NATIVE_TYPES defined
+
+#endif  // __EMTF_HLSLIB_NATIVE_AP_FIXED_H__ not defined
@@ -0,0 +1,1139 @@
+// CPU implementation of the Xilinx HLS arbitrary precision integer types (ap_int, ap_uint).
+//
+// The types up to 64 bits are stored in a native int16/int32/int64 (uint16/uint32/uint64 when
+// unsigned), so that the arithmetic, .range(), bit select and concatenation compile to a few
+// integer instructions. The wider types (e.g. the 288-bit zoning images) are stored as arrays of
+// 64-bit words. The value is always kept canonical: sign-extended (signed) or zero-extended
+// (unsigned) from bit W-1, so the explicit masking only happens on assignment.
+//
+// The semantics follow the Xilinx C simulation model: the widths and signedness of the results
+// of the arithmetic operators, truncation on assignment, the reversed range when hi < lo, the
+// runtime length of a range in a concatenation, the comparison rules for mixed signedness, and
+// the conversion to the smallest C integer type that holds W bits.
+//
+// Only the operations used by emtf_hlslib are implemented. The multiplication is limited to
+// 128-bit results, and the division and modulo to 64-bit operands.
+//
+// The types are declared in the emtf_hlslib::native namespace. They are brought into the global
+// namespace (replacing ap_int.h) when EMTF_HLSLIB_NATIVE_TYPES is defined.
+
+#ifndef __EMTF_HLSLIB_NATIVE_AP_INT_H__
+#define __EMTF_HLSLIB_NATIVE_AP_INT_H__
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#ifndef AP_MAX
+#define AP_MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif  // AP_MAX not defined
+#ifndef AP_MIN
+#define AP_MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif  // AP_MIN not defined
+
+namespace emtf_hlslib {
+
+  namespace native {
+
+    template <int W, bool S>
+    class ap_int_base;
+
+    template <int W, bool S>
+    class ap_range_ref;
+
+    template <int W, bool S>
+    class ap_bit_ref;
+
+    template <int W>
+    class ap_concat_ref;
+
+    namespace detail {
+
+      typedef uint64_t word_t;
+      typedef __int128 wide_t;
+      typedef unsigned __int128 uwide_t;
+
+      // Mask of the n lowest bits, 0 <= n <= 64
+      constexpr word_t low_mask(int n) { return (n >= 64) ? ~word_t(0) : ((word_t(1) << n) - 1); }
+
+      // Storage of the narrow types
+      template <int W, bool S>
+      struct narrow_storage {
+        typedef typename std::conditional<
+            (W <= 16),
+            typename std::conditional<S, int16_t, uint16_t>::type,
+            typename std::conditional<(W <= 32),
+                                      typename std::conditional<S, int32_t, uint32_t>::type,
+                                      typename std::conditional<S, int64_t, uint64_t>::type>::type>::type type;
+      };
+
+      // Storage of the wide types
+      template <int W>
+      struct wide_storage {
+        word_t w[(W + 63) / 64];
+      };
+
+      template <int W, bool S>
+      struct storage {
+        typedef typename std::conditional<(W <= 64), typename narrow_storage<W, S>::type, wide_storage<W> >::type type;
+      };
+
+      // C type returned by the implicit conversion, chosen by number of bytes as in Xilinx
+      template <int W, bool S>
+      struct ret_type {
+        typedef typename std::conditional<
+            (W <= 8),
+            typename std::conditional<S, signed char, unsigned char>::type,
+            typename std::conditional<
+                (W <= 16),
+                typename std::conditional<S, short, unsigned short>::type,
+                typename std::conditional<(W <= 32),
+                                          typename std::conditional<S, int, unsigned int>::type,
+                                          typename std::conditional<S, long long, unsigned long long>::type>::type>::
+                type>::type type;
+      };
+
+      // Placeholder for the implicit conversion of the wide types
+      struct no_conversion {};
+
+      // Width and signedness of the ap_int_base that represents an integral C type
+      template <typename C>
+      struct c_int_traits {
+        static const bool is_bool = std::is_same<typename std::remove_cv<C>::type, bool>::value;
+        static const int width = is_bool ? 1 : static_cast<int>(sizeof(C) * 8);
+        static const bool sign = is_bool ? false : std::is_signed<C>::value;
+      };
+
+      template <typename C>
+      constexpr bool is_negative(C op) {
+        if constexpr (c_int_traits<C>::sign) {
+          return op < 0;
+        } else {
+          return false;
+        }
+      }
+
+      // Maps the operands of the binary operators to ap_int_base.
+      // ap_int_base (and the derived ap_int, ap_uint, ap_concat_ref) are used as they are, a range is
+      // read as an unsigned value of the width of its variable, a C integer as the ap_int_base of
+      // the same width and signedness.
+      template <int W, bool S>
+      ap_int_base<W, S> base_of(const ap_int_base<W, S>*);
+      void base_of(...);
+
+      template <typename T, typename Enable = void>
+      struct int_operand {
+        static const bool value = false;
+        static const bool is_c_type = false;
+      };
+
+      template <typename T>
+      struct int_operand<T, typename std::enable_if<not std::is_void<decltype(base_of(static_cast<const T*>(nullptr)))>::value>::type> {
+        typedef decltype(base_of(static_cast<const T*>(nullptr))) type;
+        static const bool value = true;
+        static const bool is_c_type = false;
+        static const type& get(const T& x) { return x; }
+      };
+
+      template <int W, bool S>
+      struct int_operand<ap_range_ref<W, S>, void> {
+        typedef ap_int_base<W, false> type;
+        static const bool value = true;
+        static const bool is_c_type = false;
+        static type get(const ap_range_ref<W, S>& x) { return x.get(); }
+      };
+
+      template <typename C>
+      struct int_operand<C, typename std::enable_if<std::is_integral<C>::value>::type> {
+        typedef ap_int_base<c_int_traits<C>::width, c_int_traits<C>::sign> type;
+        static const bool value = true;
+        static const bool is_c_type = true;
+        static type get(const C& x) { return type(x); }
+      };
+
+      template <typename A, typename B>
+      struct is_int_binary {
+        static const bool value = (int_operand<A>::value and int_operand<B>::value and
+                                   not(int_operand<A>::is_c_type and int_operand<B>::is_c_type));
+      };
+
+      // Return types of the binary operators, same as Xilinx
+      template <int W1, bool S1, int W2, bool S2>
+      struct rtype {
+        enum {
+          mult_w = W1 + W2,
+          mult_s = S1 || S2,
+          plus_w = AP_MAX(W1 + (S2 && !S1), W2 + (S1 && !S2)) + 1,
+          plus_s = S1 || S2,
+          minus_w = AP_MAX(W1 + (S2 && !S1), W2 + (S1 && !S2)) + 1,
+          minus_s = true,
+          div_w = W1 + S2,
+          div_s = S1 || S2,
+          mod_w = AP_MIN(W1, W2 + (!S2 && S1)),
+          mod_s = S1,
+          logic_w = AP_MAX(W1 + (S2 && !S1), W2 + (S1 && !S2)),
+          logic_s = S1 || S2
+        };
+        typedef ap_int_base<mult_w, mult_s> mult;
+        typedef ap_int_base<plus_w, plus_s> plus;
+        typedef ap_int_base<minus_w, minus_s> minus;
+        typedef ap_int_base<div_w, div_s> div;
+        typedef ap_int_base<mod_w, mod_s> mod;
+        typedef ap_int_base<logic_w, logic_s> logic;
+      };
+
+      template <typename A, typename B>
+      struct binary_rtype {
+        typedef typename int_operand<A>::type a_type;
+        typedef typename int_operand<B>::type b_type;
+        typedef rtype<a_type::width, a_type::sign_flag, b_type::width, b_type::sign_flag> type;
+      };
+
+      // Three-way comparison. The equality is exact. For the ordering, a signed and an unsigned
+      // operand are compared as unsigned when the unsigned operand is at least as wide as the
+      // signed one (as in C), otherwise the comparison is exact.
+      template <int W1, bool S1, int W2, bool S2>
+      int compare(const ap_int_base<W1, S1>& a, const ap_int_base<W2, S2>& b, bool ordering) {
+        constexpr bool as_unsigned = (S1 != S2) and ((S1 and W2 >= W1) or (S2 and W1 >= W2));
+        constexpr int max_w = AP_MAX(W1 + (S1 || S2), W2 + (S1 || S2));
+
+        if (ordering and as_unsigned) {
+          // Compare modulo 2^max_w
+          if constexpr (W1 <= 64 and W2 <= 64) {
+            const uwide_t mask = (max_w == 128) ? ~uwide_t(0) : ((uwide_t(1) << max_w) - 1);
+            const uwide_t x = static_cast<uwide_t>(a.value()) & mask;
+            const uwide_t y = static_cast<uwide_t>(b.value()) & mask;
+            return (x < y) ? -1 : ((x > y) ? 1 : 0);
+          } else {
+            constexpr int n = (max_w + 63) / 64;
+            for (int i = n - 1; i >= 0; --i) {
+              const word_t m = (i == n - 1) ? low_mask(max_w - (64 * i)) : ~word_t(0);
+              const word_t x = a.word(i) & m;
+              const word_t y = b.word(i) & m;
+              if (x != y)
+                return (x < y) ? -1 : 1;
+            }
+            return 0;
+          }
+        }
+
+        if constexpr (W1 <= 64 and W2 <= 64) {
+          const wide_t x = a.value();
+          const wide_t y = b.value();
+          return (x < y) ? -1 : ((x > y) ? 1 : 0);
+        } else {
+          // Compare the infinite two's complement representations, starting from the sign word
+          constexpr int n = AP_MAX((W1 + 63) / 64, (W2 + 63) / 64) + 1;
+          const int64_t xs = static_cast<int64_t>(a.word(n - 1));
+          const int64_t ys = static_cast<int64_t>(b.word(n - 1));
+          if (xs != ys)
+            return (xs < ys) ? -1 : 1;
+          for (int i = n - 2; i >= 0; --i) {
+            const word_t x = a.word(i);
+            const word_t y = b.word(i);
+            if (x != y)
+              return (x < y) ? -1 : 1;
+          }
+          return 0;
+        }
+      }
+
+    }  // namespace detail
+
+    // _____________________________________________________________________________
+    // Base class of ap_int and ap_uint
+    template <int W, bool S>
+    class ap_int_base {
+    public:
+      static_assert(W >= 1, "W must be positive");
+
+      static const int width = W;
+      static const bool sign_flag = S;
+      static const bool is_narrow = (W <= 64);
+      static const int num_words = (W + 63) / 64;
+
+      typedef typename detail::storage<W, S>::type storage_type;
+      typedef typename std::conditional<is_narrow, typename detail::ret_type<W, S>::type, detail::no_conversion>::type
+          RetType;
+      typedef detail::word_t word_t;
+      typedef detail::wide_t wide_t;
+
+      // Constructors
+      ap_int_base() : V() {}
+
+      template <int W2, bool S2>
+      ap_int_base(const ap_int_base<W2, S2>& op) {
+        set_words([&op](int i) { return op.word(i); });
+      }
+
+      template <int W2, bool S2>
+      ap_int_base(const ap_range_ref<W2, S2>& op) {
+        const ap_int_base<W2, false> tmp = op.get();
+        set_words([&tmp](int i) { return tmp.word(i); });
+      }
+
+      template <int W2, bool S2>
+      ap_int_base(const ap_bit_ref<W2, S2>& op) {
+        set_c_int(static_cast<word_t>(op.get()), false);
+      }
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_int_base(C op) {
+        set_c_int(static_cast<word_t>(op), detail::is_negative(op));
+      }
+
+      // Truncated towards zero, then wrapped
+      ap_int_base(double op) {
+        const double t = std::trunc(op);
+        if (not std::isfinite(t)) {
+          set_c_int(0, false);
+        } else if (std::fabs(t) < 0x1p63) {
+          set_c_int(static_cast<word_t>(static_cast<int64_t>(t)), (t < 0));
+        } else {
+          double m = std::fmod(t, 0x1p64);
+          if (m < 0)
+            m += 0x1p64;
+          set_c_int(static_cast<word_t>(m), (t < 0));
+        }
+      }
+
+      ap_int_base(float op) : ap_int_base(static_cast<double>(op)) {}
+
+      // Conversion to the C integer type with the same number of bytes. There is no implicit
+      // conversion for the wide types.
+      operator RetType() const {
+        if constexpr (is_narrow) {
+          return static_cast<RetType>(V);
+        } else {
+          return RetType();
+        }
+      }
+
+      // Arithmetic assignment
+      template <typename T>
+      ap_int_base& operator+=(const T& op) {
+        return *this = (*this + op);
+      }
+      template <typename T>
+      ap_int_base& operator-=(const T& op) {
+        return *this = (*this - op);
+      }
+      template <typename T>
+      ap_int_base& operator*=(const T& op) {
+        return *this = (*this * op);
+      }
+      template <typename T>
+      ap_int_base& operator/=(const T& op) {
+        return *this = (*this / op);
+      }
+      template <typename T>
+      ap_int_base& operator%=(const T& op) {
+        return *this = (*this % op);
+      }
+      template <typename T>
+      ap_int_base& operator&=(const T& op) {
+        return *this = (*this & op);
+      }
+      template <typename T>
+      ap_int_base& operator|=(const T& op) {
+        return *this = (*this | op);
+      }
+      template <typename T>
+      ap_int_base& operator^=(const T& op) {
+        return *this = (*this ^ op);
+      }
+      template <typename T>
+      ap_int_base& operator<<=(const T& op) {
+        return *this = (*this << op);
+      }
+      template <typename T>
+      ap_int_base& operator>>=(const T& op) {
+        return *this = (*this >> op);
+      }
+
+      // Increment, decrement
+      ap_int_base& operator++() {
+        if constexpr (is_narrow) {
+          set_word0(word(0) + 1);
+        } else {
+          *this = (*this + 1);
+        }
+        return *this;
+      }
+      ap_int_base& operator--() {
+        if constexpr (is_narrow) {
+          set_word0(word(0) - 1);
+        } else {
+          *this = (*this - 1);
+        }
+        return *this;
+      }
+      const ap_int_base operator++(int) {
+        const ap_int_base tmp = *this;
+        operator++();
+        return tmp;
+      }
+      const ap_int_base operator--(int) {
+        const ap_int_base tmp = *this;
+        operator--();
+        return tmp;
+      }
+
+      // Unary operators
+      ap_int_base operator+() const { return *this; }
+
+      ap_int_base<W + 1, true> operator-() const {
+        ap_int_base<W + 1, true> r;
+        if constexpr (W + 1 <= 64) {
+          r.set_word0(word_t(0) - word(0));
+        } else {
+          r = (ap_int_base<1, false>(0) - *this);
+        }
+        return r;
+      }
+
+      ap_int_base operator~() const {
+        ap_int_base r;
+        r.set_words([this](int i) { return ~word(i); });
+        return r;
+      }
+
+      bool operator!() const { return iszero(); }
+
+      // Shifts, the result has the same type. A negative shift goes the other way.
+      ap_int_base operator<<(int sh) const {
+        sh = clamp_shift(sh);
+        return (sh >= 0) ? shl(sh) : shr(-sh);
+      }
+      ap_int_base operator>>(int sh) const {
+        sh = clamp_shift(sh);
+        return (sh >= 0) ? shr(sh) : shl(-sh);
+      }
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_int_base operator<<(C sh) const {
+        return operator<<(clamp_shift(sh));
+      }
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_int_base operator>>(C sh) const {
+        return operator>>(clamp_shift(sh));
+      }
+      template <int W2, bool S2>
+      ap_int_base operator<<(const ap_int_base<W2, S2>& sh) const {
+        return operator<<(clamp_shift(sh));
+      }
+      template <int W2, bool S2>
+      ap_int_base operator>>(const ap_int_base<W2, S2>& sh) const {
+        return operator>>(clamp_shift(sh));
+      }
+
+      // Bit select. The const version returns the value of the bit.
+      ap_bit_ref<W, S> operator[](int index) { return ap_bit_ref<W, S>(this, index); }
+      bool operator[](int index) const { return get_bit(index); }
+
+      template <int W2, bool S2>
+      ap_bit_ref<W, S> operator[](const ap_int_base<W2, S2>& index) {
+        return ap_bit_ref<W, S>(this, index.to_int());
+      }
+      template <int W2, bool S2>
+      bool operator[](const ap_int_base<W2, S2>& index) const {
+        return get_bit(index.to_int());
+      }
+
+      ap_bit_ref<W, S> bit(int index) { return ap_bit_ref<W, S>(this, index); }
+      bool bit(int index) const { return get_bit(index); }
+
+      // Range select. The range is reversed if hi < lo.
+      ap_range_ref<W, S> range(int hi, int lo) const {
+        return ap_range_ref<W, S>(const_cast<ap_int_base*>(this), hi, lo);
+      }
+      ap_range_ref<W, S> range() const { return range(W - 1, 0); }
+      ap_range_ref<W, S> operator()(int hi, int lo) const { return range(hi, lo); }
+
+      // Conversions
+      int length() const { return W; }
+      bool to_bool() const { return not iszero(); }
+      int to_int() const { return static_cast<int>(word(0)); }
+      unsigned to_uint() const { return static_cast<unsigned>(word(0)); }
+      long to_long() const { return static_cast<long>(word(0)); }
+      unsigned long to_ulong() const { return static_cast<unsigned long>(word(0)); }
+      int64_t to_int64() const { return static_cast<int64_t>(word(0)); }
+      uint64_t to_uint64() const { return word(0); }
+      double to_double() const {
+        if constexpr (is_narrow) {
+          return static_cast<double>(V);
+        } else {
+          double r = 0.;
+          for (int i = num_words - 1; i >= 0; --i) {
+            r = r * 0x1p64 + static_cast<double>((i == num_words - 1) ? static_cast<wide_t>(static_cast<int64_t>(word(i)))
+                                                                        : static_cast<wide_t>(word(i)));
+          }
+          return r;
+        }
+      }
+
+      // Reductions
+      bool iszero() const {
+        if constexpr (is_narrow) {
+          return V == 0;
+        } else {
+          word_t x = 0;
+          for (int i = 0; i < num_words; ++i)
+            x |= V.w[i];
+          return x == 0;
+        }
+      }
+      bool is_zero() const { return iszero(); }
+      bool or_reduce() const { return not iszero(); }
+      bool and_reduce() const {
+        bool r = true;
+        for (int i = 0; i < num_words; ++i)
+          r = r and ((word(i) & word_mask(i)) == word_mask(i));
+        return r;
+      }
+      bool xor_reduce() const {
+        int n = 0;
+        for (int i = 0; i < num_words; ++i)
+          n += __builtin_popcountll(word(i) & word_mask(i));
+        return (n & 1);
+      }
+
+      // _____________________________________________________________________________
+      // Internal interface, used by the operators
+
+      // The i-th 64-bit word of the two's complement representation, extended to infinite width
+      word_t word(int i) const {
+        if constexpr (is_narrow) {
+          if (i == 0)
+            return S ? static_cast<word_t>(static_cast<int64_t>(V)) : static_cast<word_t>(V);
+          return fill();
+        } else {
+          return (i < num_words) ? V.w[i] : fill();
+        }
+      }
+
+      // The 64 bits starting from bit pos. The bits below bit 0 are zeros.
+      word_t bits_at(int pos) const {
+        if (pos < 0)
+          return (pos <= -64) ? 0 : (word(0) << (-pos));
+        const int q = (pos >> 6);
+        const int r = (pos & 63);
+        if (r == 0)
+          return word(q);
+        return (word(q) >> r) | (word(q + 1) << (64 - r));
+      }
+
+      // The value, only for the narrow types
+      wide_t value() const {
+        static_assert(W <= 64, "value() is only available up to 64 bits");
+        return static_cast<wide_t>(V);
+      }
+
+      // Set from a 64-bit pattern (narrow types only), truncated to W bits
+      void set_word0(word_t x) {
+        static_assert(W <= 64, "set_word0() is only available up to 64 bits");
+        if constexpr (W == 64) {
+          V = static_cast<storage_type>(x);
+        } else if constexpr (S) {
+          V = static_cast<storage_type>(static_cast<int64_t>(x << (64 - W)) >> (64 - W));
+        } else {
+          V = static_cast<storage_type>(x & detail::low_mask(W));
+        }
+      }
+
+      // Set from the words returned by f(i), truncated to W bits
+      template <typename F>
+      void set_words(F f) {
+        if constexpr (is_narrow) {
+          set_word0(f(0));
+        } else {
+          for (int i = 0; i < num_words; ++i)
+            V.w[i] = f(i);
+          canonicalize();
+        }
+      }
+
+      bool get_bit(int index) const {
+        assert(index >= 0 and index < W);
+        if constexpr (is_narrow) {
+          return (word(0) >> index) & 1;
+        } else {
+          return (V.w[index >> 6] >> (index & 63)) & 1;
+        }
+      }
+
+      void set_bit(int index, bool b) {
+        assert(index >= 0 and index < W);
+        if constexpr (is_narrow) {
+          const word_t m = (word_t(1) << index);
+          set_word0(b ? (word(0) | m) : (word(0) & ~m));
+        } else {
+          const word_t m = (word_t(1) << (index & 63));
+          V.w[index >> 6] = b ? (V.w[index >> 6] | m) : (V.w[index >> 6] & ~m);
+          canonicalize();
+        }
+      }
+
+      // Bits [lo, hi] as an unsigned value
+      ap_int_base<W, false> get_range(int hi, int lo) const {
+        assert(hi >= 0 and hi < W and lo >= 0 and lo < W);
+        ap_int_base<W, false> r;
+        if (hi >= lo) {
+          const int len = hi - lo + 1;
+          if constexpr (is_narrow) {
+            r.set_word0((word(0) >> lo) & detail::low_mask(len));
+          } else {
+            r.set_words([this, lo, len](int i) {
+              const int rem = len - (64 * i);
+              return (rem <= 0) ? 0 : (bits_at(lo + (64 * i)) & detail::low_mask(rem));
+            });
+          }
+        } else {
+          // Reversed
+          for (int i = 0; i <= (lo - hi); ++i)
+            r.set_bit(i, get_bit(lo - i));
+        }
+        return r;
+      }
+
+      // Set bits [lo, hi] from the lowest bits of op
+      template <int W2, bool S2>
+      void set_range(int hi, int lo, const ap_int_base<W2, S2>& op) {
+        assert(hi >= 0 and hi < W and lo >= 0 and lo < W);
+        if (hi >= lo) {
+          if constexpr (is_narrow) {
+            const word_t m = (detail::low_mask(hi - lo + 1) << lo);
+            set_word0((word(0) & ~m) | ((op.word(0) << lo) & m));
+          } else {
+            for (int j = (lo >> 6); j <= (hi >> 6); ++j) {
+              const int b0 = AP_MAX(lo - (64 * j), 0);
+              const int b1 = AP_MIN(hi - (64 * j), 63);
+              const word_t m = (detail::low_mask(b1 - b0 + 1) << b0);
+              V.w[j] = (V.w[j] & ~m) | (op.bits_at((64 * j) - lo) & m);
+            }
+            canonicalize();
+          }
+        } else {
+          // Reversed
+          for (int i = 0; i <= (lo - hi); ++i)
+            set_bit(lo - i, (op.word(i >> 6) >> (i & 63)) & 1);
+        }
+      }
+
+      // Shifts by a non-negative amount
+      ap_int_base shl(int sh) const {
+        ap_int_base r;
+        if (sh >= W)
+          return r;
+        if constexpr (is_narrow) {
+          r.set_word0(word(0) << sh);
+        } else {
+          r.set_words([this, sh](int i) { return bits_at((64 * i) - sh); });
+        }
+        return r;
+      }
+
+      ap_int_base shr(int sh) const {
+        ap_int_base r;
+        sh = AP_MIN(sh, W);
+        if constexpr (is_narrow) {
+          if (S)
+            r.set_word0(static_cast<word_t>(static_cast<int64_t>(word(0)) >> AP_MIN(sh, 63)));
+          else
+            r.set_word0((sh >= 64) ? 0 : (word(0) >> sh));
+        } else {
+          r.set_words([this, sh](int i) { return bits_at((64 * i) + sh); });
+        }
+        return r;
+      }
+
+      // The raw value
+      storage_type V;
+
+    private:
+      word_t fill() const {
+        if constexpr (not S) {
+          return 0;
+        } else if constexpr (is_narrow) {
+          return (V < 0) ? ~word_t(0) : 0;
+        } else {
+          return (static_cast<int64_t>(V.w[num_words - 1]) < 0) ? ~word_t(0) : 0;
+        }
+      }
+
+      // Mask of the bits that belong to the i-th word
+      static word_t word_mask(int i) { return (i == num_words - 1) ? detail::low_mask(W - (64 * i)) : ~word_t(0); }
+
+      // Extend the top word from bit W-1
+      void canonicalize() {
+        constexpr int top = W - (64 * (num_words - 1));
+        if constexpr (top < 64) {
+          if constexpr (S) {
+            V.w[num_words - 1] = static_cast<word_t>(static_cast<int64_t>(V.w[num_words - 1] << (64 - top)) >> (64 - top));
+          } else {
+            V.w[num_words - 1] &= detail::low_mask(top);
+          }
+        }
+      }
+
+      void set_c_int(word_t x, bool negative) {
+        set_words([x, negative](int i) { return (i == 0) ? x : (negative ? ~word_t(0) : word_t(0)); });
+      }
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      static int clamp_shift(C sh) {
+        if constexpr (std::is_signed<C>::value) {
+          return static_cast<int>(AP_MAX(AP_MIN(static_cast<int64_t>(sh), int64_t(W)), -int64_t(W)));
+        } else {
+          return static_cast<int>(AP_MIN(static_cast<uint64_t>(sh), uint64_t(W)));
+        }
+      }
+
+      template <int W2, bool S2>
+      static int clamp_shift(const ap_int_base<W2, S2>& sh) {
+        if constexpr (W2 <= 64) {
+          const wide_t x = sh.value();
+          return static_cast<int>(AP_MAX(AP_MIN(x, wide_t(W)), -wide_t(W)));
+        } else {
+          const ap_int_base<W2, S2> lim = W;
+          if (sh > lim)
+            return W;
+          if (sh < -lim)
+            return -W;
+          return sh.to_int();
+        }
+      }
+    };
+
+    // _____________________________________________________________________________
+    // Range select
+    template <int W, bool S>
+    class ap_range_ref {
+    public:
+      ap_range_ref(ap_int_base<W, S>* bv, int hi, int lo) : d_bv(*bv), l_index(lo), h_index(hi) {}
+
+      ap_range_ref(const ap_range_ref&) = default;
+
+      ap_int_base<W, false> get() const { return d_bv.get_range(h_index, l_index); }
+
+      int length() const { return (h_index >= l_index) ? (h_index - l_index + 1) : (l_index - h_index + 1); }
+
+      operator ap_int_base<W, false>() const { return get(); }
+      operator unsigned long long() const { return get().to_uint64(); }
+
+      // Assignment writes the lowest length() bits of the value
+      ap_range_ref& operator=(const ap_range_ref& op) { return operator=(op.get()); }
+
+      template <int W2, bool S2>
+      ap_range_ref& operator=(const ap_int_base<W2, S2>& op) {
+        d_bv.set_range(h_index, l_index, op);
+        return *this;
+      }
+      template <int W2, bool S2>
+      ap_range_ref& operator=(const ap_range_ref<W2, S2>& op) {
+        return operator=(op.get());
+      }
+      template <int W2, bool S2>
+      ap_range_ref& operator=(const ap_bit_ref<W2, S2>& op) {
+        return operator=(ap_int_base<1, false>(op.get()));
+      }
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_range_ref& operator=(C op) {
+        return operator=(typename detail::int_operand<C>::type(op));
+      }
+
+      bool to_bool() const { return get().to_bool(); }
+      int to_int() const { return get().to_int(); }
+      unsigned to_uint() const { return get().to_uint(); }
+      int64_t to_int64() const { return get().to_int64(); }
+      uint64_t to_uint64() const { return get().to_uint64(); }
+      bool and_reduce() const { return get() == get_all_ones(); }
+      bool or_reduce() const { return not get().iszero(); }
+      bool xor_reduce() const { return get().xor_reduce(); }
+
+    private:
+      ap_int_base<W, false> get_all_ones() const {
+        ap_int_base<W, false> r;
+        r.set_range(length() - 1, 0, ap_int_base<W, true>(-1));
+        return r;
+      }
+
+      ap_int_base<W, S>& d_bv;
+      int l_index;
+      int h_index;
+    };
+
+    // _____________________________________________________________________________
+    // Bit select
+    template <int W, bool S>
+    class ap_bit_ref {
+    public:
+      ap_bit_ref(ap_int_base<W, S>* bv, int index) : d_bv(*bv), d_index(index) {}
+
+      ap_bit_ref(const ap_bit_ref&) = default;
+
+      bool get() const { return d_bv.get_bit(d_index); }
+      bool to_bool() const { return get(); }
+      int length() const { return 1; }
+
+      operator bool() const { return get(); }
+      bool operator~() const { return not get(); }
+
+      // Assignment sets the bit if the value is non-zero
+      ap_bit_ref& operator=(const ap_bit_ref& op) { return set(op.get()); }
+
+      template <int W2, bool S2>
+      ap_bit_ref& operator=(const ap_bit_ref<W2, S2>& op) {
+        return set(op.get());
+      }
+      template <int W2, bool S2>
+      ap_bit_ref& operator=(const ap_int_base<W2, S2>& op) {
+        return set(not op.iszero());
+      }
+      template <int W2, bool S2>
+      ap_bit_ref& operator=(const ap_range_ref<W2, S2>& op) {
+        return set(op.or_reduce());
+      }
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_bit_ref& operator=(C op) {
+        return set(op != 0);
+      }
+
+    private:
+      ap_bit_ref& set(bool b) {
+        d_bv.set_bit(d_index, b);
+        return *this;
+      }
+
+      ap_int_base<W, S>& d_bv;
+      int d_index;
+    };
+
+    // _____________________________________________________________________________
+    // Result of a concatenation. It is unsigned, with the sum of the widths of the operands. The
+    // operands are packed using their runtime lengths, which only differ from their widths for the
+    // ranges.
+    template <int W>
+    class ap_concat_ref : public ap_int_base<W, false> {
+    public:
+      ap_concat_ref(const ap_int_base<W, false>& op, int len) : ap_int_base<W, false>(op), len_(len) {}
+
+      int length() const { return len_; }
+
+      ap_int_base<W, false> get() const { return *this; }
+
+    private:
+      int len_;
+    };
+
+    namespace detail {
+
+      // Maps the operands of the concatenation. Same as above, plus the bit select.
+      // The width is the static width of the result, the length is the runtime number of bits.
+      template <typename T, typename Enable = void>
+      struct concat_operand {
+        static const bool value = false;
+        static const bool is_c_type = false;
+      };
+
+      template <typename T>
+      struct concat_operand<T, typename std::enable_if<int_operand<T>::value>::type> {
+        typedef typename int_operand<T>::type base_type;
+        static const int width = base_type::width;
+        static const bool value = true;
+        static const bool is_c_type = int_operand<T>::is_c_type;
+        static ap_int_base<width, false> get(const T& x) { return int_operand<T>::get(x); }
+        static int length(const T& x) { return x_length(x); }
+
+        template <int W>
+        static int x_length(const ap_concat_ref<W>& x) {
+          return x.length();
+        }
+        template <int W, bool S>
+        static int x_length(const ap_range_ref<W, S>& x) {
+          return x.length();
+        }
+        template <typename U>
+        static int x_length(const U&) {
+          return width;
+        }
+      };
+
+      template <int W, bool S>
+      struct concat_operand<ap_bit_ref<W, S>, void> {
+        static const int width = 1;
+        static const bool value = true;
+        static const bool is_c_type = false;
+        static ap_int_base<1, false> get(const ap_bit_ref<W, S>& x) { return ap_int_base<1, false>(x.get()); }
+        static int length(const ap_bit_ref<W, S>&) { return 1; }
+      };
+
+      template <typename A, typename B>
+      struct is_concat_binary {
+        static const bool value = (concat_operand<A>::value and concat_operand<B>::value and
+                                   not(concat_operand<A>::is_c_type and concat_operand<B>::is_c_type));
+      };
+
+    }  // namespace detail
+
+    template <typename A,
+              typename B,
+              typename std::enable_if<detail::is_concat_binary<A, B>::value, int>::type = 0>
+    ap_concat_ref<detail::concat_operand<A>::width + detail::concat_operand<B>::width> operator,(const A& a,
+                                                                                                 const B& b) {
+      typedef detail::concat_operand<A> A_;
+      typedef detail::concat_operand<B> B_;
+      typedef ap_int_base<A_::width + B_::width, false> result_type;
+
+      const result_type va = A_::get(a);
+      const result_type vb = B_::get(b);
+      const int len_a = A_::length(a);
+      const int len_b = B_::length(b);
+      result_type r;
+      if constexpr (result_type::is_narrow) {
+        r.set_word0((va.word(0) << len_b) | vb.word(0));
+      } else {
+        const result_type tmp = va.shl(len_b);
+        r.set_words([&tmp, &vb](int i) { return tmp.word(i) | vb.word(i); });
+      }
+      return ap_concat_ref<result_type::width>(r, len_a + len_b);
+    }
+
+    // _____________________________________________________________________________
+    // Binary operators
+    namespace detail {
+
+      template <typename R, int W1, bool S1, int W2, bool S2>
+      R add(const ap_int_base<W1, S1>& a, const ap_int_base<W2, S2>& b) {
+        R r;
+        if constexpr (R::is_narrow) {
+          r.set_word0(a.word(0) + b.word(0));
+        } else {
+          word_t w[R::num_words];
+          word_t carry = 0;
+          for (int i = 0; i < R::num_words; ++i) {
+            const uwide_t s = static_cast<uwide_t>(a.word(i)) + b.word(i) + carry;
+            w[i] = static_cast<word_t>(s);
+            carry = static_cast<word_t>(s >> 64);
+          }
+          r.set_words([&w](int i) { return w[i]; });
+        }
+        return r;
+      }
+
+      template <typename R, int W1, bool S1, int W2, bool S2>
+      R sub(const ap_int_base<W1, S1>& a, const ap_int_base<W2, S2>& b) {
+        R r;
+        if constexpr (R::is_narrow) {
+          r.set_word0(a.word(0) - b.word(0));
+        } else {
+          word_t w[R::num_words];
+          word_t carry = 1;
+          for (int i = 0; i < R::num_words; ++i) {
+            const uwide_t s = static_cast<uwide_t>(a.word(i)) + static_cast<word_t>(~b.word(i)) + carry;
+            w[i] = static_cast<word_t>(s);
+            carry = static_cast<word_t>(s >> 64);
+          }
+          r.set_words([&w](int i) { return w[i]; });
+        }
+        return r;
+      }
+
+      template <typename R, int W1, bool S1, int W2, bool S2>
+      R mul(const ap_int_base<W1, S1>& a, const ap_int_base<W2, S2>& b) {
+        static_assert(R::width <= 128, "multiplication is only implemented up to 128-bit results");
+        R r;
+        if constexpr (R::is_narrow) {
+          r.set_word0(a.word(0) * b.word(0));
+        } else {
+          const uwide_t x = (static_cast<uwide_t>(a.word(1)) << 64) | a.word(0);
+          const uwide_t y = (static_cast<uwide_t>(b.word(1)) << 64) | b.word(0);
+          const uwide_t p = x * y;
+          const word_t fill = (static_cast<int64_t>(p >> 64) < 0) ? ~word_t(0) : 0;
+          r.set_words([p, fill](int i) { return (i == 0) ? static_cast<word_t>(p) : ((i == 1) ? static_cast<word_t>(p >> 64) : fill); });
+        }
+        return r;
+      }
+
+      template <typename R, int W1, bool S1, int W2, bool S2>
+      R div(const ap_int_base<W1, S1>& a, const ap_int_base<W2, S2>& b) {
+        static_assert(W1 <= 64 and W2 <= 64, "division is only implemented up to 64-bit operands");
+        assert(not b.iszero());
+        const wide_t q = a.value() / b.value();
+        R r;
+        r.set_words([q](int i) { return (i == 0) ? static_cast<word_t>(q) : static_cast<word_t>(q >> 64); });
+        return r;
+      }
+
+      template <typename R, int W1, bool S1, int W2, bool S2>
+      R mod(const ap_int_base<W1, S1>& a, const ap_int_base<W2, S2>& b) {
+        static_assert(W1 <= 64 and W2 <= 64, "modulo is only implemented up to 64-bit operands");
+        assert(not b.iszero());
+        const wide_t m = a.value() % b.value();
+        R r;
+        r.set_word0(static_cast<word_t>(m));
+        return r;
+      }
+
+    }  // namespace detail
+
+#define EMTF_HLSLIB_NATIVE_BINARY_OP(OP, NAME, IMPL)                                                         \
+  template <typename A, typename B, typename std::enable_if<detail::is_int_binary<A, B>::value, int>::type = 0> \
+  typename detail::binary_rtype<A, B>::type::NAME operator OP(const A& a, const B& b) {                     \
+    typedef typename detail::binary_rtype<A, B>::type::NAME result_type;                                    \
+    return IMPL<result_type>(detail::int_operand<A>::get(a), detail::int_operand<B>::get(b));               \
+  }
+
+    EMTF_HLSLIB_NATIVE_BINARY_OP(+, plus, detail::add)
+    EMTF_HLSLIB_NATIVE_BINARY_OP(-, minus, detail::sub)
+    EMTF_HLSLIB_NATIVE_BINARY_OP(*, mult, detail::mul)
+    EMTF_HLSLIB_NATIVE_BINARY_OP(/, div, detail::div)
+    EMTF_HLSLIB_NATIVE_BINARY_OP(%, mod, detail::mod)
+
+#undef EMTF_HLSLIB_NATIVE_BINARY_OP
+
+#define EMTF_HLSLIB_NATIVE_LOGIC_OP(OP)                                                                      \
+  template <typename A, typename B, typename std::enable_if<detail::is_int_binary<A, B>::value, int>::type = 0> \
+  typename detail::binary_rtype<A, B>::type::logic operator OP(const A& a, const B& b) {                    \
+    typedef typename detail::binary_rtype<A, B>::type::logic result_type;                                   \
+    const auto& x = detail::int_operand<A>::get(a);                                                         \
+    const auto& y = detail::int_operand<B>::get(b);                                                         \
+    result_type r;                                                                                          \
+    r.set_words([&x, &y](int i) { return x.word(i) OP y.word(i); });                                        \
+    return r;                                                                                               \
+  }
+
+    EMTF_HLSLIB_NATIVE_LOGIC_OP(&)
+    EMTF_HLSLIB_NATIVE_LOGIC_OP(|)
+    EMTF_HLSLIB_NATIVE_LOGIC_OP(^)
+
+#undef EMTF_HLSLIB_NATIVE_LOGIC_OP
+
+#define EMTF_HLSLIB_NATIVE_RELATIONAL_OP(OP, ORDERING)                                                       \
+  template <typename A, typename B, typename std::enable_if<detail::is_int_binary<A, B>::value, int>::type = 0> \
+  bool operator OP(const A& a, const B& b) {                                                                \
+    return detail::compare(detail::int_operand<A>::get(a), detail::int_operand<B>::get(b), ORDERING) OP 0;  \
+  }
+
+    EMTF_HLSLIB_NATIVE_RELATIONAL_OP(==, false)
+    EMTF_HLSLIB_NATIVE_RELATIONAL_OP(!=, false)
+    EMTF_HLSLIB_NATIVE_RELATIONAL_OP(<, true)
+    EMTF_HLSLIB_NATIVE_RELATIONAL_OP(>, true)
+    EMTF_HLSLIB_NATIVE_RELATIONAL_OP(<=, true)
+    EMTF_HLSLIB_NATIVE_RELATIONAL_OP(>=, true)
+
+#undef EMTF_HLSLIB_NATIVE_RELATIONAL_OP
+
+    // Range select as the left operand of a shift
+    template <int W, bool S, typename T>
+    ap_int_base<W, false> operator<<(const ap_range_ref<W, S>& op, const T& sh) {
+      return op.get() << sh;
+    }
+    template <int W, bool S, typename T>
+    ap_int_base<W, false> operator>>(const ap_range_ref<W, S>& op, const T& sh) {
+      return op.get() >> sh;
+    }
+
+    // _____________________________________________________________________________
+    // Printed in decimal, or in hex/oct if the stream is set so
+    template <int W, bool S>
+    std::ostream& operator<<(std::ostream& os, const ap_int_base<W, S>& op) {
+      if constexpr (W <= 64) {
+        if (S)
+          os << static_cast<long long>(op.V);
+        else
+          os << static_cast<unsigned long long>(op.V);
+      } else {
+        // Magnitude, then repeated division by 10^18
+        const bool negative = S and (static_cast<int64_t>(op.word(ap_int_base<W, S>::num_words - 1)) < 0);
+        const ap_int_base<W + 1, true> mag = negative ? ap_int_base<W + 1, true>(-op) : ap_int_base<W + 1, true>(op);
+        constexpr int n = ap_int_base<W + 1, true>::num_words;
+        detail::word_t w[n];
+        for (int i = 0; i < n; ++i)
+          w[i] = mag.word(i);
+        std::string digits;
+        bool nonzero = true;
+        while (nonzero) {
+          detail::uwide_t rem = 0;
+          nonzero = false;
+          for (int i = n - 1; i >= 0; --i) {
+            const detail::uwide_t cur = (rem << 64) | w[i];
+            w[i] = static_cast<detail::word_t>(cur / 1000000000000000000ull);
+            rem = cur % 1000000000000000000ull;
+            nonzero = nonzero or (w[i] != 0);
+          }
+          std::string chunk = std::to_string(static_cast<unsigned long long>(rem));
+          if (nonzero)
+            chunk.insert(0, 18 - chunk.size(), '0');
+          digits.insert(0, chunk);
+        }
+        os << (negative ? "-" : "") << digits;
+      }
+      return os;
+    }
+
+    // _____________________________________________________________________________
+    // Signed and unsigned integers
+    template <int W>
+    class ap_int : public ap_int_base<W, true> {
+    public:
+      typedef ap_int_base<W, true> Base;
+
+      ap_int() : Base() {}
+
+      template <int W2, bool S2>
+      ap_int(const ap_int_base<W2, S2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_int(const ap_range_ref<W2, S2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_int(const ap_bit_ref<W2, S2>& op) : Base(op) {}
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_int(C op) : Base(op) {}
+
+      ap_int(double op) : Base(op) {}
+      ap_int(float op) : Base(op) {}
+    };
+
+    template <int W>
+    class ap_uint : public ap_int_base<W, false> {
+    public:
+      typedef ap_int_base<W, false> Base;
+
+      ap_uint() : Base() {}
+
+      template <int W2, bool S2>
+      ap_uint(const ap_int_base<W2, S2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_uint(const ap_range_ref<W2, S2>& op) : Base(op) {}
+
+      template <int W2, bool S2>
+      ap_uint(const ap_bit_ref<W2, S2>& op) : Base(op) {}
+
+      template <typename C, typename std::enable_if<std::is_integral<C>::value, int>::type = 0>
+      ap_uint(C op) : Base(op) {}
+
+      ap_uint(double op) : Base(op) {}
+      ap_uint(float op) : Base(op) {}
+    };
+
+  }  // namespace native
+
+}  // namespace emtf_hlslib
+
+#ifdef EMTF_HLSLIB_NATIVE_TYPES
+using emtf_hlslib::native::ap_bit_ref;
+using emtf_hlslib::native::ap_concat_ref;
+using emtf_hlslib::native::ap_int;
+using emtf_hlslib::native::ap_int_base;
+using emtf_hlslib::native::ap_range_ref;
+using emtf_hlslib::native::ap_uint;
+#endif  // EMTF_HLSLIB_NATIVE_TYPES defined
+
+#endif  // __EMTF_HLSLIB_NATIVE_AP_INT_H__ not defined
@@ -60,6 +60,34 @@ namespace emtf_hlslib {
         }
       }
 
+#ifndef __SYNTHESIS__
+      // Helper class to hold the nnet weights in the CPU build. See static_lookup_table.
+      template <typename T, unsigned int N, typename U>
+      struct static_nnet_weights {
+        T data[N];
+
+        static_nnet_weights() { init_nnet_weights_op<N>(data, U{}); }
+
+        static const static_nnet_weights instance;
+      };
+
+      template <typename T, unsigned int N, typename U>
+      const static_nnet_weights<T, N, U> static_nnet_weights<T, N, U>::instance;
+
+      // Helper class to hold the tanh table in the CPU build. See static_lookup_table.
+      template <unsigned int N, typename T_IN, typename T_OUT>
+      struct static_tanh_table {
+        T_OUT data[N];
+
+        static_tanh_table() { init_tanh_table_op<N, T_IN>(data); }
+
+        static const static_tanh_table instance;
+      };
+
+      template <unsigned int N, typename T_IN, typename T_OUT>
+      const static_tanh_table<N, T_IN, T_OUT> static_tanh_table<N, T_IN, T_OUT>::instance;
+#endif  // __SYNTHESIS__ not defined
+
       // Returns activation(X) using tanh
       template <unsigned int N, typename T_IN, typename T_OUT>
       void vector_tanh_activate_op(const T_IN x[N], T_OUT out[N]) {
@@ -69,17 +97,16 @@ namespace emtf_hlslib {
         const unsigned int N_TABLE = (1u << T_IN::width);
 
 #ifndef __SYNTHESIS__
-        static bool initialized = false;
-        static T_OUT tanh_table[N_TABLE];
+        const T_OUT(&tanh_table)[N_TABLE] = static_tanh_table<N_TABLE, T_IN, T_OUT>::instance.data;
 #else
         bool initialized = false;
         T_OUT tanh_table[N_TABLE];
-#endif  // __SYNTHESIS__ not defined
 
         if (!initialized) {
           initialized = true;
           init_tanh_table_op<N_TABLE, T_IN>(tanh_table);
         }
+#endif  // __SYNTHESIS__ not defined
 
         for (unsigned i = 0; i < N; i++) {
           // Reinterpret ap_fixed as ap_uint
@@ -29,17 +29,17 @@ namespace emtf_hlslib {
         const unsigned int N_TABLE = (1u << T_IN::width);
 
 #ifndef __SYNTHESIS__
-        static bool initialized = false;
-        static int lookup_table[N_TABLE];
+        typedef detail::static_lookup_table<int, N_TABLE, detail::get_pattern_activation_op<Zone> > lookup_table_t;
+        const int(&lookup_table)[N_TABLE] = lookup_table_t::instance.data;
 #else
         bool initialized = false;
         int lookup_table[N_TABLE];
-#endif  // __SYNTHESIS__ not defined
 
         if (!initialized) {
           initialized = true;
           detail::init_table_op<N_TABLE>(lookup_table, detail::get_pattern_activation_op<Zone>{});
         }
+#endif  // __SYNTHESIS__ not defined
 
         // Lookup
         emtf_assert(in0 < N_TABLE);
@@ -60,14 +60,24 @@ namespace emtf_hlslib {
                              const typename detail::select_pattern_col_patch_type<Zone, 7>::type& patch_row_7,
                              trk_qual_t activations[num_emtf_patterns]) {
 #ifndef __SYNTHESIS__
-      static bool initialized = false;
-      static int pattern_col_start_table[num_emtf_patterns * num_emtf_img_rows];
-      static int pattern_col_stop_table[num_emtf_patterns * num_emtf_img_rows];
+      typedef detail::static_2d_lookup_table<int,
+                                             num_emtf_patterns,
+                                             num_emtf_img_rows,
+                                             detail::get_pattern_col_start_op<Zone> >
+          pattern_col_start_table_t;
+      typedef detail::static_2d_lookup_table<int,
+                                             num_emtf_patterns,
+                                             num_emtf_img_rows,
+                                             detail::get_pattern_col_stop_op<Zone> >
+          pattern_col_stop_table_t;
+      const int(&pattern_col_start_table)[num_emtf_patterns * num_emtf_img_rows] =
+          pattern_col_start_table_t::instance.data;
+      const int(&pattern_col_stop_table)[num_emtf_patterns * num_emtf_img_rows] =
+          pattern_col_stop_table_t::instance.data;
 #else
       bool initialized = false;
       int pattern_col_start_table[num_emtf_patterns * num_emtf_img_rows];
       int pattern_col_stop_table[num_emtf_patterns * num_emtf_img_rows];
-#endif  // __SYNTHESIS__ not defined
 
       if (!initialized) {
         initialized = true;
@@ -76,6 +86,7 @@ namespace emtf_hlslib {
         detail::init_2d_table_op<num_emtf_patterns, num_emtf_img_rows>(pattern_col_stop_table,
                                                                        detail::get_pattern_col_stop_op<Zone>{});
       }
+#endif  // __SYNTHESIS__ not defined
 
       // Loop over patterns
       for (unsigned i = 0; i < num_emtf_patterns; i++) {
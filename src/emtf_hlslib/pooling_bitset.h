@@ -0,0 +1,303 @@
+#ifndef __EMTF_HLSLIB_POOLING_BITSET_H__
+#define __EMTF_HLSLIB_POOLING_BITSET_H__
+
+// Word-parallel implementation of pooling_layer for the CPU, using the zone images from
+// zoning_bitset_layer. It is not meant for synthesis.
+//
+// In pooling_col_pool_op, bit b_j of the preactivation of pattern i at column c is the OR of
+// row j over the window [c + lo, c + hi] of the pattern. Here, each row is first dilated by the
+// window, i.e. bit c of the dilated row is that OR for column c, so that one pass of shifts and
+// ORs over the 64-bit words gives b_j for all the columns at once. Only the columns where at
+// least one dilated row is non-zero need the activation lookup and the argmax; all the other
+// columns have the preactivation 0. The output is identical to pooling_layer.
+//
+// Function hierarchy
+//
+// pooling_bitset_layer
+// +-- pooling_bitset_op (INLINE)
+//     |-- pooling_bitset_dilate_op (INLINE)
+//     +-- pooling_bitset_col_op (INLINE)
+
+// EMTF HLS
+#include "layer_helpers.h"
+#include "zoning_bitset.h"
+
+namespace emtf_hlslib {
+
+  namespace phase2 {
+
+    namespace detail {
+
+      // Row with some headroom above the last column, used while dilating
+      struct pooling_bitset_wide_row_t {
+        constexpr static const int n_words = zoning_bitset_config::n_words + 1;
+        constexpr static const int headroom = (n_words * zoning_bitset_config::word_bw) - num_emtf_img_cols;
+
+        zoning_bitset_config::word_t words[n_words];
+      };
+
+      // Shift a row such that bit c of the output is bit (c + n) of the input. n can be negative.
+      // The bits shifted in are zero, same as the padding in pooling_op.
+      template <typename T>
+      void pooling_bitset_shift_op(const T& in0, int n, pooling_bitset_wide_row_t& out) {
+        typedef zoning_bitset_config::word_t word_t;
+        constexpr int word_bw = zoning_bitset_config::word_bw;
+        constexpr int n_words_in = (sizeof(in0.words) / sizeof(in0.words[0]));
+        constexpr int n_words = pooling_bitset_wide_row_t::n_words;
+
+        // Split into a shift by whole words and a shift by bits
+        const int n_abs = (n >= 0) ? n : -n;
+        const int word_shift = n_abs / word_bw;
+        const int bit_shift = n_abs % word_bw;
+
+        // Loop over words
+        for (int k = 0; k < n_words; k++) {
+          // Source words that end up in word k
+          const int k0 = (n >= 0) ? (k + word_shift) : (k - word_shift);
+          const int k1 = (n >= 0) ? (k0 + 1) : (k0 - 1);
+          const word_t w0 = ((k0 >= 0) and (k0 < n_words_in)) ? in0.words[k0] : word_t(0);
+          const word_t w1 = ((k1 >= 0) and (k1 < n_words_in)) ? in0.words[k1] : word_t(0);
+
+          if (bit_shift == 0) {
+            out.words[k] = w0;
+          } else if (n >= 0) {
+            out.words[k] = (w0 >> bit_shift) | (w1 << (word_bw - bit_shift));
+          } else {
+            out.words[k] = (w0 << bit_shift) | (w1 >> (word_bw - bit_shift));
+          }
+        }  // end loop over words
+      }
+
+      // Pattern windows and activation table of a zone. The windows are relative to the output
+      // column, e.g. [lo, hi] = [-2, 2] is the OR of 5 columns centered at the output column.
+      template <typename Zone>
+      struct pooling_bitset_tables {
+        // Max num of doublings needed to build the widest window
+        constexpr static const int max_levels = 9;  // up to 512 columns
+
+        int col_lo[num_emtf_patterns][num_emtf_img_rows];
+        int col_hi[num_emtf_patterns][num_emtf_img_rows];
+        int level[num_emtf_patterns][num_emtf_img_rows];  // floor(log2(width))
+        int num_levels[num_emtf_img_rows];                // 1 + max level over patterns
+        int col_base[num_emtf_img_rows];                  // min col_lo over patterns
+        int activation[1u << num_emtf_img_rows];
+
+        pooling_bitset_tables() {
+          const int col_pads[num_emtf_img_rows] = {pattern_col_pad_traits<Zone, 0>::value,
+                                                   pattern_col_pad_traits<Zone, 1>::value,
+                                                   pattern_col_pad_traits<Zone, 2>::value,
+                                                   pattern_col_pad_traits<Zone, 3>::value,
+                                                   pattern_col_pad_traits<Zone, 4>::value,
+                                                   pattern_col_pad_traits<Zone, 5>::value,
+                                                   pattern_col_pad_traits<Zone, 6>::value,
+                                                   pattern_col_pad_traits<Zone, 7>::value};
+
+          const auto get_pattern_col_start = get_pattern_col_start_op<Zone>{};
+          const auto get_pattern_col_stop = get_pattern_col_stop_op<Zone>{};
+
+          for (int j = 0; j < num_emtf_img_rows; j++) {
+            num_levels[j] = 1;
+            col_base[j] = 0;
+          }
+
+          for (int i = 0; i < num_emtf_patterns; i++) {
+            for (int j = 0; j < num_emtf_img_rows; j++) {
+              // The patch of a column starts at (col - pad). range(stop, start) is reversed if
+              // stop < start, but that does not matter for the OR reduction.
+              const int col_start = get_pattern_col_start(i, j) - col_pads[j];
+              const int col_stop = get_pattern_col_stop(i, j) - col_pads[j];
+              col_lo[i][j] = (col_start <= col_stop) ? col_start : col_stop;
+              col_hi[i][j] = (col_start <= col_stop) ? col_stop : col_start;
+
+              const int width = col_hi[i][j] - col_lo[i][j] + 1;
+              int lvl = 0;
+              while ((2 << lvl) <= width) {
+                lvl++;
+              }
+              emtf_assert(lvl < max_levels);
+              level[i][j] = lvl;
+              num_levels[j] = (num_levels[j] > (lvl + 1)) ? num_levels[j] : (lvl + 1);
+              col_base[j] = (col_base[j] < col_lo[i][j]) ? col_base[j] : col_lo[i][j];
+            }
+          }
+
+          // The rows are shifted up by -col_base before dilating, this must fit in the headroom
+          for (int j = 0; j < num_emtf_img_rows; j++) {
+            emtf_assert(-col_base[j] <= pooling_bitset_wide_row_t::headroom);
+          }
+
+          // Truncated to trk_qual_t, as in apply_pattern_activation_op
+          init_table_op<(1u << num_emtf_img_rows)>(activation, get_pattern_activation_op<Zone>{});
+          for (unsigned k = 0; k < (1u << num_emtf_img_rows); k++) {
+            activation[k] &= ((1 << trk_qual_t::width) - 1);
+          }
+        }
+
+        // Built once during static initialization, see static_lookup_table
+        static const pooling_bitset_tables instance;
+      };
+
+      template <typename Zone>
+      const pooling_bitset_tables<Zone> pooling_bitset_tables<Zone>::instance;
+
+    }  // namespace detail
+
+    // _____________________________________________________________________________
+    // Dilate the rows by the windows of every pattern. A window of width w is the OR of two
+    // (possibly overlapping) windows of width 2^k, where 2^k <= w < 2^(k+1), and the windows of
+    // width 2^k are built by doubling. The windows can start left of the column, so the row is
+    // first shifted up by the leftmost start, so that all the other shifts go down and no bit
+    // is lost.
+
+    template <typename Zone>
+    void pooling_bitset_dilate_op(const zoning_bitset_row_t pooling_in[pooling_config::n_in],
+                                  zoning_bitset_row_t dilated[num_emtf_patterns][num_emtf_img_rows]) {
+      typedef detail::pooling_bitset_tables<Zone> tables_t;
+      typedef detail::pooling_bitset_wide_row_t wide_row_t;
+      typedef zoning_bitset_config::word_t word_t;
+      const tables_t& tables = tables_t::instance;
+
+      constexpr int n_words = zoning_bitset_config::n_words;
+      constexpr int last_bw = num_emtf_img_cols - ((n_words - 1) * zoning_bitset_config::word_bw);
+      constexpr word_t last_mask =
+          (last_bw < zoning_bitset_config::word_bw) ? ((word_t(1) << last_bw) - 1) : ~word_t(0);
+
+      // Loop over rows
+      for (int j = 0; j < num_emtf_img_rows; j++) {
+        const int col_base = tables.col_base[j];
+
+        // doubled[k] bit c is the OR of the row over [c + col_base, c + col_base + 2^k - 1]
+        wide_row_t doubled[tables_t::max_levels];
+        detail::pooling_bitset_shift_op(pooling_in[j], col_base, doubled[0]);
+
+        for (int k = 1; k < tables.num_levels[j]; k++) {
+          wide_row_t tmp;
+          detail::pooling_bitset_shift_op(doubled[k - 1], (1 << (k - 1)), tmp);
+          for (int w = 0; w < wide_row_t::n_words; w++) {
+            doubled[k].words[w] = doubled[k - 1].words[w] | tmp.words[w];
+          }
+        }
+
+        // Loop over patterns
+        for (int i = 0; i < num_emtf_patterns; i++) {
+          const int lvl = tables.level[i][j];
+          const int shift_0 = tables.col_lo[i][j] - col_base;
+          const int shift_1 = tables.col_hi[i][j] - (1 << lvl) + 1 - col_base;
+          emtf_assert((shift_0 >= 0) and (shift_1 >= 0));
+
+          wide_row_t tmp_0;
+          wide_row_t tmp_1;
+          detail::pooling_bitset_shift_op(doubled[lvl], shift_0, tmp_0);
+          detail::pooling_bitset_shift_op(doubled[lvl], shift_1, tmp_1);
+          for (int w = 0; w < n_words; w++) {
+            dilated[i][j].words[w] = tmp_0.words[w] | tmp_1.words[w];
+          }
+          dilated[i][j].words[n_words - 1] &= last_mask;  // clear the bits beyond the last column
+        }  // end loop over patterns
+      }    // end loop over rows
+    }
+
+    // Same as pooling_col_op, for one column of the dilated rows
+    template <typename Zone>
+    void pooling_bitset_col_op(const zoning_bitset_row_t dilated[num_emtf_patterns][num_emtf_img_rows],
+                               int col,
+                               pooling_out_t& pooling_out_col_k) {
+      typedef detail::pooling_bitset_tables<Zone> tables_t;
+      const tables_t& tables = tables_t::instance;
+
+      const int w = col / zoning_bitset_config::word_bw;
+      const int b = col % zoning_bitset_config::word_bw;
+
+      // Pattern with max activation. The first one wins in case of a tie, as in pooling_col_argmax_op.
+      int best_patt = 0;
+      int best_qual = -1;
+
+      // Loop over patterns
+      for (int i = 0; i < num_emtf_patterns; i++) {
+        unsigned preactivation = 0;
+        for (int j = 0; j < num_emtf_img_rows; j++) {
+          preactivation |= static_cast<unsigned>((dilated[i][j].words[w] >> b) & 1u) << j;
+        }
+
+        const int qual = tables.activation[preactivation];
+        if (qual > best_qual) {
+          best_patt = i;
+          best_qual = qual;
+        }
+      }  // end loop over patterns
+
+      // Output, same bit layout as (trk_patt_t, trk_qual_t)
+      pooling_out_col_k = (static_cast<unsigned>(best_patt) << trk_qual_t::width) | static_cast<unsigned>(best_qual);
+    }
+
+    // _____________________________________________________________________________
+    // Pooling op
+
+    template <typename Zone>
+    void pooling_bitset_op(const zoning_bitset_row_t pooling_in[pooling_config::n_in],
+                           pooling_out_t pooling_out[pooling_config::n_out]) {
+      typedef detail::pooling_bitset_tables<Zone> tables_t;
+      const tables_t& tables = tables_t::instance;
+
+      typedef zoning_bitset_config::word_t word_t;
+      constexpr int word_bw = zoning_bitset_config::word_bw;
+      constexpr int n_words = zoning_bitset_config::n_words;
+
+      // Intermediate arrays
+      zoning_bitset_row_t dilated[num_emtf_patterns][num_emtf_img_rows];
+
+      pooling_bitset_dilate_op<Zone>(pooling_in, dilated);
+
+      // Columns where the preactivation is 0 for all the patterns. The activations are all equal,
+      // so the first pattern is chosen.
+      const pooling_out_t pooling_out_empty =
+          (static_cast<unsigned>(0) << trk_qual_t::width) | static_cast<unsigned>(tables.activation[0]);
+
+      // Loop over words
+      for (int w = 0; w < n_words; w++) {
+        word_t any = 0;
+        for (int i = 0; i < num_emtf_patterns; i++) {
+          for (int j = 0; j < num_emtf_img_rows; j++) {
+            any |= dilated[i][j].words[w];
+          }
+        }
+
+        const int col_begin = w * word_bw;
+        const int col_end = (col_begin + word_bw < num_emtf_img_cols) ? (col_begin + word_bw) : num_emtf_img_cols;
+
+        for (int col = col_begin; col < col_end; col++) {
+          pooling_out[col] = pooling_out_empty;
+        }
+
+        // Loop over the non-empty columns
+        while (any != 0) {
+          const int col = col_begin + __builtin_ctzll(any);
+          any &= (any - 1);  // clear the lowest set bit
+          emtf_assert(col < num_emtf_img_cols);
+          pooling_bitset_col_op<Zone>(dilated, col, pooling_out[col]);
+        }
+      }  // end loop over words
+    }
+
+    // _____________________________________________________________________________
+    // Entry point
+
+    template <typename Zone>
+    void pooling_bitset_layer(const zoning_bitset_row_t pooling_in[pooling_config::n_in],
+                              pooling_out_t pooling_out[pooling_config::n_out]) {
+      // Check assumptions
+      static_assert(pooling_config::n_in == num_emtf_img_rows, "pooling_config::n_in check failed");
+      static_assert(pooling_config::n_out == num_emtf_img_cols, "pooling_config::n_out check failed");
+      static_assert(num_emtf_img_rows == 8, "num_emtf_img_rows must be 8");
+      static_assert(num_emtf_patterns == 7, "num_emtf_patterns must be 7");
+      static_assert(dio_patt_preact_t::width == pooling_config::n_in, "dio_patt_preact_t type check failed");
+      static_assert(pooling_out_t::width == (trk_patt_t::width + trk_qual_t::width), "pooling_out_t type check failed");
+
+      pooling_bitset_op<Zone>(pooling_in, pooling_out);
+    }
+
+  }  // namespace phase2
+
+}  // namespace emtf_hlslib
+
+#endif  // __EMTF_HLSLIB_POOLING_BITSET_H__ not defined
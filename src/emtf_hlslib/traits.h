@@ -5,9 +5,15 @@
 
 #include <cfloat>  // provides FLT_EPSILON, FLT_MANT_DIG
 
+#ifdef EMTF_HLSLIB_NATIVE_TYPES
+// CPU implementation with native integers
+#include "native_ap_int.h"
+#include "native_ap_fixed.h"
+#else
 // Xilinx HLS
 #include "ap_int.h"
 #include "ap_fixed.h"
+#endif  // EMTF_HLSLIB_NATIVE_TYPES defined
 
 namespace emtf_hlslib {
 
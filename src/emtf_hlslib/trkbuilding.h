@@ -30,28 +30,70 @@ namespace emtf_hlslib {
 
     namespace detail {
 
+#ifndef __SYNTHESIS__
+      // Packed (start, mid, stop, pad) pattern windows of a site, indexed by (zone, patt)
+      struct pattern_windows_t {
+        dio_patt_param_t par0;
+        dio_patt_param_t par1;
+        dio_patt_param_t par2;
+        dio_patt_param_t par3;
+      };
+
+      // Table of the pattern windows of a site in the CPU build. It is built once during static
+      // initialization (see static_lookup_table), and aligned so that it starts on a cache line.
+      template <typename Site>
+      struct pattern_windows_table {
+        static const unsigned int M_TABLE = (1u << trk_zone_t::width);
+        static const unsigned int N_TABLE = (1u << trk_patt_t::width);
+
+        alignas(64) pattern_windows_t data[M_TABLE * N_TABLE];
+
+        pattern_windows_table() {
+          const auto get_col_start = get_site_pattern_col_start_op<Site>();
+          const auto get_col_mid = get_site_pattern_col_mid_op<Site>();
+          const auto get_col_stop = get_site_pattern_col_stop_op<Site>();
+          const auto get_col_pad = get_site_pattern_col_pad_op<Site>();
+
+          for (unsigned i = 0; i < M_TABLE; i++) {
+            for (unsigned j = 0; j < N_TABLE; j++) {
+              pattern_windows_t& x = data[(i * N_TABLE) + j];
+              x.par0 = static_cast<dio_patt_param_t>(get_col_start(i, j));
+              x.par1 = static_cast<dio_patt_param_t>(get_col_mid(i, j));
+              x.par2 = static_cast<dio_patt_param_t>(get_col_stop(i, j));
+              x.par3 = static_cast<dio_patt_param_t>(get_col_pad(i, j));
+            }
+          }
+        }
+
+        static const pattern_windows_table instance;
+      };
+
+      template <typename Site>
+      const pattern_windows_table<Site> pattern_windows_table<Site>::instance;
+#endif  // __SYNTHESIS__ not defined
+
       template <typename Site, typename T_IN, typename T_OUT>
       void find_pattern_windows_op(const T_IN& in0, T_OUT& par0, T_OUT& par1, T_OUT& par2, T_OUT& par3) {
         static_assert(is_ap_int_type<T_IN>::value, "T_IN type check failed");
         static_assert(is_ap_int_type<T_OUT>::value, "T_OUT type check failed");
 
-        const unsigned int M_TABLE = (1u << trk_zone_t::width);
-        const unsigned int N_TABLE = (1u << trk_patt_t::width);
         static_assert(T_IN::width == (trk_zone_t::width + trk_patt_t::width), "T_IN_type check failed");
 
 #ifndef __SYNTHESIS__
-        static bool initialized = false;
-        static int pattern_col_start_table[M_TABLE * N_TABLE];
-        static int pattern_col_mid_table[M_TABLE * N_TABLE];
-        static int pattern_col_stop_table[M_TABLE * N_TABLE];
-        static int pattern_col_pad_table[M_TABLE * N_TABLE];
+        typedef pattern_windows_table<Site> table_t;
+
+        // Lookup
+        emtf_assert(in0 < (table_t::M_TABLE * table_t::N_TABLE));
+        const pattern_windows_t& x_i = table_t::instance.data[in0];
 #else
+        const unsigned int M_TABLE = (1u << trk_zone_t::width);
+        const unsigned int N_TABLE = (1u << trk_patt_t::width);
+
         bool initialized = false;
         int pattern_col_start_table[M_TABLE * N_TABLE];
         int pattern_col_mid_table[M_TABLE * N_TABLE];
         int pattern_col_stop_table[M_TABLE * N_TABLE];
         int pattern_col_pad_table[M_TABLE * N_TABLE];
-#endif  // __SYNTHESIS__ not defined
 
         if (!initialized) {
           initialized = true;
@@ -86,6 +128,8 @@ namespace emtf_hlslib {
         // Lookup
         emtf_assert(in0 < (M_TABLE * N_TABLE));
         const quad_param_t& x_i = quad_param_table[in0];
+#endif  // __SYNTHESIS__ not defined
+
         par0 = x_i.par0;
         par1 = x_i.par1;
         par2 = x_i.par2;
@@ -376,17 +420,17 @@ namespace emtf_hlslib {
       const unsigned int num_gate_segments = trkbuilding_internal_config::num_gate_segments;
 
 #ifndef __SYNTHESIS__
-      static bool initialized = false;
-      static int segment_id_table[num_site_segments];
+      typedef detail::static_lookup_table<int, num_site_segments, detail::get_segment_id_op<Site> > segment_id_table_t;
+      const int(&segment_id_table)[num_site_segments] = segment_id_table_t::instance.data;
 #else
       bool initialized = false;
       int segment_id_table[num_site_segments];
-#endif  // __SYNTHESIS__ not defined
 
       if (!initialized) {
         initialized = true;
         detail::init_table_op<num_site_segments>(segment_id_table, detail::get_segment_id_op<Site>());
       }
+#endif  // __SYNTHESIS__ not defined
 
       // Intermediate arrays
       emtf_phi_t emtf_phi_mhph[num_site_segments];
@@ -823,16 +867,20 @@ namespace emtf_hlslib {
       const emtf_theta_t invalid_marker_th = detail::th_invalid;
 
 #ifndef __SYNTHESIS__
-      static bool initialized = false;
-      static int theta_indices_table[num_theta_values];
-      static int theta_indices_alt_table[num_theta_values];
-      static int theta_indices_me1_table[num_theta_values];
+      typedef detail::static_lookup_table<int, num_theta_values, detail::get_trk_theta_indices_op>
+          theta_indices_table_t;
+      typedef detail::static_lookup_table<int, num_theta_values, detail::get_trk_theta_indices_alt_op>
+          theta_indices_alt_table_t;
+      typedef detail::static_lookup_table<int, num_theta_values, detail::get_trk_theta_indices_me1_op>
+          theta_indices_me1_table_t;
+      const int(&theta_indices_table)[num_theta_values] = theta_indices_table_t::instance.data;
+      const int(&theta_indices_alt_table)[num_theta_values] = theta_indices_alt_table_t::instance.data;
+      const int(&theta_indices_me1_table)[num_theta_values] = theta_indices_me1_table_t::instance.data;
 #else
       bool initialized = false;
       int theta_indices_table[num_theta_values];
       int theta_indices_alt_table[num_theta_values];
       int theta_indices_me1_table[num_theta_values];
-#endif  // __SYNTHESIS__ not defined
 
       if (!initialized) {
         initialized = true;
@@ -840,6 +888,7 @@ namespace emtf_hlslib {
         detail::init_table_op<num_theta_values>(theta_indices_alt_table, detail::get_trk_theta_indices_alt_op());
         detail::init_table_op<num_theta_values>(theta_indices_me1_table, detail::get_trk_theta_indices_me1_op());
       }
+#endif  // __SYNTHESIS__ not defined
 
       // Intermediate arrays
       emtf_theta_t theta_values[num_theta_values];
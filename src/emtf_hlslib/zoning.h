@@ -396,16 +396,16 @@ namespace emtf_hlslib {
       static_assert(N == detail::num_chambers_traits<chamber_category>::value, "N value check failed");
 
 #ifndef __SYNTHESIS__
-      static bool initialized = false;
-      static int chamber_id_table[N];
-      static int chamber_ph_init_table[N];
-      static int chamber_ph_cover_table[N];
+      typedef detail::static_lookup_table<int, N, detail::get_chamber_id_op<Row> > chamber_id_table_t;
+      typedef detail::static_lookup_table<int, N, detail::get_chamber_ph_init_op<chamber_category> >
+          chamber_ph_init_table_t;
+      const int(&chamber_id_table)[N] = chamber_id_table_t::instance.data;
+      const int(&chamber_ph_init_table)[N] = chamber_ph_init_table_t::instance.data;
 #else
       bool initialized = false;
       int chamber_id_table[N];
       int chamber_ph_init_table[N];
       int chamber_ph_cover_table[N];
-#endif  // __SYNTHESIS__ not defined
 
       if (!initialized) {
         initialized = true;
@@ -413,6 +413,7 @@ namespace emtf_hlslib {
         detail::init_table_op<N>(chamber_ph_init_table, detail::get_chamber_ph_init_op<chamber_category>{});
         detail::init_table_op<N>(chamber_ph_cover_table, detail::get_chamber_ph_cover_op<chamber_category>{});
       }
+#endif  // __SYNTHESIS__ not defined
 
       // Translate zone, timezone into bit selection
       constexpr int the_zone = detail::zone_traits<Zone>::value;
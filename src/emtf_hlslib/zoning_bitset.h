@@ -0,0 +1,230 @@
+#ifndef __EMTF_HLSLIB_ZONING_BITSET_H__
+#define __EMTF_HLSLIB_ZONING_BITSET_H__
+
+// Word-parallel implementation of zoning_layer for the CPU. It is not meant for synthesis.
+//
+// Each row of a zone image is held in 64-bit words instead of an ap_uint<288>. The segments are
+// set directly at their column in the zone image, so the chamber images are never built and
+// there is no range() slicing. After zoning_bitset_to_image_op, the rows are identical to the
+// output of zoning_layer.
+//
+// Function hierarchy
+//
+// zoning_bitset_layer
+// +-- zoning_bitset_op (INLINE)
+//     +-- zoning_bitset_row_op (INLINE)
+//         +-- zoning_bitset_row_fill_op (INLINE)
+
+#include <cstdint>
+
+// EMTF HLS
+#include "layer_helpers.h"
+
+namespace emtf_hlslib {
+
+  namespace phase2 {
+
+    struct zoning_bitset_config {
+      typedef uint64_t word_t;
+      constexpr static const int word_bw = 64;
+      constexpr static const int n_words = (num_emtf_img_cols + word_bw - 1) / word_bw;
+    };
+
+    // One row of a zone image. Column c is bit (c % 64) of words[c / 64]. The bits beyond
+    // num_emtf_img_cols are always zero.
+    struct zoning_bitset_row_t {
+      zoning_bitset_config::word_t words[zoning_bitset_config::n_words];
+    };
+
+    // _____________________________________________________________________________
+    // Set the segments of the chambers in Row. This gives the same columns as zoning_row_gather_op
+    // followed by zoning_row_join_op: a chamber covers [ph_init, ph_cover) and the zone image starts
+    // at chamber_img_joined_col_start, anything outside is dropped.
+
+    template <typename Zone, typename Timezone, typename Row>
+    void zoning_bitset_row_fill_op(const emtf_phi_t emtf_phi[model_config::n_in],
+                                   const seg_zones_t seg_zones[model_config::n_in],
+                                   const seg_tzones_t seg_tzones[model_config::n_in],
+                                   const seg_valid_t seg_valid[model_config::n_in],
+                                   zoning_bitset_row_t& out) {
+      typedef typename detail::chamber_category_traits<Row>::chamber_category chamber_category;
+      const unsigned int N = detail::num_chambers_traits<chamber_category>::value;
+
+      const auto get_chamber_id = detail::get_chamber_id_op<Row>{};
+      const auto get_chamber_ph_init = detail::get_chamber_ph_init_op<chamber_category>{};
+      const auto get_chamber_ph_cover = detail::get_chamber_ph_cover_op<chamber_category>{};
+
+      // Translate zone, timezone into bit selection
+      constexpr int the_zone = detail::zone_traits<Zone>::value;
+      constexpr int the_tzone = detail::timezone_traits<Timezone>::value;
+      constexpr int bit_sel_zone = (num_emtf_zones - 1) - the_zone;
+      constexpr int bit_sel_tzone = (num_emtf_timezones - 1) - the_tzone;
+
+      constexpr int bits_to_shift = emtf_img_col_factor_log2;
+      constexpr unsigned col_mask = (1u << trk_col_t::width) - 1;
+      constexpr int word_bw_log2 = 6;
+      static_assert(zoning_bitset_config::word_bw == (1 << word_bw_log2), "word_bw check failed");
+
+      // Loop over chambers
+      for (unsigned i = 0; i < N; i++) {
+        const int chamber_id = get_chamber_id(i);
+        const int ph_init = get_chamber_ph_init(i);
+        const int col_stop = get_chamber_ph_cover(i) - ph_init;
+        const int col_offset = ph_init - detail::chamber_img_joined_col_start;  // can be negative
+        emtf_assert(chamber_id < num_emtf_chambers);
+
+        // Loop over segments
+        for (unsigned j = 0; j < num_emtf_segments; j++) {
+          const unsigned iseg = static_cast<unsigned>(chamber_id * num_emtf_segments) + j;
+
+          // Condition: is_valid_seg && is_same_zone && is_same_timezone
+          const bool valid = ((seg_valid[iseg] == 1) and ((seg_zones[iseg].to_uint() >> bit_sel_zone) & 1u) and
+                              ((seg_tzones[iseg].to_uint() >> bit_sel_tzone) & 1u));
+          if (not valid)
+            continue;
+
+          // Translate emtf_phi to col, with the same wraparound as trk_col_t (unsafe math)
+          const unsigned ph0 = emtf_phi[iseg].to_uint();
+          const int col = static_cast<int>(((ph0 >> bits_to_shift) - ph_init) & col_mask);
+          emtf_assert(static_cast<int>(ph0 >> bits_to_shift) >= ph_init);
+          emtf_assert(col < detail::chamber_img_bw);
+
+          const int img_col = col + col_offset;
+          if ((col < col_stop) and (img_col >= 0)) {
+            emtf_assert(img_col < num_emtf_img_cols);
+            out.words[img_col >> word_bw_log2] |= (zoning_bitset_config::word_t(1)
+                                                   << (img_col & (zoning_bitset_config::word_bw - 1)));
+          }
+        }  // end loop over segments
+      }    // end loop over chambers
+    }
+
+    template <typename Zone, typename Timezone, typename Row, typename SecondRow = Row>
+    void zoning_bitset_row_op(const emtf_phi_t emtf_phi[model_config::n_in],
+                              const seg_zones_t seg_zones[model_config::n_in],
+                              const seg_tzones_t seg_tzones[model_config::n_in],
+                              const seg_valid_t seg_valid[model_config::n_in],
+                              zoning_bitset_row_t& zoning_out_row_k) {
+      for (int k = 0; k < zoning_bitset_config::n_words; k++) {
+        zoning_out_row_k.words[k] = 0;  // init as zero
+      }
+
+      zoning_bitset_row_fill_op<Zone, Timezone, Row>(emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out_row_k);
+
+      if (!is_same<Row, SecondRow>::value) {  // enable if Row and SecondRow are different
+        zoning_bitset_row_fill_op<Zone, Timezone, SecondRow>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out_row_k);
+      }
+    }
+
+    // _____________________________________________________________________________
+    // Zoning op, with the same rows as zoning_op
+
+    template <typename Zone, typename Timezone>
+    void zoning_bitset_op(const emtf_phi_t emtf_phi[model_config::n_in],
+                          const seg_zones_t seg_zones[model_config::n_in],
+                          const seg_tzones_t seg_tzones[model_config::n_in],
+                          const seg_valid_t seg_valid[model_config::n_in],
+                          zoning_bitset_row_t zoning_out[zoning_config::n_out]) {
+      // Loop over the rows manually
+      if (is_same<Zone, m_zone_0_tag>::value) {  // enable if Zone 0
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_0_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[0]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_1_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[1]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_2_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[2]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_3_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[3]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_4_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[4]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_5_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[5]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_6_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[6]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_0_row_7_0_tag, m_zone_0_row_7_1_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[7]);
+
+      } else if (is_same<Zone, m_zone_1_tag>::value) {  // enable if Zone 1
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_0_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[0]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_1_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[1]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_2_0_tag, m_zone_1_row_2_1_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[2]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_3_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[3]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_4_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[4]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_5_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[5]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_6_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[6]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_1_row_7_0_tag, m_zone_1_row_7_1_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[7]);
+
+      } else if (is_same<Zone, m_zone_2_tag>::value) {  // enable if Zone 2
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_0_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[0]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_1_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[1]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_2_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[2]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_3_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[3]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_4_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[4]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_5_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[5]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_6_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[6]);
+        zoning_bitset_row_op<Zone, Timezone, m_zone_2_row_7_tag>(
+            emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_out[7]);
+      }
+    }
+
+    // _____________________________________________________________________________
+    // Convert one row to the zoning_layer output type
+
+    template <typename T_OUT>
+    void zoning_bitset_to_image_op(const zoning_bitset_row_t& in0, T_OUT& out) {
+      static_assert(is_same<T_OUT, zoning_out_t>::value, "T_OUT type check failed");
+
+      // Loop over words
+      for (int k = 0; k < zoning_bitset_config::n_words; k++) {
+        const int lo = k * zoning_bitset_config::word_bw;
+        const int hi = (lo + zoning_bitset_config::word_bw <= T_OUT::width) ? (lo + zoning_bitset_config::word_bw - 1)
+                                                                             : (T_OUT::width - 1);
+        out.range(hi, lo) = in0.words[k];
+      }  // end loop over words
+    }
+
+    // _____________________________________________________________________________
+    // Entry point
+
+    template <typename Zone>
+    void zoning_bitset_layer(const emtf_phi_t emtf_phi[model_config::n_in],
+                             const seg_zones_t seg_zones[model_config::n_in],
+                             const seg_tzones_t seg_tzones[model_config::n_in],
+                             const seg_valid_t seg_valid[model_config::n_in],
+                             zoning_bitset_row_t zoning_0_out[zoning_config::n_out],
+                             zoning_bitset_row_t zoning_1_out[zoning_config::n_out],
+                             zoning_bitset_row_t zoning_2_out[zoning_config::n_out]) {
+      // Check assumptions
+      static_assert(zoning_config::n_out == num_emtf_img_rows, "zoning_config::n_out check failed");
+      static_assert(zoning_out_t::width == num_emtf_img_cols, "zoning_out_t width check failed");
+      static_assert(detail::chamber_img_joined_col_start >= 0, "chamber_img_joined_col_start check failed");
+
+      typedef m_timezone_0_tag Timezone;  // default timezone
+
+      // Loop over the zones manually
+      zoning_bitset_op<m_zone_0_tag, Timezone>(emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_0_out);
+      zoning_bitset_op<m_zone_1_tag, Timezone>(emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_1_out);
+      zoning_bitset_op<m_zone_2_tag, Timezone>(emtf_phi, seg_zones, seg_tzones, seg_valid, zoning_2_out);
+    }
+
+  }  // namespace phase2
+
+}  // namespace emtf_hlslib
+
+#endif  // __EMTF_HLSLIB_ZONING_BITSET_H__ not defined
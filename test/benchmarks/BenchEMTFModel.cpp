@@ -0,0 +1,478 @@
+// Microbenchmarks of the emtf_hlslib layers, in the order they are called by
+// EMTFModel::fit_impl_v3(), and of the end-to-end EMTFModel::fit().
+//
+// Each benchmark cycles over a set of sector fixtures, and the time per iteration is the time per
+// sector. The fixtures are synthetic (see SectorFixtures.h). A sector tensor file written with
+// tensorFileName can be given as argument to add the recorded sectors as a fixture.
+//
+// Usage: BenchEMTFModel [--benchmark_filter=<regex>] [<tensor_file>]
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFModel.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SectorTensorFile.h"
+#include "L1Trigger/Phase2L1EMTF/src/emtf_hlslib.h"
+#include "L1Trigger/Phase2L1EMTF/test/benchmarks/SectorFixtures.h"
+
+using namespace emtf_hlslib::phase2;
+
+namespace {
+
+  constexpr int num_fixture_sectors = 64;
+  constexpr size_t max_file_sectors = 4096;
+
+  // Input and intermediate arrays of one sector, same as in EMTFModel::fit_impl_v3()
+  struct SectorState {
+    // Unpacked from in0
+    emtf_phi_t emtf_phi[model_config::n_in];
+    emtf_bend_t emtf_bend[model_config::n_in];
+    emtf_theta1_t emtf_theta1[model_config::n_in];
+    emtf_theta2_t emtf_theta2[model_config::n_in];
+    emtf_qual1_t emtf_qual1[model_config::n_in];
+    emtf_qual2_t emtf_qual2[model_config::n_in];
+    emtf_time_t emtf_time[model_config::n_in];
+    seg_zones_t seg_zones[model_config::n_in];
+    seg_tzones_t seg_tzones[model_config::n_in];
+    seg_cscfr_t seg_cscfr[model_config::n_in];
+    seg_gemdl_t seg_gemdl[model_config::n_in];
+    seg_bx_t seg_bx[model_config::n_in];
+    seg_valid_t seg_valid[model_config::n_in];
+
+    // Layers 0..3
+    zoning_out_t zoning_0_out[zoning_config::n_out];
+    zoning_out_t zoning_1_out[zoning_config::n_out];
+    zoning_out_t zoning_2_out[zoning_config::n_out];
+    pooling_out_t pooling_0_out[pooling_config::n_out];
+    pooling_out_t pooling_1_out[pooling_config::n_out];
+    pooling_out_t pooling_2_out[pooling_config::n_out];
+    zonesorting_out_t zonesorting_0_out[zonesorting_config::n_out];
+    zonesorting_out_t zonesorting_1_out[zonesorting_config::n_out];
+    zonesorting_out_t zonesorting_2_out[zonesorting_config::n_out];
+    zonemerging_out_t zonemerging_0_out[zonemerging_config::n_out];
+
+    // Layer 0 as word bitsets, for the CPU implementations
+    zoning_bitset_row_t zoning_0_bits[zoning_config::n_out];
+    zoning_bitset_row_t zoning_1_bits[zoning_config::n_out];
+    zoning_bitset_row_t zoning_2_bits[zoning_config::n_out];
+
+    // Unpacked from in1
+    trk_qual_t trk_qual[trkbuilding_config::n_in];
+    trk_patt_t trk_patt[trkbuilding_config::n_in];
+    trk_col_t trk_col[trkbuilding_config::n_in];
+    trk_zone_t trk_zone[trkbuilding_config::n_in];
+    trk_tzone_t trk_tzone[trkbuilding_config::n_in];
+
+    // Layers 4..5
+    trk_seg_t trk_seg[trkbuilding_config::n_out * num_emtf_sites];
+    trk_seg_v_t trk_seg_v[trkbuilding_config::n_out];
+    trk_feat_t trk_feat[trkbuilding_config::n_out * num_emtf_features];
+    trk_valid_t trk_valid[trkbuilding_config::n_out];
+    trk_seg_t trk_seg_rm[duperemoval_config::n_out * num_emtf_sites];
+    trk_seg_v_t trk_seg_rm_v[duperemoval_config::n_out];
+    trk_feat_t trk_feat_rm[duperemoval_config::n_out * num_emtf_features];
+    trk_valid_t trk_valid_rm[duperemoval_config::n_out];
+    trk_origin_t trk_origin_rm[duperemoval_config::n_out];
+  };
+
+  struct Fixture {
+    std::vector<std::vector<int> > in0;                 // per sector
+    std::vector<std::unique_ptr<SectorState> > states;  // per sector
+  };
+
+  // ___________________________________________________________________________
+  // Layer wrappers, same calls as in EMTFModel::fit_impl_v3()
+
+  void unpack_in0(const std::vector<int>& in0, SectorState& st) {
+    auto in0_iter = in0.begin();
+
+    for (unsigned iseg = 0; iseg < model_config::n_in; iseg++) {
+      st.emtf_phi[iseg] = *(in0_iter++);
+      st.emtf_bend[iseg] = *(in0_iter++);
+      st.emtf_theta1[iseg] = *(in0_iter++);
+      st.emtf_theta2[iseg] = *(in0_iter++);
+      st.emtf_qual1[iseg] = *(in0_iter++);
+      st.emtf_qual2[iseg] = *(in0_iter++);
+      st.emtf_time[iseg] = *(in0_iter++);
+      st.seg_zones[iseg] = *(in0_iter++);
+      st.seg_tzones[iseg] = *(in0_iter++);
+      st.seg_cscfr[iseg] = *(in0_iter++);
+      st.seg_gemdl[iseg] = *(in0_iter++);
+      st.seg_bx[iseg] = *(in0_iter++);
+      st.seg_valid[iseg] = *(in0_iter++);
+    }
+  }
+
+  void run_zoning(const SectorState& st,
+                  zoning_out_t zoning_0_out[zoning_config::n_out],
+                  zoning_out_t zoning_1_out[zoning_config::n_out],
+                  zoning_out_t zoning_2_out[zoning_config::n_out]) {
+    zoning_layer<m_zone_any_tag>(
+        st.emtf_phi, st.seg_zones, st.seg_tzones, st.seg_valid, zoning_0_out, zoning_1_out, zoning_2_out);
+  }
+
+  void run_zonesorting(const SectorState& st,
+                       zonesorting_out_t zonesorting_0_out[zonesorting_config::n_out],
+                       zonesorting_out_t zonesorting_1_out[zonesorting_config::n_out],
+                       zonesorting_out_t zonesorting_2_out[zonesorting_config::n_out]) {
+    zonesorting_layer<m_zone_any_tag>(st.pooling_0_out, zonesorting_0_out);
+    zonesorting_layer<m_zone_any_tag>(st.pooling_1_out, zonesorting_1_out);
+    zonesorting_layer<m_zone_any_tag>(st.pooling_2_out, zonesorting_2_out);
+  }
+
+  void unpack_in1(SectorState& st) {
+    for (unsigned itrk = 0; itrk < trkbuilding_config::n_in; itrk++) {
+      const trkbuilding_in_t curr_trk_in = st.zonemerging_0_out[itrk];
+
+      constexpr int bits_lo_0 = 0;
+      constexpr int bits_lo_1 = trk_qual_t::width;
+      constexpr int bits_lo_2 = pooling_out_t::width;
+      constexpr int bits_lo_3 = zonesorting_out_t::width;
+      constexpr int bits_lo_4 = zonemerging_out_t::width;
+
+      st.trk_qual[itrk] = curr_trk_in.range(bits_lo_1 - 1, bits_lo_0);
+      st.trk_patt[itrk] = curr_trk_in.range(bits_lo_2 - 1, bits_lo_1);
+      st.trk_col[itrk] = curr_trk_in.range(bits_lo_3 - 1, bits_lo_2);
+      st.trk_zone[itrk] = curr_trk_in.range(bits_lo_4 - 1, bits_lo_3);
+      st.trk_tzone[itrk] = detail::timezone_traits<m_timezone_0_tag>::value;  // default timezone
+    }
+  }
+
+  void run_trkbuilding(const SectorState& st,
+                       trk_seg_t trk_seg[trkbuilding_config::n_out * num_emtf_sites],
+                       trk_seg_v_t trk_seg_v[trkbuilding_config::n_out],
+                       trk_feat_t trk_feat[trkbuilding_config::n_out * num_emtf_features],
+                       trk_valid_t trk_valid[trkbuilding_config::n_out]) {
+    for (unsigned itrk = 0; itrk < trkbuilding_config::n_in; itrk++) {
+      trkbuilding_layer<m_zone_any_tag>(st.emtf_phi,
+                                        st.emtf_bend,
+                                        st.emtf_theta1,
+                                        st.emtf_theta2,
+                                        st.emtf_qual1,
+                                        st.emtf_qual2,
+                                        st.emtf_time,
+                                        st.seg_zones,
+                                        st.seg_tzones,
+                                        st.seg_cscfr,
+                                        st.seg_gemdl,
+                                        st.seg_bx,
+                                        st.seg_valid,
+                                        st.trk_qual[itrk],
+                                        st.trk_patt[itrk],
+                                        st.trk_col[itrk],
+                                        st.trk_zone[itrk],
+                                        st.trk_tzone[itrk],
+                                        &(trk_seg[itrk * num_emtf_sites]),
+                                        trk_seg_v[itrk],
+                                        &(trk_feat[itrk * num_emtf_features]),
+                                        trk_valid[itrk]);
+    }
+  }
+
+  void run_duperemoval(const SectorState& st,
+                       trk_seg_t trk_seg_rm[duperemoval_config::n_out * num_emtf_sites],
+                       trk_seg_v_t trk_seg_rm_v[duperemoval_config::n_out],
+                       trk_feat_t trk_feat_rm[duperemoval_config::n_out * num_emtf_features],
+                       trk_valid_t trk_valid_rm[duperemoval_config::n_out],
+                       trk_origin_t trk_origin_rm[duperemoval_config::n_out]) {
+    duperemoval_layer<m_zone_any_tag>(st.trk_seg,
+                                      st.trk_seg_v,
+                                      st.trk_feat,
+                                      st.trk_valid,
+                                      trk_seg_rm,
+                                      trk_seg_rm_v,
+                                      trk_feat_rm,
+                                      trk_valid_rm,
+                                      trk_origin_rm);
+  }
+
+  // Returns the num of valid tracks, as the layer is skipped for the invalid ones
+  int run_fullyconnect(const SectorState& st,
+                       trk_invpt_t trk_invpt[fullyconnect_config::n_out],
+                       trk_phi_t trk_phi[fullyconnect_config::n_out],
+                       trk_eta_t trk_eta[fullyconnect_config::n_out],
+                       trk_d0_t trk_d0[fullyconnect_config::n_out],
+                       trk_z0_t trk_z0[fullyconnect_config::n_out],
+                       trk_beta_t trk_beta[fullyconnect_config::n_out]) {
+    int num_valid = 0;
+
+    for (unsigned itrk = 0; itrk < fullyconnect_config::n_in; itrk++) {
+      if (not st.trk_valid_rm[itrk])
+        continue;
+
+      fullyconnect_layer<m_zone_any_tag>(&(st.trk_feat_rm[itrk * num_emtf_features]),
+                                         trk_invpt[itrk],
+                                         trk_phi[itrk],
+                                         trk_eta[itrk],
+                                         trk_d0[itrk],
+                                         trk_z0[itrk],
+                                         trk_beta[itrk]);
+      ++num_valid;
+    }
+    return num_valid;
+  }
+
+  // Run all the layers once to get the inputs of every layer
+  std::unique_ptr<SectorState> make_state(const std::vector<int>& in0) {
+    auto st = std::make_unique<SectorState>();
+    unpack_in0(in0, *st);
+    run_zoning(*st, st->zoning_0_out, st->zoning_1_out, st->zoning_2_out);
+    zoning_bitset_layer<m_zone_any_tag>(st->emtf_phi,
+                                        st->seg_zones,
+                                        st->seg_tzones,
+                                        st->seg_valid,
+                                        st->zoning_0_bits,
+                                        st->zoning_1_bits,
+                                        st->zoning_2_bits);
+    pooling_layer<m_zone_0_tag>(st->zoning_0_out, st->pooling_0_out);
+    pooling_layer<m_zone_1_tag>(st->zoning_1_out, st->pooling_1_out);
+    pooling_layer<m_zone_2_tag>(st->zoning_2_out, st->pooling_2_out);
+    run_zonesorting(*st, st->zonesorting_0_out, st->zonesorting_1_out, st->zonesorting_2_out);
+    zonemerging_layer<m_zone_any_tag>(
+        st->zonesorting_0_out, st->zonesorting_1_out, st->zonesorting_2_out, st->zonemerging_0_out);
+    unpack_in1(*st);
+    run_trkbuilding(*st, st->trk_seg, st->trk_seg_v, st->trk_feat, st->trk_valid);
+    run_duperemoval(*st, st->trk_seg_rm, st->trk_seg_rm_v, st->trk_feat_rm, st->trk_valid_rm, st->trk_origin_rm);
+    return st;
+  }
+
+  Fixture make_fixture(std::vector<std::vector<int> >&& in0) {
+    Fixture fixture;
+    fixture.in0 = std::move(in0);
+    for (const auto& sector_in0 : fixture.in0) {
+      fixture.states.push_back(make_state(sector_in0));
+    }
+    return fixture;
+  }
+
+  // ___________________________________________________________________________
+  // Benchmarks
+
+  void BM_zoning(benchmark::State& state, const Fixture* fixture) {
+    zoning_out_t zoning_0_out[zoning_config::n_out];
+    zoning_out_t zoning_1_out[zoning_config::n_out];
+    zoning_out_t zoning_2_out[zoning_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      run_zoning(*fixture->states[i++ % fixture->states.size()], zoning_0_out, zoning_1_out, zoning_2_out);
+      benchmark::DoNotOptimize(zoning_0_out);
+      benchmark::DoNotOptimize(zoning_1_out);
+      benchmark::DoNotOptimize(zoning_2_out);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void BM_zoning_bitset(benchmark::State& state, const Fixture* fixture) {
+    zoning_bitset_row_t zoning_0_bits[zoning_config::n_out];
+    zoning_bitset_row_t zoning_1_bits[zoning_config::n_out];
+    zoning_bitset_row_t zoning_2_bits[zoning_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      const SectorState& st = *fixture->states[i++ % fixture->states.size()];
+      zoning_bitset_layer<m_zone_any_tag>(
+          st.emtf_phi, st.seg_zones, st.seg_tzones, st.seg_valid, zoning_0_bits, zoning_1_bits, zoning_2_bits);
+      benchmark::DoNotOptimize(zoning_0_bits);
+      benchmark::DoNotOptimize(zoning_1_bits);
+      benchmark::DoNotOptimize(zoning_2_bits);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <typename Zone>
+  void BM_pooling(benchmark::State& state, const Fixture* fixture) {
+    constexpr int zone = detail::zone_traits<Zone>::value;
+    pooling_out_t pooling_out[pooling_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      const SectorState& st = *fixture->states[i++ % fixture->states.size()];
+      const zoning_out_t* pooling_in =
+          (zone == 0) ? st.zoning_0_out : ((zone == 1) ? st.zoning_1_out : st.zoning_2_out);
+      pooling_layer<Zone>(pooling_in, pooling_out);
+      benchmark::DoNotOptimize(pooling_out);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <typename Zone>
+  void BM_pooling_bitset(benchmark::State& state, const Fixture* fixture) {
+    constexpr int zone = detail::zone_traits<Zone>::value;
+    pooling_out_t pooling_out[pooling_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      const SectorState& st = *fixture->states[i++ % fixture->states.size()];
+      const zoning_bitset_row_t* pooling_in =
+          (zone == 0) ? st.zoning_0_bits : ((zone == 1) ? st.zoning_1_bits : st.zoning_2_bits);
+      pooling_bitset_layer<Zone>(pooling_in, pooling_out);
+      benchmark::DoNotOptimize(pooling_out);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void BM_zonesorting(benchmark::State& state, const Fixture* fixture) {
+    zonesorting_out_t zonesorting_0_out[zonesorting_config::n_out];
+    zonesorting_out_t zonesorting_1_out[zonesorting_config::n_out];
+    zonesorting_out_t zonesorting_2_out[zonesorting_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      run_zonesorting(
+          *fixture->states[i++ % fixture->states.size()], zonesorting_0_out, zonesorting_1_out, zonesorting_2_out);
+      benchmark::DoNotOptimize(zonesorting_0_out);
+      benchmark::DoNotOptimize(zonesorting_1_out);
+      benchmark::DoNotOptimize(zonesorting_2_out);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void BM_zonemerging(benchmark::State& state, const Fixture* fixture) {
+    zonemerging_out_t zonemerging_0_out[zonemerging_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      const SectorState& st = *fixture->states[i++ % fixture->states.size()];
+      zonemerging_layer<m_zone_any_tag>(
+          st.zonesorting_0_out, st.zonesorting_1_out, st.zonesorting_2_out, zonemerging_0_out);
+      benchmark::DoNotOptimize(zonemerging_0_out);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void BM_trkbuilding(benchmark::State& state, const Fixture* fixture) {
+    trk_seg_t trk_seg[trkbuilding_config::n_out * num_emtf_sites];
+    trk_seg_v_t trk_seg_v[trkbuilding_config::n_out];
+    trk_feat_t trk_feat[trkbuilding_config::n_out * num_emtf_features];
+    trk_valid_t trk_valid[trkbuilding_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      run_trkbuilding(*fixture->states[i++ % fixture->states.size()], trk_seg, trk_seg_v, trk_feat, trk_valid);
+      benchmark::DoNotOptimize(trk_seg);
+      benchmark::DoNotOptimize(trk_feat);
+      benchmark::DoNotOptimize(trk_valid);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void BM_duperemoval(benchmark::State& state, const Fixture* fixture) {
+    trk_seg_t trk_seg_rm[duperemoval_config::n_out * num_emtf_sites];
+    trk_seg_v_t trk_seg_rm_v[duperemoval_config::n_out];
+    trk_feat_t trk_feat_rm[duperemoval_config::n_out * num_emtf_features];
+    trk_valid_t trk_valid_rm[duperemoval_config::n_out];
+    trk_origin_t trk_origin_rm[duperemoval_config::n_out];
+    size_t i = 0;
+
+    for (auto _ : state) {
+      run_duperemoval(*fixture->states[i++ % fixture->states.size()],
+                      trk_seg_rm,
+                      trk_seg_rm_v,
+                      trk_feat_rm,
+                      trk_valid_rm,
+                      trk_origin_rm);
+      benchmark::DoNotOptimize(trk_seg_rm);
+      benchmark::DoNotOptimize(trk_feat_rm);
+      benchmark::DoNotOptimize(trk_valid_rm);
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void BM_fullyconnect(benchmark::State& state, const Fixture* fixture) {
+    trk_invpt_t trk_invpt[fullyconnect_config::n_out];
+    trk_phi_t trk_phi[fullyconnect_config::n_out];
+    trk_eta_t trk_eta[fullyconnect_config::n_out];
+    trk_d0_t trk_d0[fullyconnect_config::n_out];
+    trk_z0_t trk_z0[fullyconnect_config::n_out];
+    trk_beta_t trk_beta[fullyconnect_config::n_out];
+    size_t i = 0;
+    int64_t num_tracks = 0;
+
+    for (auto _ : state) {
+      num_tracks += run_fullyconnect(
+          *fixture->states[i++ % fixture->states.size()], trk_invpt, trk_phi, trk_eta, trk_d0, trk_z0, trk_beta);
+      benchmark::DoNotOptimize(trk_invpt);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["tracks/sector"] = static_cast<double>(num_tracks) / state.iterations();
+  }
+
+  void BM_fit(benchmark::State& state, const Fixture* fixture) {
+    const emtf::phase2::EMTFModel model;
+    std::vector<int> out(model.get_output_shape().num_elements(), 0);
+    size_t i = 0;
+
+    for (auto _ : state) {
+      model.fit(fixture->in0[i++ % fixture->in0.size()].data(), out.data());
+      benchmark::DoNotOptimize(out.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void register_benchmarks(const std::string& name, const Fixture* fixture) {
+    benchmark::RegisterBenchmark(("zoning/" + name).c_str(), BM_zoning, fixture);
+    benchmark::RegisterBenchmark(("zoning_bitset/" + name).c_str(), BM_zoning_bitset, fixture);
+    benchmark::RegisterBenchmark(("pooling_zone0/" + name).c_str(), BM_pooling<m_zone_0_tag>, fixture);
+    benchmark::RegisterBenchmark(("pooling_zone1/" + name).c_str(), BM_pooling<m_zone_1_tag>, fixture);
+    benchmark::RegisterBenchmark(("pooling_zone2/" + name).c_str(), BM_pooling<m_zone_2_tag>, fixture);
+    benchmark::RegisterBenchmark(("pooling_bitset_zone0/" + name).c_str(), BM_pooling_bitset<m_zone_0_tag>, fixture);
+    benchmark::RegisterBenchmark(("pooling_bitset_zone1/" + name).c_str(), BM_pooling_bitset<m_zone_1_tag>, fixture);
+    benchmark::RegisterBenchmark(("pooling_bitset_zone2/" + name).c_str(), BM_pooling_bitset<m_zone_2_tag>, fixture);
+    benchmark::RegisterBenchmark(("zonesorting/" + name).c_str(), BM_zonesorting, fixture);
+    benchmark::RegisterBenchmark(("zonemerging/" + name).c_str(), BM_zonemerging, fixture);
+    benchmark::RegisterBenchmark(("trkbuilding/" + name).c_str(), BM_trkbuilding, fixture);
+    benchmark::RegisterBenchmark(("duperemoval/" + name).c_str(), BM_duperemoval, fixture);
+    benchmark::RegisterBenchmark(("fullyconnect/" + name).c_str(), BM_fullyconnect, fixture);
+    benchmark::RegisterBenchmark(("fit/" + name).c_str(), BM_fit, fixture);
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  // The fixtures must outlive the benchmarks
+  std::vector<std::pair<std::string, Fixture> > fixtures;
+
+  unsigned seed = 12345;
+  for (const auto& occupancy : emtf::phase2::fixtures::get_occupancies()) {
+    auto in0 = emtf::phase2::fixtures::make_sectors(occupancy, num_fixture_sectors, seed++);
+    fixtures.emplace_back(occupancy.name, make_fixture(std::move(in0)));
+  }
+
+  // Recorded sectors, if a tensor file is given
+  if (argc > 2) {
+    std::cerr << "Usage: " << argv[0] << " [--benchmark_filter=<regex>] [<tensor_file>]" << std::endl;
+    return 1;
+  } else if (argc == 2) {
+    const emtf::phase2::SectorTensorReader reader(argv[1]);
+    if (not reader.is_valid() or (reader.header().in0_size != model_config::n_in * num_emtf_variables)) {
+      std::cerr << "Failed to read " << argv[1] << std::endl;
+      return 1;
+    }
+
+    std::vector<std::vector<int> > in0;
+    for (size_t irec = 0; irec < std::min(reader.num_records(), max_file_sectors); ++irec) {
+      const auto& rec = reader.get_record(irec);
+      in0.emplace_back(rec.in0, rec.in0 + reader.header().in0_size);
+    }
+    fixtures.emplace_back("file", make_fixture(std::move(in0)));
+  }
+
+  for (const auto& [name, fixture] : fixtures) {
+    if (not fixture.states.empty()) {
+      register_benchmarks(name, &fixture);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,192 @@
+#ifndef L1Trigger_Phase2L1EMTF_SectorFixtures_h
+#define L1Trigger_Phase2L1EMTF_SectorFixtures_h
+
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/src/emtf_hlslib.h"
+
+namespace emtf {
+
+  namespace phase2 {
+
+    namespace fixtures {
+
+      // Synthetic sector inputs (in0 tensors) for the benchmarks. Each muon leaves one segment in
+      // every row of its zone with some efficiency, at the same column up to a small jitter, so
+      // that the pattern recognition and the track building have real work to do. The rest of the
+      // occupancy comes from uncorrelated segments.
+      struct Occupancy {
+        std::string name;
+        int num_muons;  // per sector
+        int num_noise;  // per sector
+      };
+
+      inline const std::vector<Occupancy>& get_occupancies() {
+        static const std::vector<Occupancy> occupancies = {
+            {"low", 1, 4},      // single muon
+            {"medium", 3, 30},  // PU140-like
+            {"high", 6, 100}};  // PU200-like, high-rate endcap
+        return occupancies;
+      }
+
+      namespace detail {
+
+        using namespace emtf_hlslib::phase2;
+        using namespace emtf_hlslib::phase2::detail;
+
+        struct Row {
+          const int* chamber_id;
+          int size;
+        };
+
+        // Same rows as the zoning layer
+        inline const std::vector<Row>& get_zone_rows(int zone) {
+          static const std::vector<Row> rows_0 = {{chamber_id_zone_0_row_0, 7},
+                                                  {chamber_id_zone_0_row_1, 7},
+                                                  {chamber_id_zone_0_row_2, 7},
+                                                  {chamber_id_zone_0_row_3, 4},
+                                                  {chamber_id_zone_0_row_4, 4},
+                                                  {chamber_id_zone_0_row_5, 4},
+                                                  {chamber_id_zone_0_row_6, 4},
+                                                  {chamber_id_zone_0_row_7_0, 4},
+                                                  {chamber_id_zone_0_row_7_1, 4}};
+          static const std::vector<Row> rows_1 = {{chamber_id_zone_1_row_0, 7},
+                                                  {chamber_id_zone_1_row_1, 7},
+                                                  {chamber_id_zone_1_row_2_0, 7},
+                                                  {chamber_id_zone_1_row_2_1, 7},
+                                                  {chamber_id_zone_1_row_3, 4},
+                                                  {chamber_id_zone_1_row_4, 4},
+                                                  {chamber_id_zone_1_row_5, 11},
+                                                  {chamber_id_zone_1_row_6, 11},
+                                                  {chamber_id_zone_1_row_7_0, 11},
+                                                  {chamber_id_zone_1_row_7_1, 11}};
+          static const std::vector<Row> rows_2 = {{chamber_id_zone_2_row_0, 7},
+                                                  {chamber_id_zone_2_row_1, 7},
+                                                  {chamber_id_zone_2_row_2, 7},
+                                                  {chamber_id_zone_2_row_3, 7},
+                                                  {chamber_id_zone_2_row_4, 7},
+                                                  {chamber_id_zone_2_row_5, 7},
+                                                  {chamber_id_zone_2_row_6, 7},
+                                                  {chamber_id_zone_2_row_7, 7}};
+          return (zone == 0) ? rows_0 : ((zone == 1) ? rows_1 : rows_2);
+        }
+
+        inline const int* get_ph_init(const Row& row) {
+          return (row.size == 7) ? chamber_ph_init_10deg
+                                 : ((row.size == 4) ? chamber_ph_init_20deg : chamber_ph_init_20deg_ext);
+        }
+
+        inline const int* get_ph_cover(const Row& row) {
+          return (row.size == 7) ? chamber_ph_cover_10deg
+                                 : ((row.size == 4) ? chamber_ph_cover_20deg : chamber_ph_cover_20deg_ext);
+        }
+
+        // Theta range (in emtf_theta unit) covered by all the rows of each zone
+        inline int get_theta_lo(int zone) { return (zone == 0) ? 18 : ((zone == 1) ? 28 : 56); }
+        inline int get_theta_hi(int zone) { return (zone == 0) ? 22 : ((zone == 1) ? 30 : 84); }
+
+        // Add a segment to the first free slot of the chamber. Returns false if the chamber is full.
+        inline bool add_segment(std::vector<int>& in0,
+                                std::vector<int>& nsegs,
+                                int chamber,
+                                int zone,
+                                int emtf_phi,
+                                int emtf_theta,
+                                int bend) {
+          if (nsegs[chamber] >= num_emtf_segments)
+            return false;
+
+          const int iseg = (chamber * num_emtf_segments) + nsegs[chamber];
+          auto in0_iter = std::next(in0.begin(), iseg * num_emtf_variables);
+
+          const int seg_zones = (1 << (num_emtf_zones - 1 - zone));
+          const int seg_tzones = (1 << (num_emtf_timezones - 1)) | (1 << (num_emtf_timezones - 2));  // BX 0 and -1
+
+          *(in0_iter++) = emtf_phi;    // emtf_phi
+          *(in0_iter++) = bend;        // emtf_bend
+          *(in0_iter++) = emtf_theta;  // emtf_theta1
+          *(in0_iter++) = emtf_theta;  // emtf_theta2
+          *(in0_iter++) = 6;           // emtf_qual1
+          *(in0_iter++) = 0;           // emtf_qual2
+          *(in0_iter++) = 0;           // emtf_time
+          *(in0_iter++) = seg_zones;   // seg_zones
+          *(in0_iter++) = seg_tzones;  // seg_tzones
+          *(in0_iter++) = 0;           // seg_cscfr
+          *(in0_iter++) = 0;           // seg_gemdl
+          *(in0_iter++) = 0;           // seg_bx
+          *(in0_iter++) = 1;           // seg_valid
+          ++nsegs[chamber];
+          return true;
+        }
+
+      }  // namespace detail
+
+      // Generate num_sectors in0 tensors with a fixed seed, so that the fixtures are reproducible
+      inline std::vector<std::vector<int> > make_sectors(const Occupancy& occupancy, int num_sectors, unsigned seed) {
+        using namespace detail;
+
+        std::mt19937 rng(seed);
+        auto uniform = [&rng](int lo, int hi) -> int { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+        auto bernoulli = [&rng](double p) -> bool { return std::bernoulli_distribution(p)(rng); };
+
+        constexpr double row_efficiency = 0.9;
+
+        std::vector<std::vector<int> > sectors;
+
+        for (int isector = 0; isector < num_sectors; ++isector) {
+          std::vector<int> in0(model_config::n_in * num_emtf_variables, 0);
+          std::vector<int> nsegs(num_emtf_chambers, 0);
+
+          // Muons
+          for (int imuon = 0; imuon < occupancy.num_muons; ++imuon) {
+            const int zone = uniform(0, num_emtf_zones - 1);
+            const int col = uniform(chamber_img_joined_col_start + 8, chamber_img_joined_col_stop - 8);
+            const int emtf_theta = uniform(get_theta_lo(zone), get_theta_hi(zone));
+            const int bend = uniform(-32, 32);
+
+            for (const auto& row : get_zone_rows(zone)) {
+              if (not bernoulli(row_efficiency))
+                continue;
+
+              const int* ph_init = get_ph_init(row);
+              const int* ph_cover = get_ph_cover(row);
+
+              // Find a chamber covering the column
+              for (int i = 0; i < row.size; ++i) {
+                if ((ph_init[i] <= (col - 2)) and ((col + 2) < ph_cover[i])) {
+                  const int hit_col = col + uniform(-2, 2);
+                  const int emtf_phi = (hit_col * emtf_img_col_factor) + uniform(0, emtf_img_col_factor - 1);
+                  add_segment(in0, nsegs, row.chamber_id[i], zone, emtf_phi, emtf_theta + uniform(-1, 1), bend);
+                  break;
+                }
+              }
+            }  // end loop over rows
+          }    // end loop over muons
+
+          // Uncorrelated segments
+          for (int inoise = 0; inoise < occupancy.num_noise; ++inoise) {
+            const int zone = uniform(0, num_emtf_zones - 1);
+            const auto& rows = get_zone_rows(zone);
+            const Row& row = rows.at(uniform(0, rows.size() - 1));
+            const int i = uniform(0, row.size - 1);
+            const int col = uniform(get_ph_init(row)[i], get_ph_cover(row)[i] - 1);
+            const int emtf_phi = (col * emtf_img_col_factor) + uniform(0, emtf_img_col_factor - 1);
+            const int emtf_theta = uniform(get_theta_lo(zone), get_theta_hi(zone));
+            add_segment(in0, nsegs, row.chamber_id[i], zone, emtf_phi, emtf_theta, uniform(-128, 128));
+          }  // end loop over noise
+
+          sectors.push_back(std::move(in0));
+        }  // end loop over sectors
+        return sectors;
+      }
+
+    }  // namespace fixtures
+
+  }  // namespace phase2
+
+}  // namespace emtf
+
+#endif  // L1Trigger_Phase2L1EMTF_SectorFixtures_h not defined
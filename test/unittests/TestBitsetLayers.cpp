@@ -0,0 +1,144 @@
+#include "Utilities/Testing/interface/CppUnit_testdriver.icpp"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/src/emtf_hlslib.h"
+#include "L1Trigger/Phase2L1EMTF/test/benchmarks/SectorFixtures.h"
+
+using namespace emtf_hlslib::phase2;
+
+// Check the CPU implementations in zoning_bitset.h and pooling_bitset.h against the reference
+// zoning_layer and pooling_layer, which EMTFModel no longer calls on the CPU.
+
+class TestBitsetLayers : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TestBitsetLayers);
+  CPPUNIT_TEST(test_zoning);
+  CPPUNIT_TEST(test_pooling);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestBitsetLayers() {}
+  ~TestBitsetLayers() {}
+  void setUp();
+  void tearDown() {}
+
+  void test_zoning();
+  void test_pooling();
+
+private:
+  // Zoning inputs of one sector
+  struct Sector {
+    emtf_phi_t emtf_phi[model_config::n_in];
+    seg_zones_t seg_zones[model_config::n_in];
+    seg_tzones_t seg_tzones[model_config::n_in];
+    seg_valid_t seg_valid[model_config::n_in];
+  };
+
+  static const int kNumSectors = 500;  // per occupancy
+
+  std::vector<Sector> sectors_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(TestBitsetLayers);
+
+namespace {
+
+  std::string where(size_t isector, int zone, int index) {
+    std::ostringstream os;
+    os << "sector " << isector << " zone " << zone << " index " << index;
+    return os.str();
+  }
+
+}  // namespace
+
+void TestBitsetLayers::setUp() {
+  sectors_.clear();
+  unsigned seed = 1;
+
+  for (const auto& occupancy : emtf::phase2::fixtures::get_occupancies()) {
+    for (const auto& in0 : emtf::phase2::fixtures::make_sectors(occupancy, kNumSectors, seed++)) {
+      Sector sector;
+      for (unsigned iseg = 0; iseg < model_config::n_in; iseg++) {
+        const int* seg = &(in0[iseg * num_emtf_variables]);
+        sector.emtf_phi[iseg] = seg[0];
+        sector.seg_zones[iseg] = seg[7];
+        sector.seg_tzones[iseg] = seg[8];
+        sector.seg_valid[iseg] = seg[12];
+      }
+      sectors_.push_back(sector);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void TestBitsetLayers::test_zoning() {
+  long num_bits = 0;
+
+  for (size_t isector = 0; isector < sectors_.size(); ++isector) {
+    const Sector& s = sectors_[isector];
+
+    zoning_out_t zoning_out[num_emtf_zones][zoning_config::n_out];
+    zoning_bitset_row_t zoning_bits[num_emtf_zones][zoning_config::n_out];
+
+    zoning_layer<m_zone_any_tag>(
+        s.emtf_phi, s.seg_zones, s.seg_tzones, s.seg_valid, zoning_out[0], zoning_out[1], zoning_out[2]);
+    zoning_bitset_layer<m_zone_any_tag>(
+        s.emtf_phi, s.seg_zones, s.seg_tzones, s.seg_valid, zoning_bits[0], zoning_bits[1], zoning_bits[2]);
+
+    for (int zone = 0; zone < num_emtf_zones; zone++) {
+      for (int row = 0; row < static_cast<int>(zoning_config::n_out); row++) {
+        zoning_out_t image;
+        zoning_bitset_to_image_op(zoning_bits[zone][row], image);
+        CPPUNIT_ASSERT_MESSAGE(where(isector, zone, row), image == zoning_out[zone][row]);
+
+        for (unsigned col = 0; col < zoning_out_t::width; col++) {
+          num_bits += static_cast<bool>(image[col]);
+        }
+      }
+    }
+  }
+
+  // Make sure that the fixtures are not empty
+  CPPUNIT_ASSERT(num_bits > 0);
+}
+
+// _____________________________________________________________________________
+void TestBitsetLayers::test_pooling() {
+  long num_nonzero = 0;
+
+  for (size_t isector = 0; isector < sectors_.size(); ++isector) {
+    const Sector& s = sectors_[isector];
+
+    zoning_out_t zoning_out[num_emtf_zones][zoning_config::n_out];
+    zoning_bitset_row_t zoning_bits[num_emtf_zones][zoning_config::n_out];
+
+    zoning_layer<m_zone_any_tag>(
+        s.emtf_phi, s.seg_zones, s.seg_tzones, s.seg_valid, zoning_out[0], zoning_out[1], zoning_out[2]);
+    zoning_bitset_layer<m_zone_any_tag>(
+        s.emtf_phi, s.seg_zones, s.seg_tzones, s.seg_valid, zoning_bits[0], zoning_bits[1], zoning_bits[2]);
+
+    pooling_out_t pooling_out[num_emtf_zones][pooling_config::n_out];
+    pooling_out_t pooling_bits_out[num_emtf_zones][pooling_config::n_out];
+
+    pooling_layer<m_zone_0_tag>(zoning_out[0], pooling_out[0]);
+    pooling_layer<m_zone_1_tag>(zoning_out[1], pooling_out[1]);
+    pooling_layer<m_zone_2_tag>(zoning_out[2], pooling_out[2]);
+    pooling_bitset_layer<m_zone_0_tag>(zoning_bits[0], pooling_bits_out[0]);
+    pooling_bitset_layer<m_zone_1_tag>(zoning_bits[1], pooling_bits_out[1]);
+    pooling_bitset_layer<m_zone_2_tag>(zoning_bits[2], pooling_bits_out[2]);
+
+    for (int zone = 0; zone < num_emtf_zones; zone++) {
+      for (int col = 0; col < static_cast<int>(pooling_config::n_out); col++) {
+        CPPUNIT_ASSERT_MESSAGE(where(isector, zone, col), pooling_bits_out[zone][col] == pooling_out[zone][col]);
+        num_nonzero += (pooling_out[zone][col] != 0);
+      }
+    }
+  }
+
+  // Make sure that the fixtures are not empty
+  CPPUNIT_ASSERT(num_nonzero > 0);
+}
@@ -0,0 +1,136 @@
+#include "Utilities/Testing/interface/CppUnit_testdriver.icpp"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/interface/EMTFModel.h"
+#include "L1Trigger/Phase2L1EMTF/test/benchmarks/SectorFixtures.h"
+
+// Model-level check of the emtf_hlslib types. The reference outputs below were produced by the
+// standalone build with NATIVE=1 (native_ap_int.h, native_ap_fixed.h). This test is built with the
+// Xilinx types, so it fails if the two implementations give a different EMTFModel::fit output.
+//
+// The references must be updated when the model changes. The fixtures use std::mt19937 with the
+// libstdc++ distributions.
+
+class TestEMTFModelReference : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TestEMTFModelReference);
+  CPPUNIT_TEST(test_fixtures);
+  CPPUNIT_TEST(test_threads);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestEMTFModelReference() {}
+  ~TestEMTFModelReference() {}
+  void setUp() {}
+  void tearDown() {}
+
+  void test_fixtures();
+  void test_threads();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(TestEMTFModelReference);
+
+namespace {
+
+  constexpr int kNumSectors = 300;
+  constexpr unsigned kFirstSeed = 12345;
+
+  struct Reference {
+    std::string occupancy;
+    uint64_t hash;  // FNV-1a over the outputs of all the sectors
+    long num_nonzero;
+  };
+
+  const std::vector<Reference> references = {{"low", 0x79d9a47af89eefd6ull, 22257},
+                                             {"medium", 0x9dc479e8e4444923ull, 31786},
+                                             {"high", 0x9f5a8c13c28159b2ull, 36836}};
+
+  std::string to_hex(uint64_t x) {
+    char buf[20];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(x));
+    return buf;
+  }
+
+  // Run the model over the fixtures of one occupancy
+  void run_fixtures(const emtf::phase2::EMTFModel& model,
+                    const emtf::phase2::fixtures::Occupancy& occupancy,
+                    unsigned seed,
+                    uint64_t& hash,
+                    long& num_nonzero) {
+    const auto sectors = emtf::phase2::fixtures::make_sectors(occupancy, kNumSectors, seed);
+    std::vector<int> out(model.get_output_shape().num_elements(), 0);
+
+    hash = 1469598103934665603ull;
+    num_nonzero = 0;
+
+    for (const auto& in0 : sectors) {
+      model.fit(in0.data(), out.data());
+      for (int x : out) {
+        hash = (hash ^ static_cast<uint64_t>(static_cast<uint32_t>(x))) * 1099511628211ull;
+        num_nonzero += (x != 0);
+      }
+    }
+  }
+
+}  // namespace
+
+// _____________________________________________________________________________
+void TestEMTFModelReference::test_fixtures() {
+  using namespace emtf::phase2;
+
+  const EMTFModel model;
+
+  const auto& occupancies = fixtures::get_occupancies();
+  CPPUNIT_ASSERT_EQUAL(references.size(), occupancies.size());
+
+  for (size_t i = 0; i < occupancies.size(); ++i) {
+    CPPUNIT_ASSERT_EQUAL(references[i].occupancy, occupancies[i].name);
+
+    uint64_t hash = 0;
+    long num_nonzero = 0;
+    run_fixtures(model, occupancies[i], kFirstSeed + i, hash, num_nonzero);
+
+    CPPUNIT_ASSERT_EQUAL(references[i].num_nonzero, num_nonzero);
+    CPPUNIT_ASSERT_EQUAL(to_hex(references[i].hash), to_hex(hash));
+  }
+}
+
+// _____________________________________________________________________________
+// EMTFWorker can run the sectors in parallel (parallelSectors), so EMTFModel::fit() must give the
+// same output when it is called from several threads at once.
+void TestEMTFModelReference::test_threads() {
+  using namespace emtf::phase2;
+
+  const EMTFModel model;
+
+  const auto& occupancies = fixtures::get_occupancies();
+  CPPUNIT_ASSERT_EQUAL(references.size(), occupancies.size());
+
+  constexpr int num_copies = 2;  // threads per occupancy
+  const size_t num_threads = occupancies.size() * num_copies;
+
+  std::vector<uint64_t> hashes(num_threads, 0);
+  std::vector<long> nums_nonzero(num_threads, 0);
+  std::vector<std::thread> threads;
+
+  for (size_t j = 0; j < num_threads; ++j) {
+    const size_t i = j % occupancies.size();
+    threads.emplace_back(
+        [&, i, j]() { run_fixtures(model, occupancies[i], kFirstSeed + i, hashes[j], nums_nonzero[j]); });
+  }
+  for (auto&& t : threads) {
+    t.join();
+  }
+
+  for (size_t j = 0; j < num_threads; ++j) {
+    const size_t i = j % occupancies.size();
+    CPPUNIT_ASSERT_EQUAL(references[i].num_nonzero, nums_nonzero[j]);
+    CPPUNIT_ASSERT_EQUAL(to_hex(references[i].hash), to_hex(hashes[j]));
+  }
+}
@@ -0,0 +1,275 @@
+#include "Utilities/Testing/interface/CppUnit_testdriver.icpp"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+
+// Xilinx HLS
+#include "ap_int.h"
+#include "ap_fixed.h"
+
+// CPU implementation with native integers. EMTF_HLSLIB_NATIVE_TYPES is not defined, so the
+// native types stay in their own namespace and can be compared with the Xilinx types.
+#include "L1Trigger/Phase2L1EMTF/src/emtf_hlslib/native_ap_int.h"
+#include "L1Trigger/Phase2L1EMTF/src/emtf_hlslib/native_ap_fixed.h"
+
+namespace nat = emtf_hlslib::native;
+
+class TestNativeApTypes : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TestNativeApTypes);
+  CPPUNIT_TEST(test_arithmetic);
+  CPPUNIT_TEST(test_range);
+  CPPUNIT_TEST(test_concat);
+  CPPUNIT_TEST(test_wide);
+  CPPUNIT_TEST(test_fixed);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestNativeApTypes() : rng_(20210623) {}
+  ~TestNativeApTypes() {}
+  void setUp() {}
+  void tearDown() {}
+
+  void test_arithmetic();
+  void test_range();
+  void test_concat();
+  void test_wide();
+  void test_fixed();
+
+private:
+  static const int kNumTrials = 1000;
+
+  // Fill both values with the same random bits
+  template <typename T1, typename T2>
+  void randomize(T1& x, T2& y) {
+    const int w = x.length();
+    for (int lo = 0; lo < w; lo += 64) {
+      const int hi = std::min(lo + 63, w - 1);
+      const uint64_t word = rng_();
+      x.range(hi, lo) = word;
+      y.range(hi, lo) = word;
+    }
+  }
+
+  int random_index(int n) { return static_cast<int>(rng_() % n); }
+
+  template <int W1, bool S1, int W2, bool S2>
+  void check_arithmetic();
+
+  template <int W1, bool S1, int W2, bool S2>
+  void check_range();
+
+  template <int W1, int I1, int W2, int I2, int W3, int I3, ap_q_mode Q, ap_o_mode O>
+  void check_fixed();
+
+  std::mt19937_64 rng_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(TestNativeApTypes);
+
+namespace {
+
+  // Both implementations print in decimal
+  template <typename T>
+  std::string str(const T& x) {
+    std::ostringstream os;
+    os << x;
+    return os.str();
+  }
+
+}  // namespace
+
+// _____________________________________________________________________________
+template <int W1, bool S1, int W2, bool S2>
+void TestNativeApTypes::check_arithmetic() {
+  for (int i = 0; i < kNumTrials; ++i) {
+    ap_int_base<W1, S1> a;
+    nat::ap_int_base<W1, S1> na;
+    randomize(a, na);
+    ap_int_base<W2, S2> b;
+    nat::ap_int_base<W2, S2> nb;
+    randomize(b, nb);
+
+    // Result widths
+    CPPUNIT_ASSERT_EQUAL((a + b).length(), (na + nb).length());
+    CPPUNIT_ASSERT_EQUAL((a * b).length(), (na * nb).length());
+    CPPUNIT_ASSERT_EQUAL((a & b).length(), (na & nb).length());
+
+    CPPUNIT_ASSERT_EQUAL(str(a + b), str(na + nb));
+    CPPUNIT_ASSERT_EQUAL(str(a - b), str(na - nb));
+    CPPUNIT_ASSERT_EQUAL(str(a * b), str(na * nb));
+    CPPUNIT_ASSERT_EQUAL(str(a & b), str(na & nb));
+    CPPUNIT_ASSERT_EQUAL(str(a | b), str(na | nb));
+    CPPUNIT_ASSERT_EQUAL(str(a ^ b), str(na ^ nb));
+    CPPUNIT_ASSERT_EQUAL(str(~a), str(~na));
+    CPPUNIT_ASSERT_EQUAL(str(-a), str(-na));
+
+    // Mixed-sign comparisons follow the C-like rules of the Xilinx types
+    CPPUNIT_ASSERT_EQUAL(bool(a == b), bool(na == nb));
+    CPPUNIT_ASSERT_EQUAL(bool(a != b), bool(na != nb));
+    CPPUNIT_ASSERT_EQUAL(bool(a < b), bool(na < nb));
+    CPPUNIT_ASSERT_EQUAL(bool(a > b), bool(na > nb));
+    CPPUNIT_ASSERT_EQUAL(bool(a <= b), bool(na <= nb));
+    CPPUNIT_ASSERT_EQUAL(bool(a >= b), bool(na >= nb));
+
+    const int sh = random_index(W1 + 2);
+    CPPUNIT_ASSERT_EQUAL(str(a << sh), str(na << sh));
+    CPPUNIT_ASSERT_EQUAL(str(a >> sh), str(na >> sh));
+
+    // Assignment truncates
+    ap_int_base<W1, S1> c = b;
+    nat::ap_int_base<W1, S1> nc = nb;
+    CPPUNIT_ASSERT_EQUAL(str(c), str(nc));
+    c += a;
+    nc += na;
+    CPPUNIT_ASSERT_EQUAL(str(c), str(nc));
+  }
+}
+
+void TestNativeApTypes::test_arithmetic() {
+  check_arithmetic<13, false, 13, false>();
+  check_arithmetic<7, true, 12, false>();
+  check_arithmetic<12, false, 7, true>();
+  check_arithmetic<8, true, 8, false>();
+  check_arithmetic<12, false, 32, true>();
+  check_arithmetic<32, false, 32, true>();
+  check_arithmetic<63, true, 64, false>();
+  check_arithmetic<1, false, 9, false>();
+}
+
+// _____________________________________________________________________________
+template <int W1, bool S1, int W2, bool S2>
+void TestNativeApTypes::check_range() {
+  for (int i = 0; i < kNumTrials; ++i) {
+    ap_int_base<W1, S1> a;
+    nat::ap_int_base<W1, S1> na;
+    randomize(a, na);
+    ap_int_base<W2, S2> b;
+    nat::ap_int_base<W2, S2> nb;
+    randomize(b, nb);
+
+    // The range is reversed if hi < lo
+    const int hi = random_index(W1);
+    const int lo = random_index(W1);
+    CPPUNIT_ASSERT_EQUAL(str(a.range(hi, lo).get()), str(na.range(hi, lo).get()));
+
+    a.range(hi, lo) = b;
+    na.range(hi, lo) = nb;
+    CPPUNIT_ASSERT_EQUAL(str(a), str(na));
+
+    const int bit = random_index(W1);
+    CPPUNIT_ASSERT_EQUAL(bool(a[bit]), bool(na[bit]));
+    a[bit] = !a[bit];
+    na[bit] = !na[bit];
+    CPPUNIT_ASSERT_EQUAL(str(a), str(na));
+  }
+}
+
+void TestNativeApTypes::test_range() {
+  check_range<12, false, 7, true>();
+  check_range<13, true, 13, false>();
+  check_range<64, false, 20, false>();
+  check_range<100, true, 30, false>();
+}
+
+// _____________________________________________________________________________
+void TestNativeApTypes::test_concat() {
+  for (int i = 0; i < kNumTrials; ++i) {
+    ap_uint<13> a;
+    nat::ap_uint<13> na;
+    randomize(a, na);
+    ap_int<8> b;
+    nat::ap_int<8> nb;
+    randomize(b, nb);
+    ap_uint<90> c;
+    nat::ap_uint<90> nc;
+    randomize(c, nc);
+
+    CPPUNIT_ASSERT_EQUAL(str((a, b)), str((na, nb)));
+    CPPUNIT_ASSERT_EQUAL(str((c, a, b)), str((nc, na, nb)));
+
+    // The length of a concatenation with a range is only known at runtime
+    const int lo = random_index(8);
+    const int hi = lo + random_index(8 - lo);
+    ap_uint<21> d = (a, b.range(hi, lo));
+    nat::ap_uint<21> nd = (na, nb.range(hi, lo));
+    CPPUNIT_ASSERT_EQUAL(str(d), str(nd));
+  }
+}
+
+// _____________________________________________________________________________
+void TestNativeApTypes::test_wide() {
+  // Same width as the zoning images
+  for (int i = 0; i < kNumTrials; ++i) {
+    ap_uint<288> a, b;
+    nat::ap_uint<288> na, nb;
+    randomize(a, na);
+    randomize(b, nb);
+
+    CPPUNIT_ASSERT_EQUAL(str(a & b), str(na & nb));
+    CPPUNIT_ASSERT_EQUAL(str(a | b), str(na | nb));
+    CPPUNIT_ASSERT_EQUAL(str(a ^ b), str(na ^ nb));
+    CPPUNIT_ASSERT_EQUAL(bool(a == b), bool(na == nb));
+    CPPUNIT_ASSERT_EQUAL(bool(a < b), bool(na < nb));
+
+    const int sh = random_index(290);
+    CPPUNIT_ASSERT_EQUAL(str(a << sh), str(na << sh));
+    CPPUNIT_ASSERT_EQUAL(str(a >> sh), str(na >> sh));
+
+    const int lo = random_index(288);
+    const int hi = lo + random_index(std::min(64, 288 - lo));
+    CPPUNIT_ASSERT_EQUAL(str(a.range(hi, lo).get()), str(na.range(hi, lo).get()));
+    a.range(hi, lo) = b.range(hi - lo, 0);
+    na.range(hi, lo) = nb.range(hi - lo, 0);
+    CPPUNIT_ASSERT_EQUAL(str(a), str(na));
+  }
+}
+
+// _____________________________________________________________________________
+template <int W1, int I1, int W2, int I2, int W3, int I3, ap_q_mode Q, ap_o_mode O>
+void TestNativeApTypes::check_fixed() {
+  for (int i = 0; i < kNumTrials; ++i) {
+    ap_fixed<W1, I1> a;
+    nat::ap_fixed<W1, I1> na;
+    randomize(a, na);
+    ap_fixed<W2, I2> b;
+    nat::ap_fixed<W2, I2> nb;
+    randomize(b, nb);
+
+    ap_fixed<W3, I3, Q, O> c = a * b;
+    nat::ap_fixed<W3, I3, static_cast<nat::ap_q_mode>(Q), static_cast<nat::ap_o_mode>(O)> nc = na * nb;
+    CPPUNIT_ASSERT_EQUAL(c.range().to_uint64(), nc.range().to_uint64());
+
+    c += a;
+    nc += na;
+    CPPUNIT_ASSERT_EQUAL(c.range().to_uint64(), nc.range().to_uint64());
+
+    c = a - b;
+    nc = na - nb;
+    CPPUNIT_ASSERT_EQUAL(c.range().to_uint64(), nc.range().to_uint64());
+    CPPUNIT_ASSERT_EQUAL(bool(a < b), bool(na < nb));
+
+    // Conversion from float, with the quantization and overflow modes of the target
+    const double x = std::ldexp(static_cast<double>(random_index(2000001)) - 1000000., -random_index(20));
+    c = x;
+    nc = x;
+    CPPUNIT_ASSERT_EQUAL(c.range().to_uint64(), nc.range().to_uint64());
+    CPPUNIT_ASSERT_EQUAL(c.to_double(), nc.to_double());
+  }
+}
+
+void TestNativeApTypes::test_fixed() {
+  check_fixed<14, 1, 14, 4, 24, 5, AP_TRN, AP_WRAP>();
+  check_fixed<12, 3, 10, 4, 20, 10, AP_RND, AP_SAT>();
+  check_fixed<11, 1, 14, 7, 14, 1, AP_RND, AP_SAT>();
+  check_fixed<10, 4, 12, 3, 9, 2, AP_RND_CONV, AP_SAT_ZERO>();
+  check_fixed<10, 4, 12, 3, 9, 2, AP_RND_ZERO, AP_WRAP>();
+  check_fixed<10, 4, 12, 3, 9, 2, AP_RND_INF, AP_SAT>();
+  check_fixed<10, 4, 12, 3, 9, 2, AP_RND_MIN_INF, AP_SAT>();
+  check_fixed<10, 4, 12, 3, 9, 2, AP_TRN_ZERO, AP_WRAP>();
+}
@@ -0,0 +1,61 @@
+#include "Utilities/Testing/interface/CppUnit_testdriver.icpp"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "Geometry/CSCGeometry/interface/CSCGeometry.h"
+
+#include "L1Trigger/Phase2L1EMTF/interface/ChamberIndex.h"
+#include "L1Trigger/Phase2L1EMTF/interface/SegmentFormatter.h"
+#include "L1Trigger/Phase2L1EMTF/interface/Toolbox.h"
+
+using namespace emtf::phase2;
+
+class TestSegmentFormatter : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TestSegmentFormatter);
+  CPPUNIT_TEST(test_invalid_csc);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestSegmentFormatter() {}
+  ~TestSegmentFormatter() {}
+  void setUp() {}
+  void tearDown() {}
+
+  void test_invalid_csc();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(TestSegmentFormatter);
+
+// An invalid LCT in the sector must be rejected without adding an entry to the coordinate batch,
+// otherwise the batch and the formatted hits are no longer in the same order.
+void TestSegmentFormatter::test_invalid_csc() {
+  const CSCGeometry detgeom;  // not used for a rejected LCT
+  const SegmentFormatter formatter;
+
+  // ME2/2 chamber 4 of endcap 1, sector 1
+  const int endcap = 1;
+  const int station = 2;
+  const int ring = 2;
+  const int chamber = 4;
+  const CSCDetId detid(endcap, station, ring, chamber, 0);
+  const int sector = detid.triggerSector();
+  const int cscid = toolbox::get_trigger_cscid(ring, station, chamber);
+  const int bx = 0;
+
+  // valid = 0, at the central BX
+  const CSCCorrelatedLCTDigi digi(1, 0, 15, 20, 40, 10, 0, CSCConstants::LCT_CENTRAL_BX, 0, 0, 0, cscid);
+  CPPUNIT_ASSERT(not digi.isValid());
+
+  const ChamberIndex::wire_t wire_ambi[1] = {20};
+  SegmentFormatter::ChamberInfo chminfo;
+  chminfo.wire_ambi = SegmentFormatter::ChamberInfo::wire_ambi_t(wire_ambi, wire_ambi + 1);
+
+  SegmentFormatter::CoordinateBatch batch;
+  EMTFHit hit;
+
+  const int strategy = formatter.format(endcap, sector, bx, detgeom, detid, digi, chminfo, batch, hit);
+
+  CPPUNIT_ASSERT(strategy < 0);
+  CPPUNIT_ASSERT(not hit.valid());
+  CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(0), batch.size());
+}
@@ -0,0 +1,160 @@
+#include "Utilities/Testing/interface/CppUnit_testdriver.icpp"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "L1Trigger/Phase2L1EMTF/interface/Toolbox.h"
+
+namespace toolbox = emtf::phase2::toolbox;
+
+// The batch versions of rad_to_deg(), calc_theta_int() and calc_phi_int() must be bit-exact with
+// the scalar versions, whichever instruction set Toolbox.cc was compiled for.
+
+class TestToolboxBatch : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(TestToolboxBatch);
+  CPPUNIT_TEST(test_rad_to_deg);
+  CPPUNIT_TEST(test_theta_int);
+  CPPUNIT_TEST(test_phi_int);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  TestToolboxBatch() : rng_(20211001) {}
+  ~TestToolboxBatch() {}
+  void setUp() {}
+  void tearDown() {}
+
+  void test_rad_to_deg();
+  void test_theta_int();
+  void test_phi_int();
+
+private:
+  static const int kNumRandom = 100000;
+
+  float uniform(float lo, float hi) { return std::uniform_real_distribution<float>(lo, hi)(rng_); }
+
+  std::mt19937 rng_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(TestToolboxBatch);
+
+namespace {
+
+  // Add x and its float neighbours
+  void add_with_neighbours(std::vector<float>& v, float x) {
+    float lo = x;
+    float hi = x;
+    v.push_back(x);
+    for (int i = 0; i < 3; ++i) {
+      lo = std::nextafter(lo, -INFINITY);
+      hi = std::nextafter(hi, INFINITY);
+      v.push_back(lo);
+      v.push_back(hi);
+    }
+  }
+
+  uint32_t to_bits(float x) {
+    uint32_t b;
+    std::memcpy(&b, &x, sizeof(b));
+    return b;
+  }
+
+  // Every size up to a few vector widths, at every offset, so that both the vector loop and the
+  // scalar tail are covered, with unaligned pointers
+  template <typename F>
+  void for_each_slice(size_t total, F f) {
+    for (size_t offset = 0; offset < 4; ++offset) {
+      for (size_t n = 0; n <= 13 && (offset + n) <= total; ++n) {
+        f(offset, n);
+      }
+    }
+    f(0, total);
+  }
+
+}  // namespace
+
+// _____________________________________________________________________________
+void TestToolboxBatch::test_rad_to_deg() {
+  std::vector<float> rad;
+  for (float x : {0.f, -0.f, float(M_PI), -float(M_PI), float(M_PI / 2), 1e-30f, -1e-30f, 1e30f, -1e30f}) {
+    add_with_neighbours(rad, x);
+  }
+  for (int i = 0; i < kNumRandom; ++i) {
+    rad.push_back(uniform(-2 * M_PI, 2 * M_PI));
+  }
+
+  std::vector<float> deg(rad.size());
+
+  for_each_slice(rad.size(), [&](size_t offset, size_t n) {
+    toolbox::rad_to_deg(rad.data() + offset, deg.data() + offset, n);
+    for (size_t i = offset; i < (offset + n); ++i) {
+      CPPUNIT_ASSERT_EQUAL(to_bits(toolbox::rad_to_deg(rad[i])), to_bits(deg[i]));
+    }
+  });
+}
+
+// _____________________________________________________________________________
+void TestToolboxBatch::test_theta_int() {
+  std::vector<float> theta;
+
+  // Ties of the rounding, in both endcaps
+  for (int k = -10; k < 140; ++k) {
+    const double x = 8.5 + ((k + 0.5) * (45.0 - 8.5) / 128.);
+    add_with_neighbours(theta, x);
+    add_with_neighbours(theta, 180. - x);
+  }
+  // Edges of the range, and below 8.5 deg where the result is protected
+  for (float x : {0.f, 8.5f, 180.f, 171.5f}) {
+    add_with_neighbours(theta, x);
+  }
+  for (int i = 0; i < kNumRandom; ++i) {
+    theta.push_back(uniform(0., 180.));
+  }
+
+  std::vector<int> theta_int(theta.size());
+
+  for (int endcap : {-1, +1}) {
+    for_each_slice(theta.size(), [&](size_t offset, size_t n) {
+      toolbox::calc_theta_int(theta.data() + offset, endcap, theta_int.data() + offset, n);
+      for (size_t i = offset; i < (offset + n); ++i) {
+        CPPUNIT_ASSERT_EQUAL(toolbox::calc_theta_int(theta[i], endcap), theta_int[i]);
+      }
+    });
+  }
+}
+
+// _____________________________________________________________________________
+void TestToolboxBatch::test_phi_int() {
+  for (int sector = 1; sector <= 6; ++sector) {
+    std::vector<float> glob;
+
+    // Ties of the rounding over the sector, including the part beyond the wrap at +/-180 deg
+    for (int k = -10; k < (80 * 60); k += 7) {
+      const double x = ((k + 0.5) / 60.) - 22. + 15. + (60. * (sector - 1));
+      add_with_neighbours(glob, toolbox::wrap_phi_deg(x));
+    }
+    // Wrap at +/-180 deg, and ties of the wrap itself
+    for (float x : {180.f, -180.f, 179.99f, -179.99f, 540.f, -540.f, 0.f}) {
+      add_with_neighbours(glob, x);
+    }
+    for (int i = 0; i < kNumRandom; ++i) {
+      glob.push_back(uniform(-180., 180.));
+    }
+    for (int i = 0; i < 1000; ++i) {
+      glob.push_back(uniform(-720., 720.));
+    }
+
+    std::vector<int> phi_int(glob.size());
+
+    for_each_slice(glob.size(), [&](size_t offset, size_t n) {
+      toolbox::calc_phi_int(glob.data() + offset, sector, phi_int.data() + offset, n);
+      for (size_t i = offset; i < (offset + n); ++i) {
+        CPPUNIT_ASSERT_EQUAL(toolbox::calc_phi_int(glob[i], sector), phi_int[i]);
+      }
+    });
+  }
+}